@@ -40,10 +40,12 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 #include <limits>
 #include <list>
+#include <queue>
 #include <sstream>
 
 namespace amrex {
@@ -81,6 +83,7 @@ namespace
     bool plot_files_output;
     int  checkpoint_nfiles;
     int  regrid_on_restart;
+    int  redistribute_on_restart;
     int  use_efficient_regrid;
     int  plotfile_on_restart;
     int  insitu_on_restart;
@@ -92,6 +95,75 @@ namespace
     VisMF::Header::Version checkpoint_headerversion(VisMF::Header::Version_v1);
 }
 
+namespace
+{
+    // The lowest rank on this node.  Collective the first time.
+    int nodeLeaderRank ()
+    {
+        static int leader = -1;
+        if (leader < 0) {
+#ifdef BL_USE_MPI
+            MPI_Comm node_comm;
+            MPI_Comm_split_type(ParallelDescriptor::Communicator(), MPI_COMM_TYPE_SHARED,
+                                ParallelDescriptor::MyProc(), MPI_INFO_NULL, &node_comm);
+            leader = ParallelDescriptor::MyProc();
+            MPI_Bcast(&leader, 1, MPI_INT, 0, node_comm);
+            MPI_Comm_free(&node_comm);
+#else
+            leader = 0;
+#endif
+        }
+        return leader;
+    }
+
+    bool isNodeLeader ()
+    {
+        return nodeLeaderRank() == ParallelDescriptor::MyProc();
+    }
+
+    //
+    // Copy the files under src into dst, write "crc32 size path" for each
+    // to manifest and remove src.  Runs on the drain thread, so it must not
+    // communicate or abort.
+    //
+    bool drainDirectory (std::string const& src, std::string const& dst,
+                         std::string const& manifest)
+    {
+        std::ofstream mf(manifest, std::ios::out | std::ios::trunc);
+        if ( ! mf.good()) { return false; }
+
+        Vector<char> buf(8*1024*1024);
+        for (auto const& rel : FileSystem::ListFiles(src))
+        {
+            const std::string to = dst + "/" + rel;
+            if ( ! amrex::UtilCreateDirectory(to.substr(0, to.rfind('/')), 0755)) {
+                return false;
+            }
+            std::ifstream ifs(src + "/" + rel, std::ios::in | std::ios::binary);
+            std::ofstream ofs(to, std::ios::out | std::ios::trunc | std::ios::binary);
+            if ( ! ifs.good() || ! ofs.good()) { return false; }
+
+            std::uint32_t crc = 0;
+            Long nbytes = 0;
+            while (ifs) {
+                ifs.read(buf.data(), buf.size());
+                const auto n = ifs.gcount();
+                if (n <= 0) { break; }
+                crc = amrex::CRC32(buf.data(), n, crc);
+                ofs.write(buf.data(), n);
+                nbytes += n;
+            }
+            ofs.close();
+            if (ifs.bad() || ofs.fail()) { return false; }
+
+            mf << std::hex << std::setw(8) << std::setfill('0') << crc << std::dec
+               << ' ' << nbytes << ' ' << rel << '\n';
+        }
+        mf.close();
+        return ! mf.fail() && FileSystem::RemoveAll(src);
+    }
+}
+
 
 
 bool
@@ -117,6 +189,7 @@ Amr::Initialize ()
     plot_files_output        = true;
     checkpoint_nfiles        = 64;
     regrid_on_restart        = 0;
+    redistribute_on_restart  = 0;
     use_efficient_regrid     = 0;
     plotfile_on_restart      = 0;
     insitu_on_restart        = 0;
@@ -243,6 +316,8 @@ Amr::InitAmr ()
     record_grid_info       = false;
     file_name_digits       = 5;
     record_run_info_terse  = false;
+    record_perf_info       = false;
+    perf_log_format        = "json";
     bUserStopRequest       = false;
     message_int            = 10;
 #if defined(AMREX_USE_SENSEI_INSITU) && !defined(AMREX_NO_SENSEI_AMR_INST)
@@ -257,6 +332,7 @@ Amr::InitAmr ()
     // Check for command line flags.
     //
     pp.queryAdd("regrid_on_restart",regrid_on_restart);
+    pp.queryAdd("redistribute_on_restart",redistribute_on_restart);
     pp.queryAdd("use_efficient_regrid",use_efficient_regrid);
     pp.queryAdd("plotfile_on_restart",plotfile_on_restart);
     pp.queryAdd("insitu_on_restart",insitu_on_restart);
@@ -296,6 +372,27 @@ Amr::InitAmr ()
         pp.get("grid_log",grid_file_name);
         setRecordGridInfo(grid_file_name);
     }
+    pp.queryAdd("perf_log_format",perf_log_format);
+    if (perf_log_format != "json" && perf_log_format != "csv") {
+        amrex::Abort("Amr: amr.perf_log_format must be json or csv");
+    }
+    {
+        // amr.perf_log names the log and turns it on, unless
+        // amr.record_perf_info says otherwise.
+        std::string perf_file_name = "perf_log";
+        record_perf_info = pp.query("perf_log",perf_file_name);
+        pp.query("record_perf_info",record_perf_info);
+        if (record_perf_info) {
+            setRecordPerfInfo(perf_file_name);
+        }
+    }
+
+    if (pp.contains("regrid_log"))
+    {
+        std::string regrid_file_name;
+        pp.get("regrid_log",regrid_file_name);
+        setRecordRegridInfo(regrid_file_name);
+    }
 
     if (pp.contains("data_log"))
     {
@@ -328,6 +425,10 @@ Amr::InitAmr ()
     dt_level.resize(nlev);
     level_steps.resize(nlev);
     level_count.resize(nlev);
+    perf_info.resize(nlev);
+    regrid_cells_reused.resize(nlev, 0);
+    regrid_cells_filled.resize(nlev, 0);
+    regrid_control.resize(nlev);
     n_cycle.resize(nlev);
     dt_min.resize(nlev);
     amr_level.resize(nlev);
@@ -499,6 +600,25 @@ Amr::InitAmr ()
 
     loadbalance_max_fac = 1.5;
     pp.queryAdd("loadbalance_max_fac", loadbalance_max_fac);
+
+    incremental_regrid = 0;
+    pp.queryAdd("incremental_regrid", incremental_regrid);
+    incremental_regrid_max_imbalance = 1.5;
+    pp.queryAdd("incremental_regrid_max_imbalance", incremental_regrid_max_imbalance);
+
+    adaptive_regrid = 0;
+    pp.queryAdd("adaptive_regrid", adaptive_regrid);
+
+    adaptive_regrid_drift_tol = 0.0;
+    pp.queryAdd("adaptive_regrid_drift_tol", adaptive_regrid_drift_tol);
+
+    adaptive_regrid_max_skip = 8;
+    pp.queryAdd("adaptive_regrid_max_skip", adaptive_regrid_max_skip);
+
+    adaptive_regrid_tag_int = 1;
+    pp.queryAdd("adaptive_regrid_tag_int", adaptive_regrid_tag_int);
+
+    rebalance_cost_per_cell = -1.0;
 }
 
 int
@@ -740,6 +860,20 @@ Amr::deleteDeriveSmallPlotVar (const std::string& name)
 
 Amr::~Amr ()
 {
+    //
+    // No communication here: a checkpoint still being drained is left
+    // under its temporary name.  This only happens if the run ended before
+    // max_step and stop_time without okToContinue() turning false.
+    //
+    if (drain_thread) {
+        drain_thread->Finish();
+    }
+    if ( ! drain_ckfile.empty()) {
+        amrex::Print(std::cerr)
+            << "Amr::~Amr(): checkpoint " << drain_ckfile << " was not completed, its files are in "
+            << drain_ckfile << ".temp.  Call Amr::finishCheckpointDrain() before destroying Amr.\n";
+    }
+
     levelbld->variableCleanUp();
 
     Amr::Finalize();
@@ -785,6 +919,144 @@ Amr::setRecordRunInfoTerse (const std::string& filename)
     ParallelDescriptor::Barrier("Amr::setRecordRunInfoTerse");
 }
 
+void
+Amr::setRecordPerfInfo (const std::string& filename)
+{
+    record_perf_info = true;
+    if (ParallelDescriptor::IOProcessor())
+    {
+        perflog.open(filename.c_str(),std::ios::out|std::ios::app);
+        if (!perflog.good()) {
+            amrex::FileOpenFailed(filename);
+        }
+        if (perf_log_format == "csv" && perflog.tellp() == 0) {
+            perflog << "step,time,dt,step_time,cell_updates_per_sec,level,ncells,ngrids,"
+                    << "nadvance,advance_time,regrid_time,fillpatch_time,post_step_time,"
+                    << "fab_bytes,comm_bytes,load_balance_eff\n";
+        }
+    }
+    ParallelDescriptor::Barrier("Amr::setRecordPerfInfo");
+}
+
+void
+Amr::setRecordRegridInfo (const std::string& filename)
+{
+    if (ParallelDescriptor::IOProcessor())
+    {
+        regridlog.open(filename.c_str(),std::ios::out|std::ios::app);
+        if (!regridlog.good()) {
+            amrex::FileOpenFailed(filename);
+        }
+    }
+    ParallelDescriptor::Barrier("Amr::setRecordRegridInfo");
+}
+
+void
+Amr::addFillPatchTime (int lev, Real t) noexcept
+{
+    if (record_perf_info) {
+        perf_info[lev].fillpatch_time += t;
+    }
+}
+
+void
+Amr::addRegridCells (int lev, Long nreused, Long nfilled) noexcept
+{
+    regrid_cells_reused[lev] += nreused;
+    regrid_cells_filled[lev] += nfilled;
+}
+
+void
+Amr::writePerfInfo (Real step_time)
+{
+    BL_PROFILE("Amr::writePerfInfo()");
+
+    const int nlevs = finest_level+1;
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    // Timers are reported as the max over ranks.  The sum of the advance
+    // times gives the load balance efficiency, i.e., average over max.
+    Vector<Real> rmax(5*nlevs+1);
+    Vector<Real> rsum(nlevs);
+    Vector<Long> lsum(2*nlevs);
+    for (int lev = 0; lev < nlevs; ++lev) {
+        const PerfInfo& pi = perf_info[lev];
+        rmax[5*lev  ] = pi.advance_time;
+        rmax[5*lev+1] = pi.regrid_time;
+        rmax[5*lev+2] = pi.fillpatch_time;
+        rmax[5*lev+3] = pi.post_step_time;
+        rmax[5*lev+4] = static_cast<Real>(pi.nadvance);
+        rsum[lev] = pi.advance_time;
+        lsum[2*lev  ] = FabArrayBase::queryMemUsage("AmrLevel_Level_" + std::to_string(lev));
+        lsum[2*lev+1] = pi.comm_bytes;
+    }
+    rmax[5*nlevs] = step_time;
+
+    ParallelDescriptor::ReduceRealMax(rmax.data(), rmax.size(), IOProc);
+    ParallelDescriptor::ReduceRealSum(rsum.data(), rsum.size(), IOProc);
+    ParallelDescriptor::ReduceLongSum(lsum.data(), lsum.size(), IOProc);
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        const Real nprocs = static_cast<Real>(ParallelDescriptor::NProcs());
+        const Real tstep = rmax[5*nlevs];
+
+        Vector<Long> ncells(nlevs);
+        Real cell_updates = 0.0;
+        for (int lev = 0; lev < nlevs; ++lev) {
+            ncells[lev] = cellCount(lev);
+            cell_updates += static_cast<Real>(ncells[lev]) * rmax[5*lev+4];
+        }
+        const Real updates_per_sec = (tstep > 0.0) ? cell_updates/tstep : 0.0;
+
+        auto lb_eff = [&] (int lev) -> Real {
+            const Real tmax = rmax[5*lev];
+            return (tmax > 0.0) ? (rsum[lev]/nprocs)/tmax : 1.0;
+        };
+
+        const auto old_prec = perflog.precision(8);
+        if (perf_log_format == "csv")
+        {
+            for (int lev = 0; lev < nlevs; ++lev) {
+                perflog << level_steps[0] << "," << cumtime << "," << dt_level[0] << ","
+                        << tstep << "," << updates_per_sec << "," << lev << ","
+                        << ncells[lev] << "," << numGrids(lev) << ","
+                        << static_cast<int>(rmax[5*lev+4]) << ","
+                        << rmax[5*lev] << "," << rmax[5*lev+1] << ","
+                        << rmax[5*lev+2] << "," << rmax[5*lev+3] << ","
+                        << lsum[2*lev] << "," << lsum[2*lev+1] << ","
+                        << lb_eff(lev) << "\n";
+            }
+        }
+        else
+        {
+            perflog << "{\"step\":" << level_steps[0]
+                    << ",\"time\":" << cumtime
+                    << ",\"dt\":" << dt_level[0]
+                    << ",\"step_time\":" << tstep
+                    << ",\"cell_updates_per_sec\":" << updates_per_sec
+                    << ",\"levels\":[";
+            for (int lev = 0; lev < nlevs; ++lev) {
+                if (lev > 0) perflog << ",";
+                perflog << "{\"level\":" << lev
+                        << ",\"ncells\":" << ncells[lev]
+                        << ",\"ngrids\":" << numGrids(lev)
+                        << ",\"nadvance\":" << static_cast<int>(rmax[5*lev+4])
+                        << ",\"advance_time\":" << rmax[5*lev]
+                        << ",\"regrid_time\":" << rmax[5*lev+1]
+                        << ",\"fillpatch_time\":" << rmax[5*lev+2]
+                        << ",\"post_step_time\":" << rmax[5*lev+3]
+                        << ",\"fab_bytes\":" << lsum[2*lev]
+                        << ",\"comm_bytes\":" << lsum[2*lev+1]
+                        << ",\"load_balance_eff\":" << lb_eff(lev) << "}";
+            }
+            perflog << "]}\n";
+        }
+        perflog.precision(old_prec);
+        perflog.flush();
+    }
+}
+
 void
 Amr::setRecordDataInfo (int i, const std::string& filename)
 {
@@ -841,6 +1113,14 @@ Amr::numGrids () noexcept
     return cnt;
 }
 
+bool
+Amr::isLastCoarseStep () noexcept
+{
+    return ! okToContinue()
+        || (run_max_step >= 0 && level_steps[0] >= run_max_step)
+        || (run_stop_time >= 0.0 && cumtime >= run_stop_time);
+}
+
 int
 Amr::okToContinue () noexcept
 {
@@ -1447,6 +1727,9 @@ Amr::restart (const std::string& filename)
       }
     }
 
+    // ---- read the state in large pieces and copy it to the new layout
+    StateData::SetRedistributeOnRestart(redistribute_on_restart);
+
     //
     // Open the checkpoint header file for reading.
     //
@@ -1697,6 +1980,7 @@ Amr::restart (const std::string& filename)
 
         amrex::Print() << "Restart time = " << dRestartTime << " seconds." << '\n';
     }
+    StateData::SetRedistributeOnRestart(false);
     BL_PROFILE_REGION_STOP("Amr::restart()");
 }
 
@@ -1710,7 +1994,16 @@ Amr::checkPoint ()
     BL_PROFILE_REGION_START("Amr::checkPoint()");
     BL_PROFILE("Amr::checkPoint()");
 
-    VisMF::SetNOutFiles(checkpoint_nfiles);
+    //
+    // With a stage directory every rank writes its own file on its node,
+    // which the node's lowest rank then copies out in the background.
+    //
+    const bool staged = ! checkpoint_stage_dir.empty() && ! AsyncOut::UseAsyncOut();
+
+    // Only one checkpoint is drained at a time.
+    finishCheckpointDrain(true);
+
+    VisMF::SetNOutFiles(staged ? ParallelDescriptor::NProcs() : checkpoint_nfiles);
     //
     // In checkpoint files always write out FABs in NATIVE format.
     //
@@ -1737,7 +2030,10 @@ Amr::checkPoint ()
                              stream_max_tries);
 
   // For AsyncOut, we need to turn off stream retry and write to ckfile directly.
-  const std::string ckfileTemp = (AsyncOut::UseAsyncOut()) ? ckfile : (ckfile + ".temp");
+  const std::string ckfileTemp = (AsyncOut::UseAsyncOut()) ? ckfile
+      : (staged ? checkpoint_stage_dir + "/" + VisMF::BaseName(ckfile)
+                  + ".node" + std::to_string(nodeLeaderRank())
+                : ckfile + ".temp");
 
   while(sretry.TryFileOutput()) {
 
@@ -1751,7 +2047,27 @@ Amr::checkPoint ()
     //  it to a bad suffix if there were stream errors.
     //
 
-    if (precreateDirectories) {    // ---- make all directories at once
+    if (staged) {
+      amrex::UtilRenameDirectoryToOld(ckfile, false);             // dont call barrier
+      amrex::UtilCreateCleanDirectory(ckfile + ".temp", false);   // dont call barrier
+      if (isNodeLeader()) {
+        FileSystem::RemoveAll(ckfileTemp);
+        for (int i(0); i <= finest_level; ++i)
+        {
+          std::string LevelDir, FullPath;
+          amr_level[i]->LevelDirectoryNames(ckfileTemp, LevelDir, FullPath);
+          if ( ! amrex::UtilCreateDirectory(FullPath, 0755)) {
+            amrex::CreateDirectoryFailed(FullPath);
+          }
+        }
+      }
+      ParallelDescriptor::Barrier("Amr::checkPoint::stage");
+      for (int i(0); i <= finest_level; ++i)
+      {
+        amr_level[i]->CreateLevelDirectory(ckfileTemp);
+      }
+      ParallelDescriptor::Barrier("Amr::precreateDirectories");
+    } else if (precreateDirectories) {    // ---- make all directories at once
       amrex::UtilRenameDirectoryToOld(ckfile, false);      // dont call barrier
       amrex::UtilCreateCleanDirectory(ckfileTemp, false);  // dont call barrier
       for (int i(0); i <= finest_level; ++i)
@@ -1863,6 +2179,32 @@ Amr::checkPoint ()
 
     if (AsyncOut::UseAsyncOut()) {
         break;
+    } else if (staged) {
+        if(ParallelDescriptor::IOProcessor()) {
+            HeaderFile.close();
+        }
+        ParallelDescriptor::Barrier("Amr::checkPoint::end");
+        drain_ckfile = ckfile;
+        if (isNodeLeader()) {
+            if ( ! drain_thread) {
+                drain_thread = std::make_unique<BackgroundThread>();
+            }
+            drain_status = std::make_shared<std::atomic<int> >(0);
+            const std::string target = ckfile + ".temp";
+            const std::string manifest = target + "/Checksums_"
+                + std::to_string(ParallelDescriptor::MyProc());
+            drain_thread->Submit([=, status=drain_status] () {
+                status->store(drainDirectory(ckfileTemp, target, manifest) ? 1 : -1);
+            });
+        } else {
+            drain_status = std::make_shared<std::atomic<int> >(1);
+        }
+        // The checkpoint written at the end of a run is completed here,
+        // while every rank is still here to do it.
+        if (isLastCoarseStep()) {
+            finishCheckpointDrain(true);
+        }
+        break;
     } else {
         ParallelDescriptor::Barrier("Amr::checkPoint::end");
         if(ParallelDescriptor::IOProcessor()) {
@@ -1947,10 +2289,35 @@ Amr::timeStep (int  level,
         {
             const int old_finest = finest_level;
 
-            if (okToRegrid(i))
+            bool do_regrid = okToRegrid(i);
+            if (do_regrid && adaptive_regrid && ! adaptiveRegridCheck(i,time))
+            {
+                //
+                // Skipped or rebalanced instead; check again after regrid_int steps.
+                //
+                level_count[i] = 0;
+                do_regrid = false;
+            }
+
+            if (do_regrid)
             {
+                const Real regrid_strt = amrex::second();
+                const Long regrid_bytes = FabArrayBase::m_FA_stats.num_send_bytes;
+
                 regrid(i,time);
 
+                if (record_perf_info) {
+                    perf_info[i].regrid_time += amrex::second() - regrid_strt;
+                    perf_info[i].comm_bytes += FabArrayBase::m_FA_stats.num_send_bytes - regrid_bytes;
+                }
+
+                if (adaptive_regrid) {
+                    Real regrid_time = amrex::second() - regrid_strt;
+                    ParallelDescriptor::ReduceRealMax(regrid_time);
+                    regrid_control[i].regrid_cost = regrid_time;
+                    regrid_control[i].last_cost = regrid_time;
+                }
+
                 //
                 // Compute new dt after regrid if at level 0 and compute_new_dt_on_regrid.
                 //
@@ -2014,9 +2381,24 @@ Amr::timeStep (int  level,
                        << "ADVANCE with dt = " << dt_level[level] << "\n";
     }
 
+    const Real advance_strt = amrex::second();
+    const Long advance_bytes = FabArrayBase::m_FA_stats.num_send_bytes;
+
     Real dt_new = amr_level[level]->advance(time,dt_level[level],iteration,niter);
     BL_PROFILE_REGION_STOP("amr_level.advance");
 
+    if (record_perf_info) {
+        // This includes the FillPatch time, which is also reported on its own.
+        perf_info[level].advance_time += amrex::second() - advance_strt;
+        perf_info[level].comm_bytes += FabArrayBase::m_FA_stats.num_send_bytes - advance_bytes;
+        perf_info[level].nadvance++;
+    }
+
+    if (adaptive_regrid) {
+        regrid_control[level].advance_time += amrex::second() - advance_strt;
+        regrid_control[level].nadvance++;
+    }
+
     dt_min[level] = iteration == 1 ? dt_new : std::min(dt_min[level],dt_new);
 
     level_steps[level]++;
@@ -2034,8 +2416,16 @@ Amr::timeStep (int  level,
 
         int old_finest = finest_level;
 
+        const Real regrid_strt = amrex::second();
+        const Long regrid_bytes = FabArrayBase::m_FA_stats.num_send_bytes;
+
         regrid(level, time);
 
+        if (record_perf_info) {
+            perf_info[level].regrid_time += amrex::second() - regrid_strt;
+            perf_info[level].comm_bytes += FabArrayBase::m_FA_stats.num_send_bytes - regrid_bytes;
+        }
+
         if (old_finest < finest_level)
         {
             //
@@ -2070,12 +2460,99 @@ Amr::timeStep (int  level,
         }
     }
 
+    const Real post_step_strt = amrex::second();
+    const Long post_step_bytes = FabArrayBase::m_FA_stats.num_send_bytes;
+
     amr_level[level]->post_timestep(iteration);
 
+    if (record_perf_info) {
+        perf_info[level].post_step_time += amrex::second() - post_step_strt;
+        perf_info[level].comm_bytes += FabArrayBase::m_FA_stats.num_send_bytes - post_step_bytes;
+    }
+
     // Set this back to negative so we know whether we are in fact in this routine
     which_level_being_advanced = -1;
 }
 
+void
+Amr::finishCheckpointDrain (bool wait)
+{
+    if (drain_ckfile.empty()) {
+        return;
+    }
+
+    BL_PROFILE("Amr::finishCheckpointDrain()");
+
+    auto dDrainTime0 = amrex::second();
+
+    if (wait && drain_thread) {
+        drain_thread->Finish();
+    }
+
+    int state = drain_status->load();
+    ParallelDescriptor::ReduceIntMin(state);
+    if (state == 0) {
+        return;   // ---- still copying somewhere
+    }
+
+    const std::string target = drain_ckfile + ".temp";
+    if (state < 0) {
+        amrex::Error("Amr::finishCheckpointDrain():  copying the staged checkpoint to "
+                     + target + " failed");
+    }
+
+    const auto leaders = ParallelDescriptor::Gather(int(isNodeLeader()),
+                                                    ParallelDescriptor::IOProcessorNumber());
+    if (ParallelDescriptor::IOProcessor())
+    {
+        const std::string ChecksumsName = target + "/Checksums";
+        std::ofstream Checksums(ChecksumsName, std::ios::out | std::ios::trunc);
+        if ( ! Checksums.good()) {
+            amrex::FileOpenFailed(ChecksumsName);
+        }
+        for (int rank = 0; rank < static_cast<int>(leaders.size()); ++rank)
+        {
+            if ( ! leaders[rank]) { continue; }
+            const std::string name = ChecksumsName + "_" + std::to_string(rank);
+            {
+                std::ifstream manifest(name);
+                if ( ! manifest.good()) {
+                    amrex::FileOpenFailed(name);
+                }
+                if (manifest.peek() != std::ifstream::traits_type::eof()) {
+                    Checksums << manifest.rdbuf();
+                }
+            }
+            FileSystem::Remove(name);
+        }
+        Checksums.close();
+
+        const std::string MarkerName = target + "/CheckpointComplete";
+        std::ofstream Marker(MarkerName, std::ios::out | std::ios::trunc);
+        Marker << drain_ckfile << '\n';
+        Marker.close();
+
+        if (Checksums.fail() || Marker.fail()) {
+            amrex::Error("Amr::finishCheckpointDrain():  writing " + MarkerName + " failed");
+        }
+        if (std::rename(target.c_str(), drain_ckfile.c_str()) != 0) {
+            amrex::Error("Amr::finishCheckpointDrain():  renaming " + target + " to "
+                         + drain_ckfile + " failed");
+        }
+    }
+    ParallelDescriptor::Barrier("Amr::finishCheckpointDrain");
+
+    if (verbose > 0) {
+        auto dDrainTime = amrex::second() - dDrainTime0;
+        ParallelDescriptor::ReduceRealMax(dDrainTime, ParallelDescriptor::IOProcessorNumber());
+        amrex::Print() << "CHECKPOINT: " << drain_ckfile << " complete, finishCheckpointDrain() time = "
+                       << dDrainTime << " secs." << '\n';
+    }
+
+    drain_ckfile.clear();
+    drain_status.reset();
+}
+
 Real
 Amr::coarseTimeStepDt (Real stop_time)
 {
@@ -2095,6 +2572,14 @@ Amr::coarseTimeStep (Real stop_time)
 
     run_strt = amrex::second() ;
 
+    if (stop_time >= 0.0) {
+        run_stop_time = stop_time;
+    }
+
+    for (auto& pi : perf_info) {
+        pi = PerfInfo();
+    }
+
     //
     // Compute new dt.
     //
@@ -2193,6 +2678,10 @@ Amr::coarseTimeStep (Real stop_time)
     }
     if (record_run_info_terse && ParallelDescriptor::IOProcessor())
         runlog_terse << level_steps[0] << " " << cumtime << " " << dt_level[0] << '\n';
+    if (record_perf_info)
+    {
+        writePerfInfo(amrex::second() - run_strt);
+    }
 
     int check_test = 0;
 
@@ -2319,7 +2808,22 @@ Amr::coarseTimeStep (Real stop_time)
 
     updateInSitu();
 
+    //
+    // Polling is collective, so it is only done every
+    // amr.checkpoint_drain_poll_int coarse steps while a drain is running.
+    //
+    if ( ! drain_ckfile.empty() && checkpoint_drain_poll_int > 0
+         && (level_steps[0] - last_checkpoint) % checkpoint_drain_poll_int == 0)
+    {
+        finishCheckpointDrain(false);
+    }
+
     bUserStopRequest = to_stop;
+
+    if ( ! drain_ckfile.empty() && isLastCoarseStep()) {
+        finishCheckpointDrain(true);
+    }
+
     if (to_stop)
     {
         ParallelDescriptor::Barrier("Amr::coarseTimeStep::to_stop");
@@ -2619,9 +3123,16 @@ Amr::regrid (int  lbase,
             new_dmap[lev] = makeLoadBalanceDistributionMap(lev, time, new_grid_places[lev]);
         }
         else if (new_dmap[lev].empty()) {
-            new_dmap[lev].define(new_grid_places[lev]);
+            if (incremental_regrid && !initial && amr_level[lev]) {
+                new_dmap[lev] = makeIncrementalDistributionMap(lev, new_grid_places[lev]);
+            } else {
+                new_dmap[lev].define(new_grid_places[lev]);
+            }
         }
 
+        regrid_cells_reused[lev] = 0;
+        regrid_cells_filled[lev] = 0;
+
         AmrLevel* a = (*levelbld)(*this,lev,Geom(lev),new_grid_places[lev],
                                   new_dmap[lev],cumtime);
 
@@ -2644,6 +3155,9 @@ Amr::regrid (int  lbase,
             // NOTE: The init function may use a filPatch from the old level,
             //       which therefore needs remain in the hierarchy during the call.
             //
+            if (incremental_regrid) {
+                amr_level[lev]->incremental_regrid_target = a;
+            }
             a->init(*amr_level[lev]);
             amr_level[lev].reset(a);
             this->SetBoxArray(lev, amr_level[lev]->boxArray());
@@ -2715,6 +3229,92 @@ Amr::regrid (int  lbase,
             printGridSummary(amrex::OutStream(),start,finest_level);
         }
     }
+
+    if (verbose > 0 && incremental_regrid && !initial)
+    {
+        for (int lev = start; lev <= new_finest; ++lev)
+        {
+            const Long ntot = regrid_cells_reused[lev] + regrid_cells_filled[lev];
+            if (ntot > 0) {
+                amrex::Print() << "  Level " << lev << ": " << regrid_cells_reused[lev]
+                               << " cells reused in place, " << regrid_cells_filled[lev]
+                               << " filled (" << 100.0*regrid_cells_reused[lev]/ntot
+                               << "% reused)\n";
+            }
+        }
+    }
+}
+
+DistributionMapping
+Amr::makeIncrementalDistributionMap (int lev, const BoxArray& ba) const
+{
+    BL_PROFILE("makeIncrementalDistributionMap()");
+
+    const BoxArray& oba = boxArray(lev);
+    const DistributionMapping& odm = DistributionMap(lev);
+    const int nprocs = ParallelDescriptor::NProcs();
+
+    Vector<int> pmap(ba.size(), -1);
+    Vector<Long> load(nprocs, 0);
+    Vector<int> fresh;
+
+    for (int i = 0, N = ba.size(); i < N; ++i)
+    {
+        const Box& bx = ba[i];
+        for (auto const& is : oba.intersections(bx))
+        {
+            if (oba[is.first] == bx) {
+                pmap[i] = odm[is.first];
+                load[pmap[i]] += bx.numPts();
+                break;
+            }
+        }
+        if (pmap[i] < 0) {
+            fresh.push_back(i);
+        }
+    }
+
+    //
+    // Largest new boxes first, each onto the least loaded rank.
+    //
+    std::stable_sort(fresh.begin(), fresh.end(),
+                     [&] (int a, int b) { return ba[a].numPts() > ba[b].numPts(); });
+
+    using LoadRank = std::pair<Long,int>;
+    std::priority_queue<LoadRank, std::vector<LoadRank>, std::greater<LoadRank> > pq;
+    for (int p = 0; p < nprocs; ++p) {
+        pq.push(LoadRank(load[p], p));
+    }
+    for (int i : fresh)
+    {
+        LoadRank lr = pq.top();
+        pq.pop();
+        pmap[i] = lr.second;
+        lr.first += ba[i].numPts();
+        pq.push(lr);
+    }
+
+    //
+    // Keeping the unchanged boxes in place can leave the ranks unbalanced.
+    // Start afresh if so.
+    //
+    Long max_load = 0;
+    while (!pq.empty()) {
+        max_load = std::max(max_load, pq.top().first);
+        pq.pop();
+    }
+    const Real avg_load = static_cast<Real>(ba.numPts()) / static_cast<Real>(nprocs);
+    if (max_load > incremental_regrid_max_imbalance*avg_load)
+    {
+        if (verbose > 0) {
+            amrex::Print() << "Incremental regrid on level " << lev
+                           << ": load imbalance " << max_load/avg_load
+                           << " exceeds amr.incremental_regrid_max_imbalance, using a new distribution map\n";
+        }
+        return DistributionMapping(ba);
+    }
+
+    return DistributionMapping(std::move(pmap));
 }
 
 DistributionMapping
@@ -2761,6 +3361,308 @@ Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba) con
     return newdm;
 }
 
+Vector<Real>
+Amr::boxCosts (int lev, Real time) const
+{
+    const BoxArray& ba = boxArray(lev);
+    Vector<Real> cost(ba.size(), 0.0);
+
+    const int work_est_type = amr_level[0]->WorkEstType();
+
+    if (work_est_type >= 0)
+    {
+        MultiFab workest(ba, DistributionMap(lev), 1, 0, MFInfo(), FArrayBoxFactory());
+        AmrLevel::FillPatch(*amr_level[lev], workest, 0, time, work_est_type, 0, 1, 0);
+        for (MFIter mfi(workest); mfi.isValid(); ++mfi) {
+            cost[mfi.index()] = workest[mfi].sum<RunOn::Device>(mfi.validbox(), 0);
+        }
+        ParallelDescriptor::ReduceRealSum(cost.data(), cost.size());
+    }
+    else
+    {
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            cost[i] = static_cast<Real>(ba[i].numPts());
+        }
+    }
+
+    return cost;
+}
+
+bool
+Amr::adaptiveRegridCheck (int lev, Real time)
+{
+    BL_PROFILE("Amr::adaptiveRegridCheck()");
+
+    if (useFixedCoarseGrids() && lev < useFixedUpToLevel()) {
+        return true;
+    }
+
+    enum { NoAction = 0, DoRegrid, DoRebalance };
+    static const char* action_names[] = {"none", "regrid", "rebalance"};
+
+    RegridControl& rc = regrid_control[lev];
+    const int nlevs = finest_level+1;
+    const int nsteps = std::max(regrid_int[lev], 1);
+    //
+    // Levels rebuilt by regrid(lev).
+    //
+    const int lo = (lev == 0) ? 0 : lev+1;
+
+    //
+    // Measured time per step of lev spent on each level since the last check.
+    //
+    rc.advance_time_mark.resize(max_level+1, 0.0);
+    rc.nadvance_mark.resize(max_level+1, 0);
+    Vector<Real> tstep(nlevs, 0.0);
+    for (int l = 0; l < nlevs; ++l) {
+        tstep[l] = regrid_control[l].advance_time - rc.advance_time_mark[l];
+    }
+    ParallelDescriptor::ReduceRealMax(tstep.data(), nlevs);
+    {
+        int nsub = 1;
+        for (int l = 0; l < nlevs; ++l) {
+            if (l > lev) nsub *= n_cycle[l];
+            const Long nadv = regrid_control[l].nadvance - rc.nadvance_mark[l];
+            tstep[l] = (l >= lev && nadv > 0) ? tstep[l]/static_cast<Real>(nadv)*nsub : 0.0;
+        }
+    }
+    Real t_scope = 0.0, t_fine = 0.0;
+    for (int l = lo; l < nlevs; ++l) {
+        t_scope += tstep[l];
+        if (l > lev) t_fine += tstep[l];
+    }
+
+    const int last_action = rc.last_action;
+    const Real payoff = (rc.last_step_time - t_scope) * level_count[lev] - rc.last_cost;
+
+    //
+    // Tag drift: tags within half the error buffer of the edge of the finer
+    // grids, or outside them, have escaped.  The tagged fraction of the finer
+    // grids, relative to that just after they were made, measures the waste.
+    // ErrorEst is only called every amr.adaptive_regrid_tag_int checks, and
+    // at the first check after a regrid.
+    //
+    const bool estimate_tags = rc.grid_eff < 0.0 || lev == finest_level
+        || rc.ntagskip+1 >= adaptive_regrid_tag_int;
+    Long ntags[3] = {0, 0, 0};
+    Real fine_eff = 0.0;
+    Real waste = 0.0;
+    if (estimate_tags)
+    {
+        rc.ntagskip = 0;
+
+        const IntVect margin = n_error_buf[lev] / 2;
+        TagBoxArray tags(boxArray(lev), DistributionMap(lev), margin);
+        ErrorEst(lev, tags, time, 0);
+
+        ntags[0] = tags.numTags(true);
+        tags.buffer(margin);
+        {
+            const Box& domain = Geom(lev).Domain();
+            BoxList outside = amrex::boxDiff(amrex::grow(domain,margin), domain);
+            if (outside.isNotEmpty()) {
+                tags.setVal(BoxArray(std::move(outside)), TagBox::CLEAR);
+            }
+        }
+        if (useFixedCoarseGrids()) {
+            tags.setVal(GetAreaNotToTag(lev), TagBox::CLEAR);
+        }
+        //
+        // The buffered tags in the ghost cells are counted by the grids
+        // they belong to, not by the ghost cells of their neighbors.
+        //
+        tags.mapPeriodicRemoveDuplicates(Geom(lev));
+        ntags[1] = tags.numTags(true);
+        Long fine_pts = 0;
+        if (lev < finest_level) {
+            const BoxArray& cfine = amrex::coarsen(boxArray(lev+1), refRatio(lev));
+            tags.setVal(cfine, TagBox::CLEAR);
+            fine_pts = cfine.numPts();
+        }
+        ntags[2] = tags.numTags(true);
+        ParallelDescriptor::ReduceLongSum(ntags, 3);
+
+        fine_eff = (fine_pts > 0)
+            ? static_cast<Real>(ntags[1]-ntags[2]) / static_cast<Real>(fine_pts) : 0.0;
+        if (rc.grid_eff < 0.0) {
+            rc.grid_eff = fine_eff;
+        }
+        waste = (rc.grid_eff > 0.0) ? std::max(0.0_rt, 1.0_rt - fine_eff/rc.grid_eff) : 0.0_rt;
+    }
+    else
+    {
+        ++rc.ntagskip;
+    }
+    const Long nescaped = ntags[2];
+
+    int action = NoAction;
+    std::string reason;
+    Real predicted_gain = 0.0;
+    Real predicted_cost = 0.0;
+
+    if (estimate_tags && lev < finest_level && ntags[0] == 0) {
+        action = DoRegrid;
+        reason = "no tags";
+    } else if (estimate_tags &&
+               static_cast<Real>(nescaped) > adaptive_regrid_drift_tol*static_cast<Real>(ntags[1])) {
+        action = DoRegrid;
+        reason = "tags escaped";
+    } else if (adaptive_regrid_max_skip > 0 && rc.nskip >= adaptive_regrid_max_skip) {
+        action = DoRegrid;
+        reason = "max skip";
+    } else if (estimate_tags) {
+        predicted_gain = waste * t_fine * nsteps;
+        predicted_cost = rc.regrid_cost;
+        if (rc.regrid_cost >= 0.0 && predicted_gain > rc.regrid_cost) {
+            action = DoRegrid;
+            reason = "grid efficiency";
+        }
+    }
+
+    //
+    // Not regridding: rebalance the levels regrid would have rebuilt if the
+    // time lost to imbalance until the next check exceeds the cost.
+    //
+    struct LBInfo { int lev; Real eff; Real eff_new; Real gain; Real cost; bool install; };
+    Vector<LBInfo> lbinfo;
+    if (action == NoAction && ParallelDescriptor::NProcs() > 1)
+    {
+        Vector<DistributionMapping> newdm(nlevs);
+        Long ncells = 0, nmoved_tot = 0;
+        for (int l = lo; l < nlevs; ++l) {
+            ncells += boxArray(l).numPts();
+        }
+
+        for (int l = lo; l < nlevs; ++l)
+        {
+            const BoxArray& ba = boxArray(l);
+            const DistributionMapping& dm = DistributionMap(l);
+            const Vector<Real>& cost = boxCosts(l, time);
+
+            Real eff = 1.0, eff_new = 1.0;
+            DistributionMapping::ComputeDistributionMappingEfficiency(dm, cost, &eff);
+
+            Real navg = static_cast<Real>(ba.size()) / static_cast<Real>(ParallelDescriptor::NProcs());
+            int nmax = static_cast<int>(std::max(std::round(loadbalance_max_fac*navg), std::ceil(navg)));
+            newdm[l] = DistributionMapping::makeKnapSack(cost, eff_new, nmax);
+
+            Long nmoved = 0;
+            for (int i = 0, N = ba.size(); i < N; ++i) {
+                if (newdm[l][i] != dm[i]) nmoved += ba[i].numPts();
+            }
+
+            LBInfo info{l, eff, eff_new, 0.0, 0.0, false};
+            if (nmoved > 0 && eff_new > eff)
+            {
+                info.gain = tstep[l] * nsteps * (1.0_rt - eff/eff_new);
+                if (rebalance_cost_per_cell >= 0.0) {
+                    info.cost = rebalance_cost_per_cell * static_cast<Real>(nmoved);
+                } else if (rc.regrid_cost >= 0.0) {
+                    info.cost = rc.regrid_cost * static_cast<Real>(nmoved) / static_cast<Real>(ncells);
+                }
+                info.install = info.gain > info.cost;
+            }
+            if (info.install) {
+                nmoved_tot += nmoved;
+                predicted_gain += info.gain;
+                predicted_cost += info.cost;
+            }
+            lbinfo.push_back(info);
+        }
+
+        if (nmoved_tot > 0)
+        {
+            action = DoRebalance;
+            reason = "imbalance";
+
+            const Real strt = amrex::second();
+            for (auto const& info : lbinfo) {
+                if (info.install) {
+                    InstallNewDistributionMap(info.lev, newdm[info.lev]);
+                }
+            }
+            for (auto const& info : lbinfo) {
+                if (info.install) {
+                    amr_level[info.lev]->post_regrid(lev, finest_level);
+                }
+            }
+            Real rebalance_time = amrex::second() - strt;
+            ParallelDescriptor::ReduceRealMax(rebalance_time);
+            rebalance_cost_per_cell = rebalance_time / static_cast<Real>(nmoved_tot);
+            rc.last_cost = rebalance_time;
+        }
+    }
+
+    if (action == DoRegrid) {
+        rc.nskip = 0;
+        for (int l = lev; l < max_level; ++l) {
+            regrid_control[l].grid_eff = -1.0;
+        }
+    } else {
+        ++rc.nskip;
+    }
+    rc.last_action = action;
+    rc.last_step_time = t_scope;
+    for (int l = 0; l <= max_level; ++l) {
+        rc.advance_time_mark[l] = regrid_control[l].advance_time;
+        rc.nadvance_mark[l] = regrid_control[l].nadvance;
+    }
+
+    if (verbose > 0) {
+        amrex::Print() << "Adaptive regrid on level " << lev << ": " << action_names[action];
+        if (action != NoAction) amrex::Print() << " (" << reason << ")";
+        if (estimate_tags) {
+            amrex::Print() << ", " << nescaped << " of " << ntags[1] << " buffered tags escaped, "
+                           << "grid efficiency " << fine_eff;
+        } else {
+            amrex::Print() << ", tags not estimated";
+        }
+        amrex::Print() << "\n";
+    }
+
+    if (ParallelDescriptor::IOProcessor() && regridlog.is_open())
+    {
+        const auto old_prec = regridlog.precision(8);
+        regridlog << "{\"step\":" << level_steps[0]
+                  << ",\"time\":" << time
+                  << ",\"level\":" << lev
+                  << ",\"action\":\"" << action_names[action] << "\""
+                  << ",\"reason\":\"" << reason << "\""
+                  << ",\"tags_estimated\":" << (estimate_tags ? "true" : "false");
+        if (estimate_tags) {
+            regridlog << ",\"ntags\":" << ntags[0]
+                      << ",\"buffered_tags\":" << ntags[1]
+                      << ",\"escaped_tags\":" << nescaped
+                      << ",\"grid_eff\":" << fine_eff
+                      << ",\"waste\":" << waste;
+        }
+        regridlog << ",\"step_time\":" << t_scope
+                  << ",\"regrid_cost\":" << rc.regrid_cost
+                  << ",\"predicted_gain\":" << predicted_gain
+                  << ",\"predicted_cost\":" << predicted_cost;
+        if (last_action != NoAction) {
+            regridlog << ",\"last_action\":\"" << action_names[last_action] << "\""
+                      << ",\"last_payoff\":" << payoff;
+        }
+        regridlog << ",\"levels\":[";
+        for (int n = 0; n < lbinfo.size(); ++n) {
+            auto const& info = lbinfo[n];
+            if (n > 0) regridlog << ",";
+            regridlog << "{\"level\":" << info.lev
+                      << ",\"load_balance_eff\":" << info.eff
+                      << ",\"load_balance_eff_new\":" << info.eff_new
+                      << ",\"gain\":" << info.gain
+                      << ",\"cost\":" << info.cost
+                      << ",\"rebalanced\":" << (info.install ? "true" : "false") << "}";
+        }
+        regridlog << "]}\n";
+        regridlog.precision(old_prec);
+        regridlog.flush();
+    }
+
+    return action == DoRegrid;
+}
+
 void
 Amr::LoadBalanceLevel0 (Real time)
 {
@@ -3204,6 +4106,25 @@ Amr::initPltAndChk ()
             amrex::Warning("Warning: both amr.check_int and amr.check_per are > 0.");
     }
 
+    //
+    // Write checkpoints to this node-local directory first, and copy them
+    // to their final location in the background.  Ignored with AsyncOut.
+    //
+    pp.queryAdd("checkpoint_stage_dir", checkpoint_stage_dir);
+    checkpoint_drain_poll_int = 4;
+    pp.queryAdd("checkpoint_drain_poll_int", checkpoint_drain_poll_int);
+    //
+    // The end of the run as the drivers read it, so that the last
+    // checkpoint is completed before the driver destroys Amr.
+    //
+    {
+        ParmParse ppg;
+        run_max_step = -1;
+        ppg.query("max_step", run_max_step);
+        run_stop_time = -1.0;
+        ppg.query("stop_time", run_stop_time);
+    }
+
     plot_file_root = "plt";
     pp.queryAdd("plot_file",plot_file_root);
 
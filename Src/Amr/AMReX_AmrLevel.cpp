@@ -31,6 +31,44 @@ EBSupport AmrLevel::m_eb_support_level = EBSupport::volume;
 DescriptorList AmrLevel::desc_lst;
 DeriveList     AmrLevel::derive_lst;
 
+namespace {
+
+//
+// Adds the wall time of a FillPatch on a level to the performance log of
+// Amr.  A FillPatch done inside another one, e.g. the FillPatchIterator of
+// AmrLevel::FillPatch, is not counted again.
+//
+class FillPatchTimer
+{
+public:
+    FillPatchTimer (Amr* amr, int lev) noexcept
+        : m_amr(amr), m_lev(lev), m_outer(depth++ == 0 && amr && amr->RecordPerfInfo()),
+          m_strt(m_outer ? amrex::second() : 0.0)
+    {}
+
+    ~FillPatchTimer ()
+    {
+        --depth;
+        if (m_outer) {
+            m_amr->addFillPatchTime(m_lev, amrex::second() - m_strt);
+        }
+    }
+
+    FillPatchTimer (const FillPatchTimer&) = delete;
+    FillPatchTimer& operator= (const FillPatchTimer&) = delete;
+
+private:
+    static int depth;
+    Amr* m_amr;
+    int  m_lev;
+    bool m_outer;
+    Real m_strt;
+};
+
+int FillPatchTimer::depth = 0;
+
+}
+
 void
 AmrLevel::postCoarseTimeStep (Real time)
 {
@@ -986,6 +1024,31 @@ FillPatchIterator::Initialize (int  boxGrow,
                                int  ncomp)
 {
     BL_PROFILE("FillPatchIterator::Initialize");
+    InitializeDoit(boxGrow, time, idx, scomp, ncomp, false);
+}
+
+void
+FillPatchIterator::Initialize_nowait (int  boxGrow,
+                                      Real time,
+                                      int  idx,
+                                      int  scomp,
+                                      int  ncomp)
+{
+    BL_PROFILE("FillPatchIterator::Initialize_nowait");
+    InitializeDoit(boxGrow, time, idx, scomp, ncomp, true);
+}
+
+void
+FillPatchIterator::InitializeDoit (int  boxGrow,
+                                   Real time,
+                                   int  idx,
+                                   int  scomp,
+                                   int  ncomp,
+                                   bool nowait)
+{
+    finish();
+
+    FillPatchTimer fp_timer(m_amrlevel.parent, m_amrlevel.level);
 
     BL_ASSERT(scomp >= 0);
     BL_ASSERT(ncomp >= 1);
@@ -1011,9 +1074,17 @@ FillPatchIterator::Initialize (int  boxGrow,
         const int SComp = m_range[i].first;
         const int NComp = m_range[i].second;
 
+        if (nowait) {
+            m_alias.push_back(std::make_unique<MultiFab>(m_fabs, amrex::make_alias, DComp, NComp));
+        }
+
         if (level == 0)
         {
-            FillFromLevel0(time, idx, SComp, DComp, NComp);
+            if (nowait) {
+                m_handles.push_back(FillFromLevel0_nowait(*m_alias.back(), time, idx, SComp, NComp));
+            } else {
+                FillFromLevel0(time, idx, SComp, DComp, NComp);
+            }
         }
         else
         {
@@ -1022,7 +1093,11 @@ FillPatchIterator::Initialize (int  boxGrow,
                                       m_amrlevel.parent->blockingFactor(m_amrlevel.level),
                                       boxGrow, boxType, desc.interp(SComp)))
             {
-                FillFromTwoLevels(time, idx, SComp, DComp, NComp);
+                if (nowait) {
+                    m_handles.push_back(FillFromTwoLevels_nowait(*m_alias.back(), time, idx, SComp, NComp));
+                } else {
+                    FillFromTwoLevels(time, idx, SComp, DComp, NComp);
+                }
             } else {
 
 #ifdef AMREX_USE_EB
@@ -1080,6 +1155,13 @@ FillPatchIterator::Initialize (int  boxGrow,
 
         DComp += NComp;
     }
+
+    if (nowait) {
+        m_time = time;
+        m_index = idx;
+        m_scomp = scomp;
+        return;
+    }
     //
     // Call hack to touch up fillPatched data.
     //
@@ -1091,6 +1173,32 @@ FillPatchIterator::Initialize (int  boxGrow,
                                              time);
 }
 
+void
+FillPatchIterator::finish ()
+{
+    if (m_index < 0) { return; }
+
+    BL_PROFILE("FillPatchIterator::finish");
+
+    FillPatchTimer fp_timer(m_amrlevel.parent, m_amrlevel.level);
+
+    for (auto& h : m_handles) {
+        h.finish();
+    }
+    m_handles.clear();
+    m_alias.clear();
+    //
+    // Call hack to touch up fillPatched data.
+    //
+    m_amrlevel.set_preferred_boundary_values(m_fabs,
+                                             m_index,
+                                             m_scomp,
+                                             0,
+                                             m_ncomp,
+                                             m_time);
+    m_index = -1;
+}
+
 void
 FillPatchIterator::FillFromLevel0 (Real time, int idx, int scomp, int dcomp, int ncomp)
 {
@@ -1109,6 +1217,25 @@ FillPatchIterator::FillFromLevel0 (Real time, int idx, int scomp, int dcomp, int
     amrex::FillPatchSingleLevel (m_fabs, time, smf, stime, scomp, dcomp, ncomp, geom, physbcf, scomp);
 }
 
+FillPatchHandle
+FillPatchIterator::FillFromLevel0_nowait (MultiFab& mf, Real time, int idx, int scomp, int ncomp)
+{
+    BL_ASSERT(m_amrlevel.level == 0);
+
+    StateData& statedata = m_amrlevel.state[idx];
+
+    Vector<MultiFab*> smf;
+    Vector<Real> stime;
+    statedata.getData(smf,stime,time);
+
+    const Geometry& geom = m_amrlevel.geom;
+
+    StateDataPhysBCFunct physbcf(statedata,scomp,geom);
+
+    return amrex::FillPatchSingleLevel_nowait(mf, mf.nGrowVect(), time, smf, stime,
+                                              scomp, 0, ncomp, geom, physbcf, scomp);
+}
+
 void
 FillPatchIterator::FillFromTwoLevels (Real time, int idx, int scomp, int dcomp, int ncomp)
 {
@@ -1149,6 +1276,46 @@ FillPatchIterator::FillFromTwoLevels (Real time, int idx, int scomp, int dcomp,
                               desc.getBCs(),scomp);
 }
 
+FillPatchHandle
+FillPatchIterator::FillFromTwoLevels_nowait (MultiFab& mf, Real time, int idx, int scomp, int ncomp)
+{
+    int ilev_fine = m_amrlevel.level;
+    int ilev_crse = ilev_fine-1;
+
+    BL_ASSERT(ilev_crse >= 0);
+
+    AmrLevel& fine_level = m_amrlevel;
+    AmrLevel& crse_level = m_amrlevel.parent->getLevel(ilev_crse);
+
+    const Geometry& geom_fine = fine_level.geom;
+    const Geometry& geom_crse = crse_level.geom;
+
+    Vector<MultiFab*> smf_crse;
+    Vector<Real> stime_crse;
+    StateData& statedata_crse = crse_level.state[idx];
+    statedata_crse.getData(smf_crse,stime_crse,time);
+    StateDataPhysBCFunct physbcf_crse(statedata_crse,scomp,geom_crse);
+
+    Vector<MultiFab*> smf_fine;
+    Vector<Real> stime_fine;
+    StateData& statedata_fine = fine_level.state[idx];
+    statedata_fine.getData(smf_fine,stime_fine,time);
+    StateDataPhysBCFunct physbcf_fine(statedata_fine,scomp,geom_fine);
+
+    const StateDescriptor& desc = AmrLevel::desc_lst[idx];
+
+    return amrex::FillPatchTwoLevels_nowait(mf, mf.nGrowVect(), time,
+                                            smf_crse, stime_crse,
+                                            smf_fine, stime_fine,
+                                            scomp, 0, ncomp,
+                                            geom_crse, geom_fine,
+                                            physbcf_crse, scomp,
+                                            physbcf_fine, scomp,
+                                            crse_level.fineRatio(),
+                                            desc.interp(scomp),
+                                            desc.getBCs(),scomp);
+}
+
 static
 bool
 HasPhysBndry (const Box&      b,
@@ -1507,7 +1674,10 @@ FillPatchIteratorHelper::fill (FArrayBox& fab,
 
 FillPatchIteratorHelper::~FillPatchIteratorHelper () {}
 
-FillPatchIterator::~FillPatchIterator () {}
+FillPatchIterator::~FillPatchIterator ()
+{
+    finish();
+}
 
 void
 AmrLevel::FillCoarsePatch (MultiFab& mf,
@@ -1520,6 +1690,8 @@ AmrLevel::FillCoarsePatch (MultiFab& mf,
 {
     BL_PROFILE("AmrLevel::FillCoarsePatch()");
 
+    FillPatchTimer fp_timer(parent, level);
+
     //
     // Must fill this region on crse level and interpolate.
     //
@@ -2108,11 +2280,134 @@ AmrLevel::FillPatch (AmrLevel& amrlevel,
 {
     BL_ASSERT(dcomp+ncomp-1 <= leveldata.nComp());
     BL_ASSERT(boxGrow <= leveldata.nGrow());
+    FillPatchTimer fp_timer(amrlevel.parent, amrlevel.level);
+    if (amrlevel.incremental_regrid_target) {
+        if (boxGrow == 0 &&
+            FillPatchIncremental(amrlevel, leveldata, time, index, scomp, ncomp, dcomp)) {
+            return;
+        }
+        amrlevel.parent->addRegridCells(amrlevel.level, 0, leveldata.boxArray().numPts());
+    }
     FillPatchIterator fpi(amrlevel, leveldata, boxGrow, time, index, scomp, ncomp);
     const MultiFab& mf_fillpatched = fpi.get_mf();
     MultiFab::Copy(leveldata, mf_fillpatched, 0, dcomp, ncomp, boxGrow);
 }
 
+bool
+AmrLevel::FillPatchIncremental (AmrLevel& old,
+                                MultiFab& leveldata,
+                                Real      time,
+                                int       index,
+                                int       scomp,
+                                int       ncomp,
+                                int       dcomp)
+{
+    //
+    // The moved FABs may have to be copied back if the old data are read
+    // again, so only move them into state data of the new level.
+    //
+    const AmrLevel& target = *old.incremental_regrid_target;
+    const StateData* target_state = nullptr;
+    for (int i = 0; i < target.state.size() && !target_state; ++i) {
+        if (&leveldata == &target.state[i].newData() ||
+            (target.state[i].hasOldData() && &leveldata == &target.state[i].oldData())) {
+            target_state = &target.state[i];
+        }
+    }
+    if (!target_state) { return false; }
+
+    StateData& statedata = old.state[index];
+
+    Vector<MultiFab*> smf;
+    Vector<Real> stime;
+    statedata.getData(smf,stime,time);
+
+    //
+    // Only a copy of all components without time interpolation can be
+    // done by moving FABs.
+    //
+    if (smf.size() != 1 || scomp != 0 || dcomp != 0 ||
+        ncomp != smf[0]->nComp() || ncomp != leveldata.nComp() ||
+        smf[0]->nGrowVect() != leveldata.nGrowVect() ||
+        smf[0]->ixType() != leveldata.ixType() ||
+        leveldata.hasEBFabFactory())
+    {
+        return false;
+    }
+
+    BL_PROFILE("AmrLevel::FillPatchIncremental()");
+
+    MultiFab& src = *smf[0];
+    const BoxArray& nba = leveldata.boxArray();
+    const DistributionMapping& ndm = leveldata.DistributionMap();
+    const BoxArray& oba = src.boxArray();
+    const DistributionMapping& odm = src.DistributionMap();
+
+    //
+    // Find the new boxes that exist unchanged on the same rank in the old
+    // level.  Everything else goes into the BoxArray that is filled.
+    //
+    Vector<int> old_index(nba.size(), -1);
+    BoxList fill_bl(nba.ixType());
+    Vector<int> fill_pmap;
+    Vector<int> fill_index;
+    Long nreused = 0, nfilled = 0;
+    for (int i = 0, N = nba.size(); i < N; ++i)
+    {
+        const Box& bx = nba[i];
+        for (auto const& is : oba.intersections(bx))
+        {
+            if (oba[is.first] == bx && odm[is.first] == ndm[i]) {
+                old_index[i] = is.first;
+                break;
+            }
+        }
+        if (old_index[i] >= 0) {
+            nreused += bx.numPts();
+        } else {
+            fill_bl.push_back(bx);
+            fill_pmap.push_back(ndm[i]);
+            fill_index.push_back(i);
+            nfilled += bx.numPts();
+        }
+    }
+
+    if (nreused == 0) { return false; }
+
+    if (!fill_bl.isEmpty())
+    {
+        BoxArray fill_ba(std::move(fill_bl));
+        DistributionMapping fill_dm(std::move(fill_pmap));
+        MultiFab fill_mf(fill_ba, fill_dm, ncomp, 0, MFInfo().SetAlloc(false));
+
+        FillPatchIterator fpi(old, fill_mf, 0, time, index, 0, ncomp);
+        const MultiFab& mf_fillpatched = fpi.get_mf();
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf_fillpatched); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            leveldata[fill_index[mfi.index()]].copy<RunOn::Device>(mf_fillpatched[mfi], bx, 0, bx, 0, ncomp);
+        }
+    }
+
+    Vector<std::pair<int,int> > moved;
+    for (int i : leveldata.IndexArray())
+    {
+        if (old_index[i] >= 0) {
+            leveldata.swapFab(i, src, old_index[i]);
+            moved.push_back(std::make_pair(old_index[i], i));
+        }
+    }
+    statedata.setMovedOut(src, *target_state, leveldata, std::move(moved));
+
+    old.parent->addRegridCells(old.level, nreused, nfilled);
+
+    return true;
+}
+
 void
 AmrLevel::FillPatchAdd (AmrLevel& amrlevel,
                         MultiFab& leveldata,
@@ -2125,6 +2420,7 @@ AmrLevel::FillPatchAdd (AmrLevel& amrlevel,
 {
     BL_ASSERT(dcomp+ncomp-1 <= leveldata.nComp());
     BL_ASSERT(boxGrow <= leveldata.nGrow());
+    FillPatchTimer fp_timer(amrlevel.parent, amrlevel.level);
     FillPatchIterator fpi(amrlevel, leveldata, boxGrow, time, index, scomp, ncomp);
     const MultiFab& mf_fillpatched = fpi.get_mf();
     MultiFab::Add(leveldata, mf_fillpatched, 0, dcomp, ncomp, boxGrow);
@@ -26,6 +26,7 @@ static constexpr int MFOLDDATA = 1;
 
 Vector<std::string> StateData::fabArrayHeaderNames;
 std::map<std::string, Vector<char> > *StateData::faHeaderMap;
+bool StateData::redistributeOnRestart = false;
 
 
 StateData::StateData ()
@@ -57,6 +58,7 @@ StateData::StateData (StateData&& rhs) noexcept
       old_time(rhs.old_time),
       new_data(std::move(rhs.new_data)),
       old_data(std::move(rhs.old_data)),
+      moved_out(std::move(rhs.moved_out)),
       arena(rhs.arena)
 {
 }
@@ -72,6 +74,7 @@ StateData::operator= (StateData const& rhs)
     dmap = rhs.dmap;
     new_time = rhs.new_time;
     old_time = rhs.old_time;
+    moved_out.clear();
     new_data = std::make_unique<MultiFab>(grids,dmap,desc->nComp(),desc->nExtra(),
                                           MFInfo().SetTag("StateData").SetArena(arena),
                                           *m_factory);
@@ -126,6 +129,7 @@ StateData::define (const Box&             p_domain,
     }
     int ncomp = desc->nComp();
 
+    moved_out.clear();
     new_data = std::make_unique<MultiFab>(grids,dmap,ncomp,desc->nExtra(),
                                           MFInfo().SetTag("StateData").SetArena(arena),
                                           *m_factory);
@@ -220,6 +224,7 @@ StateData::restartDoit (std::istream& is, const std::string& chkfile)
     int nsets;
     is >> nsets;
 
+    moved_out.clear();
     new_data = std::make_unique<MultiFab>(grids,dmap,desc->nComp(),desc->nExtra(),
                                           MFInfo().SetTag("StateData").SetArena(arena),
                                           *m_factory);
@@ -273,7 +278,11 @@ StateData::restartDoit (std::istream& is, const std::string& chkfile)
             }
         }
 
-        VisMF::Read(*whichMF, FullPathName, faHeader);
+        if (redistributeOnRestart) {
+            VisMF::ReadRedistribute(*whichMF, FullPathName, faHeader);
+        } else {
+            VisMF::Read(*whichMF, FullPathName, faHeader);
+        }
     }
 }
 
@@ -289,6 +298,7 @@ StateData::restart (const StateDescriptor& d,
     old_time.stop  = rhs.old_time.stop;
     new_time.start = rhs.new_time.start;
     new_time.stop  = rhs.new_time.stop;
+    moved_out.clear();
     old_data.reset();
     new_data = std::make_unique<MultiFab>(grids,dmap,desc->nComp(),desc->nExtra(),
                                           MFInfo().SetTag("StateData").SetArena(arena),
@@ -402,6 +412,7 @@ StateData::swapTimeLevels (Real dt)
 void
 StateData::replaceOldData (MultiFab&& mf)
 {
+    forgetMovedOut(old_data.get());
     old_data = std::make_unique<MultiFab>(std::move(mf));
 }
 
@@ -416,6 +427,7 @@ StateData::replaceOldData (StateData& s)
 void
 StateData::replaceNewData (MultiFab&& mf)
 {
+    forgetMovedOut(new_data.get());
     new_data = std::make_unique<MultiFab>(std::move(mf));
 }
 
@@ -763,6 +775,44 @@ StateData::getData (Vector<MultiFab*>& data,
             amrex::Error("StateData::getData(): how did we get here?");
         }
     }
+
+    //
+    // Data whose FABs have been moved out by an incremental regrid are read
+    // again.  Copy the moved FABs back from the new level.
+    //
+    for (auto it = moved_out.begin(); it != moved_out.end(); )
+    {
+        if (std::find(data.begin(), data.end(), it->src) != data.end()) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                it->dst == it->dst_state->new_data.get() || it->dst == it->dst_state->old_data.get(),
+                "StateData::getData(): the data that FABs were moved into by an incremental regrid are gone");
+            const int ncomp = it->src->nComp();
+            for (auto const& idx : it->index) {
+                (*it->src)[idx.first].copy<RunOn::Device>((*it->dst)[idx.second], 0, 0, ncomp);
+            }
+            it = moved_out.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void
+StateData::setMovedOut (MultiFab& mf, const StateData& dst_state, const MultiFab& dst,
+                        Vector<std::pair<int,int> >&& index)
+{
+    AMREX_ASSERT(&mf == new_data.get() || &mf == old_data.get());
+    AMREX_ASSERT(&dst == dst_state.new_data.get() || &dst == dst_state.old_data.get());
+    moved_out.push_back(MovedOut{&mf, &dst_state, &dst, std::move(index)});
+}
+
+void
+StateData::forgetMovedOut (const MultiFab* mf)
+{
+    if (mf == nullptr) { return; }
+    moved_out.erase(std::remove_if(moved_out.begin(), moved_out.end(),
+                                   [=] (MovedOut const& m) { return m.src == mf; }),
+                    moved_out.end());
 }
 
 void
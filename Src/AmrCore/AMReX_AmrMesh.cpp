@@ -8,6 +8,110 @@
 
 namespace amrex {
 
+namespace {
+
+void cluster_tags (IntVect* tags, Long ntags, Real grid_eff, bool use_new_chop,
+                   BoxArray& p_n_ba, BoxList& bl)
+{
+    if (ntags == 0) return;
+    ClusterList clist(tags, ntags);
+    if (use_new_chop) {
+        clist.new_chop(grid_eff);
+    } else {
+        clist.chop(grid_eff);
+    }
+    clist.intersect(p_n_ba);
+    clist.boxList(bl);
+}
+
+//
+// Each process clusters the tags it owns.  The resulting boxes are merged
+// into a disjoint set, and the tags covered by merged boxes whose global
+// efficiency is below grid_eff are re-clustered on the I/O process.  The
+// result is only valid on the I/O process.
+//
+void cluster_tags_distributed (Gpu::PinnedVector<IntVect>& tagvec, Real grid_eff,
+                               bool use_new_chop, BoxArray& p_n_ba, BoxList& new_bx)
+{
+    BL_PROFILE("AmrMesh-cluster-distributed");
+
+    const Long ntags = tagvec.size();
+
+    BoxList local_bl;
+    cluster_tags(tagvec.data(), ntags, grid_eff, use_new_chop, p_n_ba, local_bl);
+
+    Vector<Box> boxes(local_bl.begin(), local_bl.end());
+    local_bl.clear();
+    amrex::AllGatherBoxes(boxes);
+
+    BoxArray merged(BoxList(std::move(boxes)));
+    merged.removeOverlap(false);
+
+    const int nboxes = merged.size();
+    Vector<Long> count(nboxes, 0);
+    Vector<int> owner(ntags);
+    std::vector<std::pair<int,Box> > isects;
+    for (Long i = 0; i < ntags; ++i) {
+        merged.intersections(Box(tagvec[i],tagvec[i]), isects, true, 0);
+        AMREX_ASSERT(!isects.empty());
+        owner[i] = isects[0].first;
+        ++count[owner[i]];
+    }
+    ParallelDescriptor::ReduceLongSum(count.data(), nboxes);
+
+    Vector<char> is_bad(nboxes);
+    BoxList good_bl;
+    for (int i = 0; i < nboxes; ++i) {
+        is_bad[i] = static_cast<Real>(count[i]) < grid_eff * static_cast<Real>(merged[i].d_numPts());
+        if (!is_bad[i]) good_bl.push_back(merged[i]);
+    }
+
+    Long nbad = 0;
+    for (Long i = 0; i < ntags; ++i) {
+        if (is_bad[owner[i]]) tagvec[nbad++] = tagvec[i];
+    }
+
+    Gpu::PinnedVector<IntVect> badtags;
+#ifdef BL_USE_MPI
+    const int IOProcNumber = ParallelDescriptor::IOProcessorNumber();
+    const std::vector<int>& countvec = ParallelDescriptor::Gather(static_cast<int>(nbad),
+                                                                  IOProcNumber);
+    std::vector<int> offset(countvec.size(),0);
+    if (ParallelDescriptor::IOProcessor()) {
+        Long nbad_tot = countvec[0];
+        for (int i = 1, N = offset.size(); i < N; i++) {
+            offset[i] = offset[i-1] + countvec[i-1];
+            nbad_tot += countvec[i];
+        }
+        badtags.resize(std::max(nbad_tot,Long(1)));
+    }
+    ParallelDescriptor::Gatherv(tagvec.data(), static_cast<int>(nbad), badtags.data(),
+                                countvec, offset, IOProcNumber);
+    if (ParallelDescriptor::IOProcessor()) {
+        badtags.resize(offset.back()+countvec.back());
+    }
+#else
+    tagvec.resize(nbad);
+    badtags = std::move(tagvec);
+#endif
+
+    if (ParallelDescriptor::IOProcessor()) {
+        BoxList bad_bl;
+        cluster_tags(badtags.data(), badtags.size(), grid_eff, use_new_chop, p_n_ba, bad_bl);
+        if (bad_bl.isEmpty()) {
+            new_bx = std::move(good_bl);
+        } else {
+            // Boxes are trimmed against earlier ones, so the good boxes are kept intact.
+            good_bl.catenate(bad_bl);
+            BoxArray ba(std::move(good_bl));
+            ba.removeOverlap(false);
+            new_bx = ba.boxList();
+        }
+    }
+}
+
+}
+
 AmrMesh::AmrMesh ()
 {
     Geometry::Setup();
@@ -371,6 +475,7 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
     }
 
     pp.queryAdd("check_input", check_input);
+    pp.queryAdd("distributed_clustering", use_distributed_clustering);
 
     finest_level = -1;
 
@@ -675,10 +780,18 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         // Create initial cluster containing all tagged points.
         //
         Gpu::PinnedVector<IntVect> tagvec;
-        tags.collate(tagvec);
+        Long ntags;
+        if (use_distributed_clustering) {
+            tags.local_collate(tagvec);
+            ntags = tagvec.size();
+            ParallelDescriptor::ReduceLongSum(ntags);
+        } else {
+            tags.collate(tagvec);
+            ntags = tagvec.size();
+        }
         tags.clear();
 
-        if (tagvec.size() > 0)
+        if (ntags > 0)
         {
             //
             // Created new level, now generate efficient grids.
@@ -689,23 +802,21 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
 
             if (levf > useFixedUpToLevel()) {
                 BoxList new_bx;
-                if (ParallelDescriptor::IOProcessor()) {
+                if (use_distributed_clustering) {
+                    cluster_tags_distributed(tagvec, grid_eff, use_new_chop, p_n_ba[levc], new_bx);
+                } else if (ParallelDescriptor::IOProcessor()) {
                     BL_PROFILE("AmrMesh-cluster");
                     //
                     // Construct initial cluster.
                     //
-                    ClusterList clist(&tagvec[0], tagvec.size());
-                    if (use_new_chop) {
-                        clist.new_chop(grid_eff);
-                    } else {
-                        clist.chop(grid_eff);
-                    }
-                    clist.intersect(p_n_ba[levc]);
+                    cluster_tags(tagvec.data(), tagvec.size(), grid_eff, use_new_chop,
+                                 p_n_ba[levc], new_bx);
+                }
+                if (ParallelDescriptor::IOProcessor()) {
                     //
                     // Efficient properly nested Clusters have been constructed
                     // now generate list of grids at level levf.
                     //
-                    clist.boxList(new_bx);
                     new_bx.refine(bf_lev[levc]);
                     new_bx.simplify();
 
@@ -1037,6 +1148,7 @@ std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
     os << "  refine_grid_layout_dims = " << amr_mesh.refine_grid_layout_dims << "\n";
     os << "  check_input = " << amr_mesh.check_input  << "\n";
     os << "  use_new_chop = " << amr_mesh.use_new_chop << "\n";
+    os << "  use_distributed_clustering = " << amr_mesh.use_distributed_clustering << "\n";
     os << "  iterate_on_new_grids = " << amr_mesh.iterate_on_new_grids << "\n";
     return os;
 }
@@ -10,9 +10,80 @@
 #include <cstdlib>
 #include <cmath>
 #include <climits>
+#include <cstdint>
+#include <cstring>
 
 namespace amrex {
 
+namespace {
+
+    // Number of nonzero chars in [p,p+n), eight cells at a time.
+    Long count_tags (const char* p, Long n) noexcept
+    {
+        constexpr std::uint64_t lsb = 0x0101010101010101ULL;
+        Long c = 0;
+        Long i = 0;
+        for (; i+8 <= n; i += 8) {
+            std::uint64_t w;
+            std::memcpy(&w, p+i, 8);
+            if (w != 0) {
+                // Fold each byte into its lowest bit, then sum the bytes.
+                w |= w >> 4;
+                w |= w >> 2;
+                w |= w >> 1;
+                c += static_cast<Long>(((w & lsb) * lsb) >> 56);
+            }
+        }
+        for (; i < n; ++i) {
+            c += (p[i] != TagBox::CLEAR);
+        }
+        return c;
+    }
+
+    // A run is AMREX_SPACEDIM ints for its first cell followed by its
+    // length in the first direction.
+    constexpr int run_size = AMREX_SPACEDIM+1;
+
+    bool continues_run (IntVect const& start, int len, IntVect const& iv) noexcept
+    {
+        bool r = iv[0] == start[0]+len;
+        for (int idim = 1; idim < AMREX_SPACEDIM; ++idim) {
+            r = r && iv[idim] == start[idim];
+        }
+        return r;
+    }
+
+    void encode_tag_runs (const IntVect* tags, Long ntags, Vector<int>& runs)
+    {
+        runs.clear();
+        Long i = 0;
+        while (i < ntags) {
+            IntVect const& start = tags[i];
+            int len = 1;
+            while (i+len < ntags && continues_run(start, len, tags[i+len])) {
+                ++len;
+            }
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                runs.push_back(start[idim]);
+            }
+            runs.push_back(len);
+            i += len;
+        }
+    }
+
+    void decode_tag_runs (const int* runs, Long nints, IntVect* tags)
+    {
+        for (Long r = 0; r < nints; r += run_size) {
+            IntVect iv(AMREX_D_DECL(runs[r],runs[r+1],runs[r+2]));
+            const int len = runs[r+AMREX_SPACEDIM];
+            for (int i = 0; i < len; ++i) {
+                *tags++ = iv;
+                ++iv[0];
+            }
+        }
+    }
+}
+
 TagBox::TagBox () noexcept {}
 
 TagBox::TagBox (Arena* ar) noexcept
@@ -121,6 +192,39 @@ TagBox::buffer (const IntVect& a_nbuff, const IntVect& a_nwid) noexcept
     }
 }
 
+Long
+TagBox::numTags (const Box& bx) const noexcept
+{
+    BL_ASSERT(domain.contains(bx));
+    Array4<char const> const& a = this->const_array();
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) {
+        ReduceOps<ReduceOpSum> reduce_op;
+        ReduceData<Long> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        reduce_op.eval(bx, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+        {
+            return {static_cast<Long>(a(i,j,k) != TagBox::CLEAR)};
+        });
+        ReduceTuple hv = reduce_data.value(reduce_op);
+        return amrex::get<0>(hv);
+    } else
+#endif
+    {
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        const Long nx = hi.x - lo.x + 1;
+        Long c = 0;
+        for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+                c += count_tags(a.ptr(lo.x,j,k), nx);
+            }
+        }
+        return c;
+    }
+}
+
 // DEPRECATED
 Vector<int>
 TagBox::tags () const noexcept
@@ -380,20 +484,16 @@ TagBoxArray::local_collate_cpu (Gpu::PinnedVector<IntVect>& v) const
 {
     if (this->local_size() == 0) return;
 
+    // Unlike numTags, the ghost cells are included: the tags that
+    // mapPeriodicRemoveDuplicates keeps there, across periodic boundaries,
+    // must be seen by the clustering.
     Vector<int> count(this->local_size());
 #ifdef AMREX_USE_OMP
 #pragma omp parallel
 #endif
     for (MFIter fai(*this); fai.isValid(); ++fai)
     {
-        Array4<char const> const& arr = this->const_array(fai);
-        Box const& bx = fai.fabbox();
-        int c = 0;
-        AMREX_LOOP_3D(bx,i,j,k,
-        {
-            if (arr(i,j,k) != TagBox::CLEAR) ++c;
-        });
-        count[fai.LocalIndex()] = c;
+        count[fai.LocalIndex()] = static_cast<int>((*this)[fai].numTags(fai.fabbox()));
     }
 
     Vector<int> offset(count.size()+1, 0);
@@ -413,12 +513,28 @@ TagBoxArray::local_collate_cpu (Gpu::PinnedVector<IntVect>& v) const
             IntVect* p = v.data() + offset[li];
             Array4<char const> const& arr = this->const_array(fai);
             Box const& bx = fai.fabbox();
-            AMREX_LOOP_3D(bx,i,j,k,
-            {
-                if (arr(i,j,k) != TagBox::CLEAR) {
-                    *p++ = IntVect(AMREX_D_DECL(i,j,k));
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+                const char* row = arr.ptr(lo.x,j,k);
+                int i = lo.x;
+                while (i <= hi.x) {
+                    // Skip eight untagged cells at a time.
+                    if (i+8 <= hi.x+1) {
+                        std::uint64_t w;
+                        std::memcpy(&w, row+(i-lo.x), 8);
+                        if (w == 0) {
+                            i += 8;
+                            continue;
+                        }
+                    }
+                    if (row[i-lo.x] != TagBox::CLEAR) {
+                        *p++ = IntVect(AMREX_D_DECL(i,j,k));
+                    }
+                    ++i;
                 }
-            });
+            }}
         }
     }
 }
@@ -591,19 +707,25 @@ TagBoxArray::local_collate_gpu (Gpu::PinnedVector<IntVect>& v) const
 #endif
 
 void
-TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+TagBoxArray::local_collate (Gpu::PinnedVector<IntVect>& v) const
 {
-    BL_PROFILE("TagBoxArray::collate()");
-
-    Gpu::PinnedVector<IntVect> TheLocalCollateSpace;
 #ifdef AMREX_USE_GPU
     if (Gpu::inLaunchRegion()) {
-        local_collate_gpu(TheLocalCollateSpace);
+        local_collate_gpu(v);
     } else
 #endif
     {
-        local_collate_cpu(TheLocalCollateSpace);
+        local_collate_cpu(v);
     }
+}
+
+void
+TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+{
+    BL_PROFILE("TagBoxArray::collate()");
+
+    Gpu::PinnedVector<IntVect> TheLocalCollateSpace;
+    local_collate(TheLocalCollateSpace);
 
     Long count = TheLocalCollateSpace.size();
 
@@ -623,33 +745,48 @@ TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
 
 #ifdef BL_USE_MPI
     //
-    // On I/O proc. this holds all tags after they've been gather'd.
-    // On other procs. non-mempty signals size is not zero.
+    // Send runs of tagged cells instead of the cells themselves.
     //
-    if (ParallelDescriptor::IOProcessor()) {
-        TheGlobalCollateSpace.resize(numtags);
-    } else {
-        TheGlobalCollateSpace.resize(1);
-    }
+    Vector<int> runs;
+    encode_tag_runs(TheLocalCollateSpace.data(), count, runs);
+    TheLocalCollateSpace.clear();
 
     //
-    // Tell root CPU how many tags each CPU will be sending.
+    // Tell root CPU how many ints each CPU will be sending.
     //
     const int IOProcNumber = ParallelDescriptor::IOProcessorNumber();
-    const std::vector<int>& countvec = ParallelDescriptor::Gather(static_cast<int>(count),
+    const std::vector<int>& countvec = ParallelDescriptor::Gather(static_cast<int>(runs.size()),
                                                                   IOProcNumber);
     std::vector<int> offset(countvec.size(),0);
+    Long nints = 0;
     if (ParallelDescriptor::IOProcessor()) {
+        nints = countvec[0];
         for (int i = 1, N = offset.size(); i < N; i++) {
             offset[i] = offset[i-1] + countvec[i-1];
+            nints += countvec[i];
+        }
+        if (nints > static_cast<Long>(std::numeric_limits<int>::max())) {
+            amrex::Abort("TagBoxArray::collate: Too many tags. Using a larger blocking factor might help. Please file an issue on github");
         }
     }
     //
-    // Gather all the tags to IOProcNumber into TheGlobalCollateSpace.
+    // Gather all the runs to IOProcNumber and expand them into TheGlobalCollateSpace.
     //
-    const IntVect* psend = (count > 0) ? TheLocalCollateSpace.data() : nullptr;
-    IntVect* precv = TheGlobalCollateSpace.data();
-    ParallelDescriptor::Gatherv(psend, count, precv, countvec, offset, IOProcNumber);
+    Vector<int> allruns(nints);
+    const int* psend = (runs.size() > 0) ? runs.data() : nullptr;
+    ParallelDescriptor::Gatherv(psend, static_cast<int>(runs.size()), allruns.data(),
+                                countvec, offset, IOProcNumber);
+
+    //
+    // On I/O proc. this holds all tags after they've been gather'd.
+    // On other procs. non-mempty signals size is not zero.
+    //
+    if (ParallelDescriptor::IOProcessor()) {
+        TheGlobalCollateSpace.resize(numtags);
+        decode_tag_runs(allruns.data(), nints, TheGlobalCollateSpace.data());
+    } else {
+        TheGlobalCollateSpace.resize(1);
+    }
 
 #else
     TheGlobalCollateSpace = std::move(TheLocalCollateSpace);
@@ -717,6 +854,23 @@ TagBoxArray::coarsen (const IntVect & ratio)
     n_grow = new_n_grow;
 }
 
+Long
+TagBoxArray::numTags (bool local) const
+{
+    Long ntags = 0;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion()) reduction(+:ntags)
+#endif
+    for (MFIter mfi(*this); mfi.isValid(); ++mfi)
+    {
+        ntags += (*this)[mfi].numTags(mfi.validbox());
+    }
+    if (!local) {
+        ParallelDescriptor::ReduceLongSum(ntags);
+    }
+    return ntags;
+}
+
 bool
 TagBoxArray::hasTags (Box const& a_bx) const
 {
@@ -0,0 +1,404 @@
+
+#include <AMReX_BatchReduce.H>
+#include <AMReX_BLProfiler.H>
+
+#ifdef AMREX_USE_OMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+namespace amrex {
+
+namespace {
+
+bool is_sum (BatchReduce::Kind kind) noexcept
+{
+    return kind == BatchReduce::Kind::Dot   || kind == BatchReduce::Kind::Norm1 ||
+           kind == BatchReduce::Kind::Norm2 || kind == BatchReduce::Kind::LocalSum;
+}
+
+bool is_local (BatchReduce::Kind kind) noexcept
+{
+    return kind == BatchReduce::Kind::LocalSum || kind == BatchReduce::Kind::LocalMax;
+}
+
+#ifdef BL_USE_MPI
+
+MPI_Op batch_reduce_op = MPI_OP_NULL;
+
+// The buffer is a single element of a contiguous type, so that MPI cannot
+// split it.  Its first value is the number of sums that follow it; the
+// rest are maxima.
+void batch_reduce_func (void* invec, void* inoutvec, int* len, MPI_Datatype* datatype)
+{
+    int nbytes;
+    MPI_Type_size(*datatype, &nbytes);
+    const int n = nbytes / static_cast<int>(sizeof(Real));
+    auto const* in = static_cast<Real const*>(invec);
+    auto* inout = static_cast<Real*>(inoutvec);
+    for (int m = 0; m < *len; ++m, in += n, inout += n) {
+        const int nsum = static_cast<int>(in[0]);
+        for (int i = 1; i <= nsum; ++i) {
+            inout[i] += in[i];
+        }
+        for (int i = nsum+1; i < n; ++i) {
+            inout[i] = std::max(inout[i], in[i]);
+        }
+    }
+}
+
+void free_batch_reduce_op ()
+{
+    if (batch_reduce_op != MPI_OP_NULL) {
+        MPI_Op_free(&batch_reduce_op);
+        batch_reduce_op = MPI_OP_NULL;
+    }
+}
+
+MPI_Op get_batch_reduce_op ()
+{
+    if (batch_reduce_op == MPI_OP_NULL) {
+        BL_MPI_REQUIRE( MPI_Op_create(batch_reduce_func, 1, &batch_reduce_op) );
+        amrex::ExecOnFinalize(free_batch_reduce_op);
+    }
+    return batch_reduce_op;
+}
+
+#endif
+
+}
+
+BatchReduce::~BatchReduce ()
+{
+#ifdef BL_USE_MPI
+    if (m_request != MPI_REQUEST_NULL) {
+        MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+    }
+#endif
+}
+
+int
+BatchReduce::addTerm (Term const& t)
+{
+#ifdef BL_USE_MPI
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_request == MPI_REQUEST_NULL,
+                                     "BatchReduce: reduction in progress");
+#endif
+    if (t.x) {
+        for (auto const& o : m_terms) {
+            if (o.x) {
+                AMREX_ALWAYS_ASSERT(o.x->boxArray() == t.x->boxArray() &&
+                                    o.x->DistributionMap() == t.x->DistributionMap());
+                break;
+            }
+        }
+        AMREX_ALWAYS_ASSERT(t.x->nGrow() >= t.nghost && t.xcomp+t.numcomp <= t.x->nComp());
+        if (t.y) {
+            AMREX_ALWAYS_ASSERT(t.y->boxArray() == t.x->boxArray() &&
+                                t.y->DistributionMap() == t.x->DistributionMap());
+            AMREX_ALWAYS_ASSERT(t.y->nGrow() >= t.nghost && t.ycomp+t.numcomp <= t.y->nComp());
+        }
+    }
+    m_terms.push_back(t);
+    m_done = false;
+    return m_terms.size()-1;
+}
+
+int
+BatchReduce::addDot (const MultiFab& x, int xcomp, const MultiFab& y, int ycomp,
+                     int numcomp, int nghost)
+{
+    return addTerm(Term{Kind::Dot, &x, xcomp, &y, ycomp, numcomp, nghost, Real(0.0)});
+}
+
+int
+BatchReduce::addNorm0 (const MultiFab& x, int comp, int numcomp, int nghost)
+{
+    return addTerm(Term{Kind::Norm0, &x, comp, nullptr, 0, numcomp, nghost, Real(0.0)});
+}
+
+int
+BatchReduce::addNorm1 (const MultiFab& x, int comp, int numcomp, int nghost)
+{
+    return addTerm(Term{Kind::Norm1, &x, comp, nullptr, 0, numcomp, nghost, Real(0.0)});
+}
+
+int
+BatchReduce::addNorm2 (const MultiFab& x, int comp, int numcomp, int nghost)
+{
+    return addTerm(Term{Kind::Norm2, &x, comp, nullptr, 0, numcomp, nghost, Real(0.0)});
+}
+
+int
+BatchReduce::addLocalSum (Real v)
+{
+    return addTerm(Term{Kind::LocalSum, nullptr, 0, nullptr, 0, 0, 0, v});
+}
+
+int
+BatchReduce::addLocalMax (Real v)
+{
+    return addTerm(Term{Kind::LocalMax, nullptr, 0, nullptr, 0, 0, 0, v});
+}
+
+void
+BatchReduce::clear ()
+{
+#ifdef BL_USE_MPI
+    if (m_request != MPI_REQUEST_NULL) {
+        MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+    }
+#endif
+    m_terms.clear();
+    m_done = false;
+}
+
+void
+BatchReduce::computeLocal ()
+{
+    BL_PROFILE("BatchReduce::computeLocal()");
+
+    const int nterms = m_terms.size();
+
+    // Position of each result in the buffer: the sums first, then the maxima
+    int nsum = 0;
+    for (auto const& t : m_terms) {
+        if (is_sum(t.kind)) { ++nsum; }
+    }
+    Vector<int> slot(nterms);
+    {
+        int isum = 1, imax = nsum+1;
+        for (int it = 0; it < nterms; ++it) {
+            slot[it] = is_sum(m_terms[it].kind) ? isum++ : imax++;
+        }
+    }
+
+    m_buffer.resize(nterms+1);
+    m_buffer[0] = static_cast<Real>(nsum);
+    for (int it = 0; it < nterms; ++it) {
+        auto const& t = m_terms[it];
+        m_buffer[slot[it]] = is_local(t.kind) ? t.value : Real(0.0);
+    }
+
+    Vector<int> mfterms;
+    int ngmax = 0;
+    for (int it = 0; it < nterms; ++it) {
+        if (!is_local(m_terms[it].kind)) {
+            mfterms.push_back(it);
+            ngmax = std::max(ngmax, m_terms[it].nghost);
+        }
+    }
+    if (mfterms.empty()) { return; }
+
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) {
+        for (int it : mfterms) {
+            auto const& t = m_terms[it];
+            Real& r = m_buffer[slot[it]];
+            switch (t.kind) {
+            case Kind::Dot:
+                r = MultiFab::Dot(*t.x, t.xcomp, *t.y, t.ycomp, t.numcomp, t.nghost, true);
+                break;
+            case Kind::Norm0:
+                r = t.x->norm0(t.xcomp, t.numcomp, IntVect(t.nghost), true);
+                break;
+            case Kind::Norm1:
+                r = Real(0.0);
+                for (int n = 0; n < t.numcomp; ++n) {
+                    r += t.x->norm1(t.xcomp+n, t.nghost, true);
+                }
+                break;
+            case Kind::Norm2:
+                r = MultiFab::Dot(*t.x, t.xcomp, t.numcomp, t.nghost, true);
+                break;
+            default:
+                break;
+            }
+        }
+        return;
+    }
+#endif
+
+    // One pass over the tiles.  In each tile, all the terms are computed
+    // on one row of cells before moving on to the next row, so that the
+    // MultiFabs shared by several terms are read from cache.
+    const MultiFab& mf0 = *m_terms[mfterms[0]].x;
+    const int nmf = mfterms.size();
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (!system::regtest_reduction)
+#endif
+    {
+        Vector<Real> priv(m_buffer.size(), Real(0.0));
+        Vector<Array4<Real const> > xa(nmf), ya(nmf);
+        Vector<Box> tbx(nmf);
+
+        for (MFIter mfi(mf0,true); mfi.isValid(); ++mfi)
+        {
+            for (int m = 0; m < nmf; ++m) {
+                auto const& t = m_terms[mfterms[m]];
+                xa[m] = t.x->const_array(mfi);
+                if (t.y) { ya[m] = t.y->const_array(mfi); }
+                tbx[m] = mfi.growntilebox(t.nghost);
+            }
+
+            const Box& gbx = mfi.growntilebox(ngmax);
+            const auto glo = amrex::lbound(gbx);
+            const auto ghi = amrex::ubound(gbx);
+            for (int k = glo.z; k <= ghi.z; ++k) {
+            for (int j = glo.y; j <= ghi.y; ++j) {
+                for (int m = 0; m < nmf; ++m) {
+                    auto const& t = m_terms[mfterms[m]];
+                    const auto lo = amrex::lbound(tbx[m]);
+                    const auto hi = amrex::ubound(tbx[m]);
+                    if (k < lo.z || k > hi.z || j < lo.y || j > hi.y) { continue; }
+                    auto const& x = xa[m];
+                    auto const& y = ya[m];
+                    const int nx = hi.x - lo.x + 1;
+                    Real r = priv[slot[mfterms[m]]];
+                    for (int n = 0; n < t.numcomp; ++n) {
+                        Real const* AMREX_RESTRICT xp = x.ptr(lo.x,j,k,t.xcomp+n);
+                        switch (t.kind) {
+                        case Kind::Dot: {
+                            Real const* AMREX_RESTRICT yp = y.ptr(lo.x,j,k,t.ycomp+n);
+                            for (int i = 0; i < nx; ++i) {
+                                r += xp[i] * yp[i];
+                            }
+                            break;
+                        }
+                        case Kind::Norm0:
+                            for (int i = 0; i < nx; ++i) {
+                                r = std::max(r, std::abs(xp[i]));
+                            }
+                            break;
+                        case Kind::Norm1:
+                            for (int i = 0; i < nx; ++i) {
+                                r += std::abs(xp[i]);
+                            }
+                            break;
+                        case Kind::Norm2:
+                            for (int i = 0; i < nx; ++i) {
+                                r += xp[i] * xp[i];
+                            }
+                            break;
+                        default:
+                            break;
+                        }
+                    }
+                    priv[slot[mfterms[m]]] = r;
+                }
+            }}
+        }
+
+#ifdef AMREX_USE_OMP
+#pragma omp critical (amrex_batchreduce)
+#endif
+        for (int m = 0; m < nmf; ++m) {
+            const int s = slot[mfterms[m]];
+            if (is_sum(m_terms[mfterms[m]].kind)) {
+                m_buffer[s] += priv[s];
+            } else {
+                m_buffer[s] = std::max(m_buffer[s], priv[s]);
+            }
+        }
+    }
+}
+
+void
+BatchReduce::finish ()
+{
+    const int nterms = m_terms.size();
+    int nsum = static_cast<int>(m_buffer[0]);
+    int isum = 1, imax = nsum+1;
+    m_result.resize(nterms);
+    for (int it = 0; it < nterms; ++it) {
+        auto const& t = m_terms[it];
+        const Real v = is_sum(t.kind) ? m_buffer[isum++] : m_buffer[imax++];
+        m_result[it] = (t.kind == Kind::Norm2) ? std::sqrt(v) : v;
+    }
+    m_done = true;
+}
+
+Vector<Real> const&
+BatchReduce::compute (bool local)
+{
+    BL_PROFILE("BatchReduce::compute()");
+
+    computeLocal();
+
+#ifdef BL_USE_MPI
+    if (!local && ParallelDescriptor::NProcs(m_comm) > 1) {
+        BL_PROFILE("BatchReduce::ParallelAllReduce");
+        MPI_Datatype dtype;
+        BL_MPI_REQUIRE( MPI_Type_contiguous(m_buffer.size(),
+                                            ParallelDescriptor::Mpi_typemap<Real>::type(),
+                                            &dtype) );
+        BL_MPI_REQUIRE( MPI_Type_commit(&dtype) );
+        BL_MPI_REQUIRE( MPI_Allreduce(MPI_IN_PLACE, m_buffer.data(), 1, dtype,
+                                      get_batch_reduce_op(), m_comm) );
+        BL_MPI_REQUIRE( MPI_Type_free(&dtype) );
+    }
+#else
+    amrex::ignore_unused(local);
+#endif
+
+    finish();
+    return m_result;
+}
+
+void
+BatchReduce::computeAsync ()
+{
+    BL_PROFILE("BatchReduce::computeAsync()");
+
+    computeLocal();
+    m_done = false;
+
+#ifdef BL_USE_MPI
+    if (ParallelDescriptor::NProcs(m_comm) > 1) {
+        MPI_Datatype dtype;
+        BL_MPI_REQUIRE( MPI_Type_contiguous(m_buffer.size(),
+                                            ParallelDescriptor::Mpi_typemap<Real>::type(),
+                                            &dtype) );
+        BL_MPI_REQUIRE( MPI_Type_commit(&dtype) );
+        BL_MPI_REQUIRE( MPI_Iallreduce(MPI_IN_PLACE, m_buffer.data(), 1, dtype,
+                                       get_batch_reduce_op(), m_comm, &m_request) );
+        // The pending reduction is not affected.
+        BL_MPI_REQUIRE( MPI_Type_free(&dtype) );
+        return;
+    }
+#endif
+
+    finish();
+}
+
+bool
+BatchReduce::test ()
+{
+#ifdef BL_USE_MPI
+    if (m_request != MPI_REQUEST_NULL) {
+        int flag = 0;
+        BL_MPI_REQUIRE( MPI_Test(&m_request, &flag, MPI_STATUS_IGNORE) );
+        if (flag) { finish(); }
+    }
+#endif
+    return m_done;
+}
+
+Vector<Real> const&
+BatchReduce::wait ()
+{
+    BL_PROFILE("BatchReduce::wait()");
+#ifdef BL_USE_MPI
+    if (m_request != MPI_REQUEST_NULL) {
+        BL_MPI_REQUIRE( MPI_Wait(&m_request, MPI_STATUS_IGNORE) );
+        finish();
+    }
+#endif
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_done, "BatchReduce::wait: nothing to wait for");
+    return m_result;
+}
+
+}
@@ -31,6 +31,7 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 int     FabArrayBase::MaxComp;
+bool    FabArrayBase::pool_fillpatch_patches;
 
 #if defined(AMREX_USE_GPU)
 
@@ -102,6 +103,7 @@ FabArrayBase::Initialize ()
     // Set default values here!!!
     //
     FabArrayBase::MaxComp           = 25;
+    FabArrayBase::pool_fillpatch_patches = true;
 
     ParmParse pp("fabarray");
 
@@ -118,6 +120,7 @@ FabArrayBase::Initialize ()
     }
 
     pp.queryAdd("maxcomp",             FabArrayBase::MaxComp);
+    pp.queryAdd("pool_fillpatch_patches", FabArrayBase::pool_fillpatch_patches);
 
     if (MaxComp < 1) {
         MaxComp = 1;
@@ -1954,6 +1957,8 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
 
 FabArrayBase::FPinfo::~FPinfo ()
 {
+    AMREX_ASSERT_WITH_MESSAGE(m_patch_busy.empty(),
+                              "FPinfo flushed while its pooled patches are in use");
 }
 
 Long
@@ -2031,6 +2036,7 @@ FabArrayBase::flushFPinfo (bool no_assertion)
     BL_ASSERT(no_assertion || getBDKey() == m_bdkey);
 
     std::vector<FPinfoCacheIter> others;
+    std::vector<FPinfo*> to_delete;
 
     std::pair<FPinfoCacheIter,FPinfoCacheIter> er_it = m_TheFillPatchCache.equal_range(m_bdkey);
 
@@ -2057,7 +2063,7 @@ FabArrayBase::flushFPinfo (bool no_assertion)
         m_FPinfo_stats.bytes -= it->second->bytes();
 #endif
         m_FPinfo_stats.recordErase(it->second->m_nuse);
-        delete it->second;
+        to_delete.push_back(it->second);
     }
 
     m_TheFillPatchCache.erase(er_it.first, er_it.second);
@@ -2067,6 +2073,27 @@ FabArrayBase::flushFPinfo (bool no_assertion)
     {
         m_TheFillPatchCache.erase(*it);
     }
+
+    // Deleted only after the cache is updated, because destroying the pooled
+    // patches flushes the caches of their own BoxArray and DistributionMapping.
+    for (FPinfo* fpc : to_delete) {
+        delete fpc;
+    }
+}
+
+void
+FabArrayBase::flushFPPatchPool ()
+{
+    // Moved out of the cache before they are destroyed, for the same reason
+    // as in flushFPinfo.
+    std::vector<std::unique_ptr<FabArrayBase> > patches;
+    for (auto const& kv : m_TheFillPatchCache) {
+        for (auto& p : kv.second->m_patch_pool) {
+            if (p.second.mf && ! p.second.busy) {
+                patches.push_back(std::move(p.second.mf));
+            }
+        }
+    }
 }
 
 FabArrayBase::CFinfo::CFinfo (const FabArrayBase& finefa,
@@ -2204,6 +2231,7 @@ FabArrayBase::flushCFinfo (bool no_assertion)
 void
 FabArrayBase::Finalize ()
 {
+    FabArrayBase::flushFPPatchPool();
     FabArrayBase::flushFBCache();
     FabArrayBase::flushCPCache();
     FabArrayBase::flushRB90Cache();
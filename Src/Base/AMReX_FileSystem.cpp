@@ -61,6 +61,20 @@ RemoveAll (std::string const& p)
     return !ec;
 }
 
+std::vector<std::string>
+ListFiles (std::string const& dir)
+{
+    std::vector<std::string> r;
+    std::error_code ec;
+    std::filesystem::path root{dir};
+    for (auto const& entry : std::filesystem::recursive_directory_iterator(root, ec)) {
+        if (entry.is_regular_file()) {
+            r.push_back(entry.path().lexically_relative(root).generic_string());
+        }
+    }
+    return r;
+}
+
 }}
 
 #else
@@ -72,6 +86,7 @@ RemoveAll (std::string const& p)
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <dirent.h>
 
 namespace amrex {
 namespace FileSystem {
@@ -208,6 +223,36 @@ RemoveAll (std::string const& p)
     return true;
 }
 
+namespace {
+void list_files (std::string const& root, std::string const& rel, std::vector<std::string>& r)
+{
+    const std::string path = rel.empty() ? root : root + "/" + rel;
+    DIR* d = opendir(path.c_str());
+    if (d == nullptr) return;
+    while (struct dirent* e = readdir(d)) {
+        const std::string name(e->d_name);
+        if (name == "." || name == "..") continue;
+        const std::string relname = rel.empty() ? name : rel + "/" + name;
+        struct stat statbuff;
+        if (stat((root + "/" + relname).c_str(), &statbuff) != 0) continue;
+        if (S_ISDIR(statbuff.st_mode)) {
+            list_files(root, relname, r);
+        } else if (S_ISREG(statbuff.st_mode)) {
+            r.push_back(relname);
+        }
+    }
+    closedir(d);
+}
+}
+
+std::vector<std::string>
+ListFiles (std::string const& dir)
+{
+    std::vector<std::string> r;
+    list_files(dir, std::string(), r);
+    return r;
+}
+
 }}
 
 #endif
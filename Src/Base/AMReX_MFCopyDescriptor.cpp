@@ -105,6 +105,21 @@ InterpFillFab (MultiFabCopyDescriptor& fabCopyDesc,
     {
         BL_ASSERT(dest_comp + num_comp <= dest.nComp());
 
+        if (src_comp == dest_comp && !amrex::almostEqual(t1,t2))
+        {
+            // Interpolate in time straight from the source fabs.  Like the
+            // temporaries below, the cells no source covers are set to NaN.
+            const Real alpha = (t2-t)/(t2-t1);
+            const Real beta = (t-t1)/(t2-t1);
+            dest.setVal<RunOn::Host>(std::numeric_limits<Real>::quiet_NaN(),
+                                     dest.box(), dest_comp, num_comp);
+            if (fabCopyDesc.FillFabLinComb(faid1, fillBoxIds[0], alpha,
+                                           faid2, fillBoxIds[1], beta, dest))
+            {
+                return;
+            }
+        }
+
         FArrayBox dest1(dest.box(), dest.nComp());
         dest1.setVal<RunOn::Host>(std::numeric_limits<Real>::quiet_NaN());
         FArrayBox dest2(dest.box(), dest.nComp());
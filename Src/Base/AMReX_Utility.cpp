@@ -13,6 +13,7 @@
 #include <omp.h>
 #endif
 
+#include <array>
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
@@ -251,6 +252,44 @@ amrex::UtilRenameDirectoryToOld (const std::string &path, bool callbarrier)
   }
 }
 
+std::uint32_t
+amrex::CRC32 (const void* data, std::size_t nbytes, std::uint32_t crc) noexcept
+{
+    //
+    // Slicing-by-8: eight bytes per step through eight tables.
+    //
+    static const auto table = [] () {
+        std::array<std::array<std::uint32_t,256>,8> t{};
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1U) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1);
+            }
+            t[0][n] = c;
+        }
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            for (int k = 1; k < 8; ++k) {
+                t[k][n] = t[0][t[k-1][n] & 0xFFU] ^ (t[k-1][n] >> 8);
+            }
+        }
+        return t;
+    }();
+
+    auto const* p = static_cast<unsigned char const*>(data);
+    crc = ~crc;
+    for ( ; nbytes >= 8; nbytes -= 8, p += 8) {
+        const std::uint32_t lo = crc ^ (std::uint32_t(p[0])       | (std::uint32_t(p[1]) <<  8) |
+                                        (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24));
+        crc = table[7][ lo        & 0xFFU] ^ table[6][(lo >>  8) & 0xFFU]
+            ^ table[5][(lo >> 16) & 0xFFU] ^ table[4][ lo >> 24        ]
+            ^ table[3][p[4]] ^ table[2][p[5]] ^ table[1][p[6]] ^ table[0][p[7]];
+    }
+    for ( ; nbytes > 0; --nbytes, ++p) {
+        crc = table[0][(crc ^ *p) & 0xFFU] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
 void
 amrex::OutOfMemory ()
 {
@@ -8,6 +8,7 @@
 #include <cerrno>
 #include <cstdio>
 #include <limits>
+#include <tuple>
 
 namespace amrex {
 
@@ -28,6 +29,8 @@ bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
 bool VisMF::allowSparseWrites(true);
+bool VisMF::checksums(false);
+bool VisMF::verifyChecksums(true);
 
 Long VisMFBuffer::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -76,6 +79,8 @@ VisMF::Initialize ()
     pp.queryAdd("usedynamicsetselection", useDynamicSetSelection);
     pp.queryAdd("iobuffersize", ioBufferSize);
     pp.queryAdd("allowsparsewrites", allowSparseWrites);
+    pp.queryAdd("checksums", checksums);
+    pp.queryAdd("verifychecksums", verifyChecksums);
 
     initialized = true;
 }
@@ -306,6 +311,15 @@ operator<< (std::ostream        &os,
       }
     }
 
+    if( ! hd.m_checksum.empty()) {
+      // ---- optional, after everything older readers look for
+      BL_ASSERT(hd.m_checksum.size() == hd.m_ba.size());
+      os << "Checksums_CRC32\n" << hd.m_writtenRD << '\n' << hd.m_checksum.size() << '\n';
+      for(auto crc : hd.m_checksum) {
+        os << crc << '\n';
+      }
+    }
+
     os.flags(oflags);
     os.precision(oldPrec);
 
@@ -395,6 +409,26 @@ operator>> (std::istream  &is,
         amrex::Error("Read of VisMF::Header failed");
     }
 
+    is >> std::ws;
+    if(is.peek() == 'C') {
+      std::string tag;
+      Long N;
+      is >> tag >> hd.m_writtenRD >> N;
+      if(tag != "Checksums_CRC32" || N != hd.m_ba.size()) {
+        amrex::Error("Read of VisMF::Header checksums failed");
+      }
+      hd.m_checksum.resize(N);
+      for(Long i(0); i < N; ++i) {
+        is >> hd.m_checksum[i];
+      }
+      if(is.fail()) {
+        amrex::Error("Read of VisMF::Header checksums failed");
+      }
+    }
+    if(is.eof()) {
+      is.clear();
+    }
+
     return is;
 }
 
@@ -983,6 +1017,11 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     } else if(useDynamicSetSelection) {
         nfi.SetDynamic();
     }
+    LayoutData<std::uint32_t> checksum;
+    if(checksums) {
+        checksum.define(mf.boxArray(), mf.DistributionMap());
+    }
+
     for( ; nfi.ReadyToWrite(); ++nfi) {
         // ---- find the total number of bytes including fab headers if needed
         const FABio &fio = FArrayBox::getFABio();
@@ -1043,6 +1082,9 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
                 } else {    // ---- copy from the fab
                     memcpy(afPtr + hLength, fabdata, writeDataSize);
                 }
+                if(checksums) {
+                    checksum[mfi] = amrex::CRC32(afPtr + hLength, writeDataSize);
+                }
                 writePosition += hLength + writeDataSize;
             }
             nfi.Stream().write(allFabData, bytesWritten);
@@ -1082,10 +1124,16 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
                                                             fabdata, *whichRD);
                     nfi.Stream().write(cDataPtr, writeDataSize);
                     nfi.Stream().flush();
+                    if(checksums) {
+                        checksum[mfi] = amrex::CRC32(cDataPtr, writeDataSize);
+                    }
                     delete [] cDataPtr;
                 } else {    // ---- copy from the fab
                     nfi.Stream().write((char *) fabdata, writeDataSize);
                     nfi.Stream().flush();
+                    if(checksums) {
+                        checksum[mfi] = amrex::CRC32(fabdata, writeDataSize);
+                    }
                 }
             }
         }
@@ -1104,6 +1152,11 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
                        ParallelDescriptor::Communicator());
 
+    if(checksums) {
+        ParallelDescriptor::GatherLayoutDataToVector(checksum, hdr.m_checksum, coordinatorProc);
+        hdr.m_writtenRD = *whichRD;
+    }
+
     bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
 
     return bytesWritten;
@@ -1431,6 +1484,10 @@ VisMF::readFAB (int                  idx,
 
     VisMF::CloseStream(FullName);
 
+    if(whichComp == -1) {
+      VisMF::checkFAB(*fab, idx, mf_name, hdr);
+    }
+
     return fab;
 }
 
@@ -1477,6 +1534,45 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     }
 
     VisMF::CloseStream(FullName);
+
+    VisMF::checkFAB(fab, idx, mf_name, hdr);
+}
+
+void
+VisMF::checkFAB (const FArrayBox &fab, int idx, const std::string &mf_name, const Header &hdr)
+{
+    if( ! verifyChecksums || hdr.m_checksum.empty()) {
+      return;
+    }
+
+    const Real* fabdata = fab.dataPtr();
+#ifdef AMREX_USE_GPU
+    std::unique_ptr<FArrayBox> hostfab;
+    if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+        hostfab = std::make_unique<FArrayBox>(fab.box(), fab.nComp(), The_Pinned_Arena());
+        Gpu::dtoh_memcpy_async(hostfab->dataPtr(), fab.dataPtr(), fab.size()*sizeof(Real));
+        Gpu::streamSynchronize();
+        fabdata = hostfab->dataPtr();
+    }
+#endif
+
+    // ---- the checksum is of the data as written
+    std::uint32_t crc;
+    if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
+      crc = amrex::CRC32(fabdata, fab.nBytes());
+    } else {
+      Long nItems(fab.box().numPts() * fab.nComp());
+      Vector<char> cData(nItems * hdr.m_writtenRD.numBytes());
+      RealDescriptor::convertFromNativeFormat(cData.dataPtr(), nItems, fabdata, hdr.m_writtenRD);
+      crc = amrex::CRC32(cData.dataPtr(), cData.size());
+    }
+
+    if(crc != hdr.m_checksum[idx]) {
+      amrex::ErrorStream() << "**** Error:  checksum mismatch reading FAB " << idx << " of " << mf_name
+                           << " from " << hdr.m_fod[idx].m_name << " at offset " << hdr.m_fod[idx].m_head
+                           << std::endl;
+      amrex::Abort("VisMF::Read:  corrupted data in " + mf_name);
+    }
 }
 
 
@@ -1560,7 +1656,7 @@ VisMF::Read (FabArray<FArrayBox> &mf,
     for(int i(0); i < nBoxes; ++i) {   // ---- create the map
       int undefined(-1);
       std::string fname(hdr.m_fod[i].m_name);
-      FileReadChains[fname].push_back(FabReadLink(undefined, undefined, hdr.m_fod[i].m_head, hdr.m_ba[i]));
+      FileReadChains[fname].push_back(FabReadLink(undefined, i, hdr.m_fod[i].m_head, hdr.m_ba[i]));
     }
 
     std::map<std::string, Vector<FabReadLink> >::iterator frcIter;
@@ -1571,6 +1667,7 @@ VisMF::Read (FabArray<FArrayBox> &mf,
     BoxArray baFileOrder(hdr.m_ba.size());
 
     Vector<int> ranksFileOrder(mf.DistributionMap().size(), -1);
+    Vector<int> hdrIndexFileOrder(nBoxes, -1);
 
     Vector<int> nRanksPerFile(FileReadChains.size());
     amrex::NItemsPerBin(nProcs, nRanksPerFile);
@@ -1592,6 +1689,7 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 
           baFileOrder.set(indexFileOrder, frc[frcIndex].box);
           ranksFileOrder[indexFileOrder] = currentRank;
+          hdrIndexFileOrder[indexFileOrder] = frc[frcIndex].faIndex;
           frc[frcIndex].rankToRead = currentRank;
           frc[frcIndex].faIndex    = indexFileOrder;
           readFileRanks[fileName].insert(currentRank);
@@ -1775,6 +1873,12 @@ VisMF::Read (FabArray<FArrayBox> &mf,
       }
     }
 
+    if(verifyChecksums && ! hdr.m_checksum.empty()) {
+      for(MFIter mfi(whichFA); mfi.isValid(); ++mfi) {
+        VisMF::checkFAB(whichFA[mfi], hdrIndexFileOrder[mfi.index()], mf_name, hdr);
+      }
+    }
+
     if( ! inFileOrder) {
       faCopyTime = amrex::second();
       mf.ParallelCopy(fafabFileOrder);
@@ -1970,6 +2074,155 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 }
 
 
+void
+VisMF::ReadRedistribute (FabArray<FArrayBox> &mf,
+                         const std::string   &mf_name,
+                         const char *faHeader)
+{
+    BL_PROFILE("VisMF::ReadRedistribute()");
+
+    BL_ASSERT(mf.ok());
+
+    VisMF::Header hdr;
+    double startTime(amrex::second());
+    int myProc(ParallelDescriptor::MyProc());
+
+    {
+        std::string fileCharPtrString;
+        if(faHeader == nullptr) {
+          Vector<char> fileCharPtr;
+          ParallelDescriptor::ReadAndBcastFile(mf_name + TheMultiFabHdrFileSuffix, fileCharPtr);
+          fileCharPtrString = fileCharPtr.dataPtr();
+        } else {
+          fileCharPtrString = faHeader;
+        }
+        std::istringstream infs(fileCharPtrString, std::istringstream::in);
+
+        infs >> hdr;
+    }
+
+    if (hdr.m_ba.size() == 0)
+    {
+        amrex::Print() << "In trying to read " << mf_name << std::endl;
+        amrex::Error("Empty box array");
+    }
+    AMREX_ALWAYS_ASSERT(hdr.m_ncomp == mf.nComp());
+
+    const int nBoxes(hdr.m_ba.size());
+    FabArray<FArrayBox> fafabFileOrder;
+
+#ifdef BL_USE_MPI
+    const int nProcs(ParallelDescriptor::NProcs());
+    const bool noFabHeader(NoFabHeader(hdr));
+    // ---- with FAB headers the real format is in each FAB header
+    const Long bytesPerCell(hdr.m_ncomp * (noFabHeader ? hdr.m_writtenRD.numBytes()
+                                                       : static_cast<int>(sizeof(Real))));
+
+    // ---- the FABs of each file in file order
+    std::map<std::string, Vector<FabReadLink> > FileReadChains;        // ---- [filename, chain]
+    Long totalBytes(0);
+    for(int i(0); i < nBoxes; ++i) {
+      const Box fab_box(amrex::grow(hdr.m_ba[i], hdr.m_ngrow));
+      FileReadChains[hdr.m_fod[i].m_name].push_back(FabReadLink(-1, i, hdr.m_fod[i].m_head, fab_box));
+      totalBytes += fab_box.numPts() * bytesPerCell;
+    }
+
+    // ---- each rank reads a contiguous range of about totalBytes/nProcs bytes
+    Vector<int> ranksFileOrder(nBoxes, -1);
+    std::map<std::string, Vector<int> > readFileRanks;                // ---- [filename, ranks]
+    Long currentBytes(0);
+    for(auto &frcPair : FileReadChains) {
+      Vector<FabReadLink> &frc = frcPair.second;
+      std::sort(frc.begin(), frc.end(), [] (const FabReadLink &a, const FabReadLink &b)
+                                              { return a.fileOffset < b.fileOffset; } );
+      Vector<int> &ranks = readFileRanks[frcPair.first];
+      for(auto &frl : frc) {
+        int rank(static_cast<int>(static_cast<double>(currentBytes) / static_cast<double>(totalBytes)
+                                  * static_cast<double>(nProcs)));
+        rank = std::min(rank, nProcs - 1);
+        frl.rankToRead = rank;
+        ranksFileOrder[frl.faIndex] = rank;
+        if(ranks.empty() || ranks.back() != rank) {
+          ranks.push_back(rank);
+        }
+        currentBytes += frl.box.numPts() * bytesPerCell;
+      }
+    }
+
+    // ---- host memory, so the data can be read in place
+    fafabFileOrder.define(hdr.m_ba, DistributionMapping(std::move(ranksFileOrder)),
+                          hdr.m_ncomp, hdr.m_ngrow, MFInfo().SetArena(The_Pinned_Arena()),
+                          FArrayBoxFactory());
+
+    const bool doConvert(noFabHeader && hdr.m_writtenRD != FPC::NativeRealDescriptor());
+
+    for(auto const &frcPair : FileReadChains) {
+      const Vector<int> &ranks = readFileRanks[frcPair.first];
+      auto rit = std::find(ranks.begin(), ranks.end(), myProc);
+      if(rit == ranks.end()) {
+        continue;
+      }
+
+      // ---- the readers of a file are split into at most nMFFileInStreams
+      // ---- chains of consecutive ranks that read one after another
+      const int nRanks(ranks.size());
+      const int nStreams(std::min(nRanks, nMFFileInStreams));
+      const int myStream(static_cast<int>(rit - ranks.begin()) * nStreams / nRanks);
+      Vector<int> readRanks;
+      for(int j(0); j < nRanks; ++j) {
+        if(j * nStreams / nRanks == myStream) {
+          readRanks.push_back(ranks[j]);
+        }
+      }
+
+      std::string fullFileName(VisMF::DirName(mf_name) + frcPair.first);
+      for(NFilesIter nfi(fullFileName, readRanks, setBuf); nfi.ReadyToRead(); ++nfi) {
+        for(auto const &frl : frcPair.second) {
+          if(frl.rankToRead != myProc) {
+            continue;
+          }
+          if(static_cast<std::streamoff>(nfi.SeekPos()) != frl.fileOffset) {
+            nfi.Stream().seekp(frl.fileOffset, std::ios::beg);
+          }
+          FArrayBox &fab = fafabFileOrder[frl.faIndex];
+          if( ! noFabHeader) {
+            fab.readFrom(nfi.Stream());
+          } else if(doConvert) {
+            RealDescriptor::convertToNativeFormat(fab.dataPtr(), fab.box().numPts() * fab.nComp(),
+                                                  nfi.Stream(), hdr.m_writtenRD);
+          } else {
+            nfi.Stream().read((char *) fab.dataPtr(), fab.nBytes());
+          }
+          VisMF::checkFAB(fab, frl.faIndex, mf_name, hdr);
+        }
+      }
+    }
+#else
+    fafabFileOrder.define(hdr.m_ba, DistributionMapping(hdr.m_ba), hdr.m_ncomp, hdr.m_ngrow,
+                          MFInfo(), FArrayBoxFactory());
+    VisMF::Read(fafabFileOrder, mf_name, faHeader);
+#endif
+
+    double faCopyTime(amrex::second());
+    //
+    // Valid data on disk wins.  Ghost cells of mf outside the valid region
+    // on disk get the ghost data on disk.
+    //
+    const IntVect dst_ngrow(mf.nGrowVect());
+    if(hdr.m_ngrow.max() > 0 && dst_ngrow.max() > 0) {
+      mf.ParallelCopy(fafabFileOrder, 0, 0, hdr.m_ncomp, hdr.m_ngrow, dst_ngrow);
+    }
+    mf.ParallelCopy(fafabFileOrder, 0, 0, hdr.m_ncomp, IntVect(0), dst_ngrow);
+    faCopyTime = amrex::second() - faCopyTime;
+
+    if(myProc == ParallelDescriptor::IOProcessorNumber() && verbose) {
+      amrex::AllPrint() << "FAReadRedistribute ::  nBoxes = " << nBoxes << '\n'
+                        << "FAReadRedistribute ::  faCopyTime = " << faCopyTime << '\n'
+                        << "FAReadRedistribute ::  mfReadTime = " << (amrex::second() - startTime)
+                        << std::endl;
+    }
+}
+
 bool
 VisMF::Exist (const std::string& mf_name)
 {
@@ -2100,6 +2353,73 @@ VisMF::Check (const std::string& mf_name)
 }
 
 
+Long
+VisMF::VerifyChecksums (const std::string& mf_name)
+{
+    BL_PROFILE("VisMF::VerifyChecksums()");
+
+    VisMF::Header hdr;
+    {
+        Vector<char> fileCharPtr;
+        ParallelDescriptor::ReadAndBcastFile(mf_name + TheMultiFabHdrFileSuffix, fileCharPtr);
+        std::string fileCharPtrString(fileCharPtr.dataPtr());
+        std::istringstream infs(fileCharPtrString, std::istringstream::in);
+        infs >> hdr;
+    }
+
+    if(hdr.m_checksum.empty()) {
+      return -1;
+    }
+
+    // ---- each rank checks a contiguous range of the FABs in file order
+    const int nBoxes(hdr.m_ba.size());
+    Vector<int> fileOrder(nBoxes);
+    std::iota(fileOrder.begin(), fileOrder.end(), 0);
+    std::sort(fileOrder.begin(), fileOrder.end(), [&hdr] (int a, int b)
+              { return std::tie(hdr.m_fod[a].m_name, hdr.m_fod[a].m_head)
+                     < std::tie(hdr.m_fod[b].m_name, hdr.m_fod[b].m_head); } );
+
+    const int myProc(ParallelDescriptor::MyProc());
+    const int nProcs(ParallelDescriptor::NProcs());
+    const int iBegin(static_cast<int>(Long(nBoxes) *  myProc      / nProcs));
+    const int iEnd  (static_cast<int>(Long(nBoxes) * (myProc + 1) / nProcs));
+    const Long bytesPerCell(hdr.m_ncomp * hdr.m_writtenRD.numBytes());
+
+    Long nBad(0);
+    std::ifstream ifs;
+    std::string openFileName;
+    Vector<char> fabData;
+    for(int j(iBegin); j < iEnd; ++j) {
+      const int i(fileOrder[j]);
+      const FabOnDisk &fod = hdr.m_fod[i];
+      std::string FullName(VisMF::DirName(mf_name) + fod.m_name);
+      if(FullName != openFileName) {
+        ifs.close();
+        ifs.open(FullName.c_str(), std::ios::in | std::ios::binary);
+        openFileName = FullName;
+      }
+      ifs.clear();
+      ifs.seekg(fod.m_head, std::ios::beg);
+      if( ! NoFabHeader(hdr)) {    // ---- skip the fab header
+        ifs.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      }
+      fabData.resize(amrex::grow(hdr.m_ba[i], hdr.m_ngrow).numPts() * bytesPerCell);
+      ifs.read(fabData.dataPtr(), fabData.size());
+      if( ! ifs.good() || amrex::CRC32(fabData.dataPtr(), fabData.size()) != hdr.m_checksum[i]) {
+        ++nBad;
+        if(verbose) {
+          amrex::AllPrint() << "**** Error:  checksum mismatch for FAB " << i << " of " << mf_name
+                            << " in " << fod.m_name << " at offset " << fod.m_head << std::endl;
+        }
+      }
+    }
+
+    ParallelDescriptor::ReduceLongSum(nBad);
+
+    return nBad;
+}
+
+
 void
 VisMF::clear (int fabIndex)
 {
@@ -12,8 +12,13 @@
 #include <AMReX_EB2.H>
 #include <AMReX_EB2_IndexSpace_STL.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
 #include <AMReX.H>
 #include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
 
 namespace amrex { namespace EB2 {
 
@@ -72,11 +77,74 @@ const IndexSpace* TopIndexSpaceIfPresent() noexcept {
     return nullptr;
 }
 
+namespace {
+// The key of eb2.chkpt_file: a CRC-32 of the eb2 parameters and of the STL
+// file, if there is one.
+std::string chkpt_file_key ()
+{
+    // Add the defaults the build would add, so that the key does not depend on
+    // whether the geometry has been built before.
+    {
+        Real small_volfrac;
+        bool cover_multiple_cuts;
+        int maxiter;
+        queryFineLevelParams(small_volfrac, cover_multiple_cuts, maxiter);
+    }
+
+    std::uint32_t crc = 0;
+    ParmParse ppall;
+    for (auto const& name : ParmParse::getEntries("eb2")) {
+        if (name == "eb2.chkpt_file") continue;
+        std::vector<std::string> vals;
+        ppall.queryarr(name.c_str(), vals);
+        crc = amrex::CRC32(name.data(), name.size(), crc);
+        for (auto const& v : vals) {
+            crc = amrex::CRC32(" ", 1, crc);
+            crc = amrex::CRC32(v.data(), v.size(), crc);
+        }
+        crc = amrex::CRC32("\n", 1, crc);
+    }
+
+    std::string stl_file;
+    ParmParse pp("eb2");
+    if (pp.query("stl_file", stl_file)) {
+        Long stl_crc = -1;
+        if (ParallelDescriptor::IOProcessor()) {
+            std::ifstream ifs(stl_file, std::ios::in | std::ios::binary);
+            if (ifs.good()) {
+                std::vector<char> buf((std::istreambuf_iterator<char>(ifs)),
+                                      std::istreambuf_iterator<char>());
+                stl_crc = amrex::CRC32(buf.data(), buf.size());
+            }
+        }
+        ParallelDescriptor::Bcast(&stl_crc, 1, ParallelDescriptor::IOProcessorNumber());
+        crc = amrex::CRC32(&stl_crc, sizeof(stl_crc), crc);
+    }
+
+    std::ostringstream os;
+    os << std::hex << std::setw(8) << std::setfill('0') << crc;
+    return os.str();
+}
+}
+
 void
 Build (const Geometry& geom, int required_coarsening_level,
        int max_coarsening_level, int ngrow, bool build_coarse_level_by_coarsening)
 {
     ParmParse pp("eb2");
+
+    std::string chkpt_file;
+    std::string chkpt_key;
+    pp.query("chkpt_file", chkpt_file);
+    if (!chkpt_file.empty()) {
+        chkpt_key = chkpt_file_key();
+        if (BuildFromChkptFile(chkpt_file, chkpt_key, geom, required_coarsening_level,
+                               max_coarsening_level, ngrow, build_coarse_level_by_coarsening,
+                               extend_domain_face)) {
+            return;
+        }
+    }
+
     std::string geom_type;
     pp.get("geom_type", geom_type);
 
@@ -212,6 +280,10 @@ Build (const Geometry& geom, int required_coarsening_level,
     {
         amrex::Abort("geom_type "+geom_type+ " not supported");
     }
+
+    if (!chkpt_file.empty()) {
+        IndexSpace::top().writeChkptFile(chkpt_file, chkpt_key);
+    }
 }
 
 namespace {
@@ -19,6 +19,10 @@ IndexSpaceSTL::IndexSpaceSTL (const std::string& stl_file, Real stl_scale,
     max_coarsening_level = std::max(required_coarsening_level,max_coarsening_level);
     max_coarsening_level = std::min(30,max_coarsening_level);
 
+    m_build_params = BuildParams{required_coarsening_level, max_coarsening_level, ngrow,
+                                 build_coarse_level_by_coarsening, extend_domain_face,
+                                 EB2::max_grid_size};
+
     int ngrow_finest = std::max(ngrow,0);
     for (int i = 1; i <= required_coarsening_level; ++i) {
         ngrow_finest *= 2;
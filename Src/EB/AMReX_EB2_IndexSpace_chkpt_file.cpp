@@ -0,0 +1,151 @@
+
+#include <AMReX_EB2_IndexSpace_chkpt_file.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_Utility.H>
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace amrex { namespace EB2 {
+
+namespace {
+    // Everything in the Header of the checkpoint directory except the
+    // number of levels.  The directory can only be used if this matches.
+    std::string chkptIdentity (const std::string& key, const Geometry& geom,
+                               const IndexSpace::BuildParams& params)
+    {
+        std::ostringstream os;
+        os << std::setprecision(std::numeric_limits<Real>::max_digits10);
+        os << "EB2_IndexSpace_CHKPT_V1\n"
+           << key << "\n"
+           << params.required_coarsening_level << " "
+           << params.max_coarsening_level << " "
+           << params.ngrow << " "
+           << params.build_coarse_level_by_coarsening << " "
+           << params.extend_domain_face << " "
+           << params.max_grid_size << "\n"
+           << geom.Domain() << "\n"
+           << geom.Coord() << "\n";
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            os << geom.ProbLo(idim) << " " << geom.ProbHi(idim) << " "
+               << geom.isPeriodic(idim) << "\n";
+        }
+        return os.str();
+    }
+
+    std::string levelDirName (const std::string& dirname, int ilev)
+    {
+        return dirname + "/Level_" + std::to_string(ilev);
+    }
+}
+
+void
+IndexSpace::writeChkptFile (const std::string& dirname, const std::string& key) const
+{
+    BL_PROFILE("EB2::IndexSpace::writeChkptFile()");
+
+    const int nlevels = numLevels();
+
+    if (ParallelDescriptor::IOProcessor()) {
+        if (amrex::FileExists(dirname)) {
+            amrex::FileSystem::RemoveAll(dirname);
+        }
+        for (int ilev = 0; ilev < nlevels; ++ilev) {
+            if (!amrex::UtilCreateDirectory(levelDirName(dirname,ilev), 0755)) {
+                amrex::CreateDirectoryFailed(levelDirName(dirname,ilev));
+            }
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    for (int ilev = 0; ilev < nlevels; ++ilev) {
+        getLevel(ilev).writeChkptFile(levelDirName(dirname,ilev));
+    }
+
+    // The Header is written last so that an incomplete directory is never used.
+    ParallelDescriptor::Barrier();
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream os(dirname + "/Header");
+        os << chkptIdentity(key, getLevel(0).Geom(), m_build_params)
+           << nlevels << "\n";
+        if (!os.good()) {
+            amrex::FileOpenFailed(dirname + "/Header");
+        }
+    }
+}
+
+IndexSpaceChkptFile::IndexSpaceChkptFile (const std::string& dirname, int nlevels,
+                                          const Geometry& geom, const BuildParams& params)
+{
+    m_build_params = params;
+
+    m_chkptlevel.reserve(nlevels);
+    for (int ilev = 0; ilev < nlevels; ++ilev) {
+        const Geometry& lgeom = (ilev == 0) ? geom : amrex::coarsen(m_geom.back(),2);
+        m_geom.push_back(lgeom);
+        m_domain.push_back(lgeom.Domain());
+        m_chkptlevel.emplace_back(this, lgeom, levelDirName(dirname,ilev));
+    }
+}
+
+const Level&
+IndexSpaceChkptFile::getLevel (const Geometry& geom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), geom.Domain());
+    int i = std::distance(m_domain.begin(), it);
+    return m_chkptlevel[i];
+}
+
+const Geometry&
+IndexSpaceChkptFile::getGeometry (const Box& dom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), dom);
+    int i = std::distance(m_domain.begin(), it);
+    return m_geom[i];
+}
+
+bool
+BuildFromChkptFile (const std::string& dirname, const std::string& key,
+                    const Geometry& geom, int required_coarsening_level,
+                    int max_coarsening_level, int ngrow,
+                    bool build_coarse_level_by_coarsening, bool extend_domain_face)
+{
+    BL_PROFILE("EB2::BuildFromChkptFile()");
+
+    max_coarsening_level = std::max(required_coarsening_level,max_coarsening_level);
+    max_coarsening_level = std::min(30,max_coarsening_level);
+    const IndexSpace::BuildParams params{required_coarsening_level, max_coarsening_level,
+                                         ngrow, build_coarse_level_by_coarsening,
+                                         extend_domain_face, EB2::max_grid_size};
+
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(dirname + "/Header", buf, false);
+    if (buf.empty() || buf[0] == '\0') { return false; }
+
+    const std::string header(buf.dataPtr());
+    const std::string identity = chkptIdentity(key, geom, params);
+    if (header.compare(0, identity.size(), identity) != 0) {
+        if (amrex::Verbose()) {
+            amrex::Print() << "EB2::BuildFromChkptFile: " << dirname
+                           << " was written for a different geometry or parameters\n";
+        }
+        return false;
+    }
+
+    int nlevels = 0;
+    std::istringstream is(header.substr(identity.size()));
+    is >> nlevels;
+    if (!is || nlevels < 1) { return false; }
+
+    IndexSpace::push(new IndexSpaceChkptFile(dirname, nlevels, geom, params));
+
+    if (amrex::Verbose()) {
+        amrex::Print() << "EB2::BuildFromChkptFile: read " << nlevels
+                       << " levels from " << dirname << "\n";
+    }
+    return true;
+}
+
+}}
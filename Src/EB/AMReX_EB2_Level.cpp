@@ -2,9 +2,27 @@
 #include <AMReX_EB2_Level.H>
 #include <AMReX_IArrayBox.H>
 #include <algorithm>
+#include <fstream>
 
 namespace amrex { namespace EB2 {
 
+void
+queryFineLevelParams (Real& small_volfrac, bool& cover_multiple_cuts, int& maxiter)
+{
+#ifdef AMREX_USE_FLOAT
+    small_volfrac = 1.e-5_rt;
+#else
+    small_volfrac = 1.e-14;
+#endif
+    cover_multiple_cuts = false;
+    maxiter = 32;
+
+    ParmParse pp("eb2");
+    pp.queryAdd("small_volfrac", small_volfrac);
+    pp.queryAdd("cover_multiple_cuts", cover_multiple_cuts);
+    pp.queryAdd("maxiter", maxiter);
+}
+
 void
 Level::prepareForCoarsening (const Level& rhs, int max_grid_size, IntVect ngrow)
 {
@@ -916,4 +934,56 @@ Level::fillLevelSet (MultiFab& levelset, const Geometry& geom) const
     }
 }
 
+void
+Level::writeChkptFile (const std::string& dirname) const
+{
+    BL_PROFILE("EB2::Level::writeChkptFile()");
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream os(dirname + "/Header");
+        os << m_allregular << " " << m_ok << "\n"
+           << m_ngrow << "\n";
+        // BoxArray::readFrom cannot read an empty BoxArray.
+        for (BoxArray const* ba : {&m_grids, &m_covered_grids}) {
+            os << ba->size() << "\n";
+            if (!ba->empty()) {
+                ba->writeOn(os);
+                os << "\n";
+            }
+        }
+        if (!os.good()) {
+            amrex::FileOpenFailed(dirname + "/Header");
+        }
+    }
+
+    if (m_grids.empty()) { return; }
+
+    // The flags are 32 bits, more than a float holds, so they are written
+    // as two components of 16 bits.
+    MultiFab cellflag(m_grids, m_dmap, 2, m_cellflag.nGrowVect());
+    auto const& dst = cellflag.arrays();
+    auto const& src = m_cellflag.const_arrays();
+    ParallelFor(cellflag, cellflag.nGrowVect(),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
+    {
+        const uint32_t f = src[box_no](i,j,k).getValue();
+        dst[box_no](i,j,k,0) = static_cast<Real>(f & 0xffffu);
+        dst[box_no](i,j,k,1) = static_cast<Real>(f >> 16);
+    });
+    Gpu::streamSynchronize();
+
+    VisMF::Write(cellflag, dirname + "/CellFlag");
+    VisMF::Write(m_levelset, dirname + "/LevelSet");
+    VisMF::Write(m_volfrac, dirname + "/VolFrac");
+    VisMF::Write(m_centroid, dirname + "/Centroid");
+    VisMF::Write(m_bndryarea, dirname + "/BndryArea");
+    VisMF::Write(m_bndrycent, dirname + "/BndryCent");
+    VisMF::Write(m_bndrynorm, dirname + "/BndryNorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        VisMF::Write(m_areafrac[idim], dirname + "/AreaFrac_" + std::to_string(idim));
+        VisMF::Write(m_facecent[idim], dirname + "/FaceCent_" + std::to_string(idim));
+        VisMF::Write(m_edgecent[idim], dirname + "/EdgeCent_" + std::to_string(idim));
+    }
+}
+
 }}
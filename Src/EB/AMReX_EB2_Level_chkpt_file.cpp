@@ -0,0 +1,78 @@
+#include <AMReX_EB2_Level_chkpt_file.H>
+
+#include <sstream>
+
+namespace amrex { namespace EB2 {
+
+namespace {
+    // Read the MultiFab name into mf, on the boxes on disk and dm.
+    void readMultiFab (MultiFab& mf, const DistributionMapping& dm, const std::string& name)
+    {
+        Vector<char> header;
+        VisMF::ReadFAHeader(name, header);
+        VisMF::Header hdr;
+        {
+            std::istringstream is(header.dataPtr());
+            is >> hdr;
+        }
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(hdr.m_ba.size() == dm.size(),
+                                         "EB2::ChkptFileLevel: wrong number of boxes in "+name);
+        mf.define(hdr.m_ba, dm, hdr.m_ncomp, hdr.m_ngrow);
+        VisMF::Read(mf, name, header.dataPtr());
+    }
+}
+
+ChkptFileLevel::ChkptFileLevel (IndexSpace const* is, const Geometry& geom,
+                                const std::string& dirname)
+    : Level(is, geom)
+{
+    BL_PROFILE("EB2::ChkptFileLevel()");
+
+    {
+        Vector<char> buf;
+        ParallelDescriptor::ReadAndBcastFile(dirname + "/Header", buf);
+        std::istringstream hs(buf.dataPtr());
+        hs >> m_allregular >> m_ok >> m_ngrow;
+        for (BoxArray* ba : {&m_grids, &m_covered_grids}) {
+            Long nboxes = 0;
+            hs >> nboxes;
+            if (nboxes > 0) {
+                ba->readFrom(hs);
+            }
+        }
+        if (!hs) {
+            amrex::Abort("EB2::ChkptFileLevel: failed to read " + dirname + "/Header");
+        }
+    }
+
+    if (m_grids.empty()) { return; }
+
+    m_dmap.define(m_grids);
+
+    MultiFab cellflag;
+    readMultiFab(cellflag, m_dmap, dirname + "/CellFlag");
+    m_cellflag.define(m_grids, m_dmap, 1, cellflag.nGrowVect());
+    auto const& dst = m_cellflag.arrays();
+    auto const& src = cellflag.const_arrays();
+    ParallelFor(cellflag, cellflag.nGrowVect(),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
+    {
+        dst[box_no](i,j,k) = EBCellFlag(static_cast<uint32_t>(src[box_no](i,j,k,0))
+                                      | static_cast<uint32_t>(src[box_no](i,j,k,1)) << 16);
+    });
+    Gpu::streamSynchronize();
+
+    readMultiFab(m_levelset, m_dmap, dirname + "/LevelSet");
+    readMultiFab(m_volfrac, m_dmap, dirname + "/VolFrac");
+    readMultiFab(m_centroid, m_dmap, dirname + "/Centroid");
+    readMultiFab(m_bndryarea, m_dmap, dirname + "/BndryArea");
+    readMultiFab(m_bndrycent, m_dmap, dirname + "/BndryCent");
+    readMultiFab(m_bndrynorm, m_dmap, dirname + "/BndryNorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        readMultiFab(m_areafrac[idim], m_dmap, dirname + "/AreaFrac_" + std::to_string(idim));
+        readMultiFab(m_facecent[idim], m_dmap, dirname + "/FaceCent_" + std::to_string(idim));
+        readMultiFab(m_edgecent[idim], m_dmap, dirname + "/EdgeCent_" + std::to_string(idim));
+    }
+}
+
+}}
@@ -2,11 +2,26 @@
 #include <AMReX_EBDataCollection.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_MultiCutFab.H>
+#include <AMReX_ParmParse.H>
 
 #include <AMReX_EB2_Level.H>
 
+#include <iomanip>
+
 namespace amrex {
 
+namespace {
+    template <class FAB>
+    Long localBytes (FabArray<FAB> const& fa)
+    {
+        Long n = 0;
+        for (MFIter mfi(fa); mfi.isValid(); ++mfi) {
+            n += fa[mfi].nBytes();
+        }
+        return n;
+    }
+}
+
 EBDataCollection::EBDataCollection (const EB2::Level& a_level,
                                     const Geometry& a_geom,
                                     const BoxArray& a_ba_in,
@@ -19,6 +34,11 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
     // The BoxArray argument may not be cell-centered BoxArray.
     const BoxArray& a_ba = amrex::convert(a_ba_in, IntVect::TheZeroVector());
 
+    {
+        ParmParse pp("eb2");
+        pp.query("compact_cut_data", m_compact);
+    }
+
     if (m_support >= EBSupport::basic)
     {
         m_cellflags = new FabArray<EBCellFlagFab>(a_ba, a_dm, 1, m_ngrow[0], MFInfo(),
@@ -36,6 +56,7 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
 
         m_centroid = new MultiCutFab(a_ba, a_dm, AMREX_SPACEDIM, m_ngrow[1], *m_cellflags);
         a_level.fillCentroid(*m_centroid, m_geom);
+        if (m_compact) { m_centroid->compact(0.0, 0.0); }
     }
 
     if (m_support == EBSupport::full)
@@ -44,12 +65,15 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
 
         m_bndrycent = new MultiCutFab(a_ba, a_dm, AMREX_SPACEDIM, ng, *m_cellflags);
         a_level.fillBndryCent(*m_bndrycent, m_geom);
+        if (m_compact) { m_bndrycent->compact(-1.0, -1.0); }
 
         m_bndryarea = new MultiCutFab(a_ba, a_dm, 1, ng, *m_cellflags);
         a_level.fillBndryArea(*m_bndryarea, m_geom);
+        if (m_compact) { m_bndryarea->compact(0.0, 0.0); }
 
         m_bndrynorm = new MultiCutFab(a_ba, a_dm, AMREX_SPACEDIM, ng, *m_cellflags);
         a_level.fillBndryNorm(*m_bndrynorm, m_geom);
+        if (m_compact) { m_bndrynorm->compact(0.0, 0.0); }
 
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
             const BoxArray& faceba = amrex::convert(a_ba, IntVect::TheDimensionVector(idim));
@@ -63,6 +87,14 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
         a_level.fillAreaFrac(m_areafrac, m_geom);
         a_level.fillFaceCent(m_facecent, m_geom);
         a_level.fillEdgeCent(m_edgecent, m_geom);
+
+        if (m_compact) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                m_areafrac[idim]->compact(1.0, 0.0);
+                m_facecent[idim]->compact(0.0, 0.0);
+                m_edgecent[idim]->compact(1.0, -1.0);
+            }
+        }
     }
 }
 
@@ -152,4 +184,63 @@ EBDataCollection::getBndryNormal () const
     return *m_bndrynorm;
 }
 
+void
+EBDataCollection::expandCutData ()
+{
+    if (!m_compact) { return; }
+
+    for (auto* p : {m_centroid, m_bndrycent, m_bndryarea, m_bndrynorm}) {
+        if (p) { p->expand(); }
+    }
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        for (auto* p : {m_areafrac[idim], m_facecent[idim], m_edgecent[idim]}) {
+            if (p) { p->expand(); }
+        }
+    }
+    m_compact = false;
+}
+
+void
+EBDataCollection::printMemoryUsage () const
+{
+    Vector<std::string> names;
+    Vector<Long> nbytes;
+    auto add = [&] (std::string const& name, Long n) {
+        names.push_back(name);
+        nbytes.push_back(n);
+    };
+
+    if (m_cellflags) { add("CellFlag", localBytes(*m_cellflags)); }
+    if (m_levelset) { add("LevelSet", localBytes(*m_levelset)); }
+    if (m_volfrac) { add("VolFrac", localBytes(*m_volfrac)); }
+    if (m_centroid) { add("Centroid", m_centroid->nBytes()); }
+    if (m_bndrycent) { add("BndryCent", m_bndrycent->nBytes()); }
+    if (m_bndryarea) { add("BndryArea", m_bndryarea->nBytes()); }
+    if (m_bndrynorm) { add("BndryNorm", m_bndrynorm->nBytes()); }
+    if (m_areafrac[0]) {
+        Long na = 0, nf = 0, ne = 0;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            na += m_areafrac[idim]->nBytes();
+            nf += m_facecent[idim]->nBytes();
+            ne += m_edgecent[idim]->nBytes();
+        }
+        add("AreaFrac", na);
+        add("FaceCent", nf);
+        add("EdgeCent", ne);
+    }
+
+    ParallelDescriptor::ReduceLongSum(nbytes.data(), nbytes.size(),
+                                      ParallelDescriptor::IOProcessorNumber());
+
+    Long total = 0;
+    for (auto n : nbytes) { total += n; }
+    amrex::Print() << "EB data memory (" << (m_compact ? "compact" : "dense") << "):\n";
+    for (int i = 0; i < names.size(); ++i) {
+        amrex::Print() << "    " << std::setw(10) << std::left << names[i]
+                       << std::setw(14) << std::right << nbytes[i] << " bytes\n";
+    }
+    amrex::Print() << "    " << std::setw(10) << std::left << "Total"
+                   << std::setw(14) << std::right << total << " bytes\n";
+}
+
 }
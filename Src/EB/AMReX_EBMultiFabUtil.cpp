@@ -171,9 +171,9 @@ EB_set_covered_faces (const Array<MultiFab*,AMREX_SPACEDIM>& umac, Real val)
         }
         else if (fabtyp == FabType::singlevalued)
         {
-            AMREX_D_TERM(Array4<Real const> const& ax = area[0]->const_array(mfi);,
-                         Array4<Real const> const& ay = area[1]->const_array(mfi);,
-                         Array4<Real const> const& az = area[2]->const_array(mfi));
+            AMREX_D_TERM(CutArray4 const& ax = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& ay = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& az = area[2]->const_cut_array(mfi));
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM (
                 xbx, txbx,
                 {
@@ -287,9 +287,9 @@ EB_set_covered_faces (const Array<MultiFab*,AMREX_SPACEDIM>& umac, const int sco
         }
         else if (fabtyp == FabType::singlevalued)
         {
-            AMREX_D_TERM(Array4<Real const> const& ax = area[0]->const_array(mfi);,
-                         Array4<Real const> const& ay = area[1]->const_array(mfi);,
-                         Array4<Real const> const& az = area[2]->const_array(mfi));
+            AMREX_D_TERM(CutArray4 const& ax = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& ay = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& az = area[2]->const_cut_array(mfi));
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM (
                 xbx, txbx,
                 {
@@ -546,7 +546,7 @@ void EB_average_down_faces (const Array<const MultiFab*,AMREX_SPACEDIM>& fine,
                     }
                     else
                     {
-                        Array4<Real const> const& ap = aspect[n]->const_array(mfi);
+                        CutArray4 const& ap = aspect[n]->const_cut_array(mfi);
                         if (n == 0) {
                             AMREX_HOST_DEVICE_FOR_3D(tbx,i,j,k,
                             {
@@ -658,7 +658,7 @@ void EB_average_down_boundaries (const MultiFab& fine, MultiFab& crse,
                     });
                 } else {
                     Array4<Real const> const& fa = fine.const_array(mfi);
-                    Array4<Real const> const& ba = barea.const_array(mfi);
+                    CutArray4 const& ba = barea.const_cut_array(mfi);
                     AMREX_HOST_DEVICE_FOR_3D(tbx,i,j,k,
                     {
                         eb_avgdown_boundaries(i,j,k,fa,0,ca,0,ba,dratio,ncomp);
@@ -740,12 +740,12 @@ void EB_computeDivergence (MultiFab& divu, const Array<MultiFab const*,AMREX_SPA
                 Array4<int const> const& ccm = (already_on_centroids) ?
                     Array4<int const>{} : cc_mask.const_array(mfi);
                 Array4<Real const> const& vol = vfrac.const_array(mfi);
-                AMREX_D_TERM(Array4<Real const> const& apx = area[0]->const_array(mfi);,
-                             Array4<Real const> const& apy = area[1]->const_array(mfi);,
-                             Array4<Real const> const& apz = area[2]->const_array(mfi));
-                AMREX_D_TERM(Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
-                             Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
-                             Array4<Real const> const& fcz = fcent[2]->const_array(mfi));
+                AMREX_D_TERM(CutArray4 const& apx = area[0]->const_cut_array(mfi);,
+                             CutArray4 const& apy = area[1]->const_cut_array(mfi);,
+                             CutArray4 const& apz = area[2]->const_cut_array(mfi));
+                AMREX_D_TERM(CutArray4 const& fcx = fcent[0]->const_cut_array(mfi);,
+                             CutArray4 const& fcy = fcent[1]->const_cut_array(mfi);,
+                             CutArray4 const& fcz = fcent[2]->const_cut_array(mfi));
                 Array4<EBCellFlag const> const& flagarr = flagfab.const_array();
                 AMREX_HOST_DEVICE_FOR_4D(bx,divu.nComp(),i,j,k,n,
                 {
@@ -789,9 +789,9 @@ void EB_computeDivergence (MultiFab& divu, const Array<MultiFab const*,AMREX_SPA
             Array4<Real> const& divuarr = divu.array(mfi);
             Array4<Real const> const& vel_eb_arr = vel_eb.const_array(mfi);
             Array4<Real const> const& vfracarr = vfrac.const_array(mfi);
-            Array4<Real const> const& bnormarr = bnorm.const_array(mfi);
+            CutArray4 const& bnormarr = bnorm.const_cut_array(mfi);
             Array4<EBCellFlag const> const& flagarr = flagfab.const_array();
-            Array4<Real const> const& bareaarr = barea.const_array(mfi);
+            CutArray4 const& bareaarr = barea.const_cut_array(mfi);
 
             AMREX_HOST_DEVICE_FOR_4D(bx,divu.nComp(),i,j,k,n,
             {
@@ -843,9 +843,9 @@ EB_average_face_to_cellcenter (MultiFab& ccmf, int dcomp,
                     amrex_avg_fc_to_cc(i,j,k,ccfab,AMREX_D_DECL(xfab,yfab,zfab),dcomp);
                 });
             } else {
-                AMREX_D_TERM(Array4<Real const> const& apx = area[0]->const_array(mfi);,
-                             Array4<Real const> const& apy = area[1]->const_array(mfi);,
-                             Array4<Real const> const& apz = area[2]->const_array(mfi));
+                AMREX_D_TERM(CutArray4 const& apx = area[0]->const_cut_array(mfi);,
+                             CutArray4 const& apy = area[1]->const_cut_array(mfi);,
+                             CutArray4 const& apz = area[2]->const_cut_array(mfi));
                 Array4<EBCellFlag const> const& flagarr = flagfab.const_array();
                 AMREX_HOST_DEVICE_FOR_3D(bx,i,j,k,
                 {
@@ -893,7 +893,7 @@ EB_interp_CC_to_Centroid (MultiFab& cent, const MultiFab& cc, int scomp, int dco
         else
         {
             const auto& flagfab = flags.const_array(mfi);
-            const auto& locfab = loc.const_array(mfi);
+            CutArray4 const& locfab = loc.const_cut_array(mfi);
             const auto& ccfab = cc.array(mfi,scomp);
 
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( vbx, thread_box,
@@ -985,12 +985,12 @@ EB_interp_CC_to_FaceCentroid (const MultiFab& cc,
             }
             else
             {
-                AMREX_D_TERM(Array4<Real const> const& apxfab = area[0]->const_array(mfi);,
-                             Array4<Real const> const& apyfab = area[1]->const_array(mfi);,
-                             Array4<Real const> const& apzfab = area[2]->const_array(mfi));
-                AMREX_D_TERM(Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
-                             Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
-                             Array4<Real const> const& fcz = fcent[2]->const_array(mfi));
+                AMREX_D_TERM(CutArray4 const& apxfab = area[0]->const_cut_array(mfi);,
+                             CutArray4 const& apyfab = area[1]->const_cut_array(mfi);,
+                             CutArray4 const& apzfab = area[2]->const_cut_array(mfi));
+                AMREX_D_TERM(CutArray4 const& fcx = fcent[0]->const_cut_array(mfi);,
+                             CutArray4 const& fcy = fcent[1]->const_cut_array(mfi);,
+                             CutArray4 const& fcz = fcent[2]->const_cut_array(mfi));
 
                 AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM
                     (xbx, txbx,
@@ -1123,16 +1123,16 @@ EB_interp_CellCentroid_to_FaceCentroid (const MultiFab& phi_centroid,
             }
             else
             {
-                AMREX_D_TERM(Array4<Real const> const& apxfab = area[0]->const_array(mfi);,
-                             Array4<Real const> const& apyfab = area[1]->const_array(mfi);,
-                             Array4<Real const> const& apzfab = area[2]->const_array(mfi));
+                AMREX_D_TERM(CutArray4 const& apxfab = area[0]->const_cut_array(mfi);,
+                             CutArray4 const& apyfab = area[1]->const_cut_array(mfi);,
+                             CutArray4 const& apzfab = area[2]->const_cut_array(mfi));
 
-                AMREX_D_TERM(Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
-                             Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
-                             Array4<Real const> const& fcz = fcent[2]->const_array(mfi));
+                AMREX_D_TERM(CutArray4 const& fcx = fcent[0]->const_cut_array(mfi);,
+                             CutArray4 const& fcy = fcent[1]->const_cut_array(mfi);,
+                             CutArray4 const& fcz = fcent[2]->const_cut_array(mfi));
 
                 Array4<Real const> const& cvol = vfrac.const_array(mfi);
-                Array4<Real const> const& cct  = ccent.const_array(mfi);
+                CutArray4 const& cct  = ccent.const_cut_array(mfi);
 
                 AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM
                     (xbx, txbx,
@@ -1,13 +1,17 @@
 #include <AMReX_EBToPVD.H>
 #include <AMReX_BLassert.H>
+#include <AMReX_BLProfiler.H>
 #include <AMReX_Dim3.H>
+#include <AMReX_VisMFBuffer.H>
 
 #include <string>
 #include <sstream>
+#include <fstream>
 #include <iomanip>
 #include <cmath>
 #include <algorithm>
 #include <limits>
+#include <cstdint>
 
 namespace {
 amrex::Real dot_product(const std::array<amrex::Real,3>& a, const std::array<amrex::Real,3>& b)
@@ -20,6 +24,28 @@ bool intersects(amrex::Real val)
    return (val > 0.0 && val < 1.0);
 }
 
+std::string piece_name(int myID)
+{
+   std::stringstream ss;
+   ss << std::setw(8) << std::setfill('0') << myID;
+   return "eb_" + ss.str() + ".vtp";
+}
+
+const char* byte_order()
+{
+   const std::uint16_t one = 1;
+   return (*reinterpret_cast<const unsigned char*>(&one) == 1) ? "LittleEndian" : "BigEndian";
+}
+
+// Writes a block of appended data: the number of bytes followed by the data
+template <typename T>
+void write_block(std::ofstream& myfile, const std::vector<T>& v)
+{
+   const std::uint64_t nbytes = v.size()*sizeof(T);
+   myfile.write(reinterpret_cast<const char*>(&nbytes), sizeof(nbytes));
+   myfile.write(reinterpret_cast<const char*>(v.data()), nbytes);
+}
+
 }
 
 namespace amrex {
@@ -166,13 +192,21 @@ void EBToPVD::EBToPolygon(const Real* problo, const Real* dx,
                      apoints[11][idim] = vertex[4][idim] + jhat[idim]*dx[1]*alpha[11];
                   }
 
-                  // store intersections with grid cell alpha in [0,1]
+                  // grid edge (direction, node) of each intersection
+                  const std::array<std::array<int,4>,12> edges = {{
+                     {0,i  ,j  ,k  }, {1,i+1,j  ,k  }, {0,i  ,j+1,k  }, {1,i  ,j  ,k  },
+                     {2,i  ,j  ,k  }, {2,i+1,j  ,k  }, {2,i+1,j+1,k  }, {2,i  ,j+1,k  },
+                     {0,i  ,j  ,k+1}, {1,i+1,j  ,k+1}, {0,i  ,j+1,k+1}, {1,i  ,j  ,k+1}}};
+
+                  // store intersections with grid cell alpha in [0,1].  The
+                  // polygons of neighboring cells share the points on their
+                  // common edges where the points coincide.
                   for(int lc1 = 0; lc1 < 12; ++lc1) {
                      if(alpha_intersect[lc1]) {
-                        m_points.push_back(apoints[lc1]);
+                        const auto& e = edges[lc1];
                         int lc2 = m_connectivity.back()[0]+1;
                         m_connectivity.back()[0] = lc2;
-                        m_connectivity.back()[lc2] = m_points.size()-1;
+                        m_connectivity.back()[lc2] = edge_point(e[0], e[1], e[2], e[3], apoints[lc1], dx);
                      }
                   }
 
@@ -186,25 +220,63 @@ void EBToPVD::EBToPolygon(const Real* problo, const Real* dx,
 
 void EBToPVD::WriteEBVTP(const int myID) const
 {
-   std::stringstream ss;
-   ss << std::setw(8) << std::setfill('0') << myID;
-   std::string cID = "eb_" + ss.str() + ".vtp";
+   BL_PROFILE("EBToPVD::WriteEBVTP()");
+
+   AMREX_ALWAYS_ASSERT(m_points.size() < static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()));
+
+   std::vector<float> points;
+   points.reserve(3*m_points.size());
+   for(const auto& p : m_points) {
+      points.push_back(static_cast<float>(p[0]));
+      points.push_back(static_cast<float>(p[1]));
+      points.push_back(static_cast<float>(p[2]));
+   }
 
-   std::ofstream myfile(cID);
+   std::vector<std::int32_t> connectivity, offsets;
+   connectivity.reserve(6*m_connectivity.size());
+   offsets.reserve(m_connectivity.size());
+   for(const auto& c : m_connectivity) {
+      for(int lc2 = 1; lc2 <= c[0]; ++lc2) {
+         connectivity.push_back(c[lc2]);
+      }
+      offsets.push_back(connectivity.size());
+   }
+
+   const std::uint64_t off_connectivity = sizeof(std::uint64_t) + points.size()*sizeof(float);
+   const std::uint64_t off_offsets = off_connectivity + sizeof(std::uint64_t)
+      + connectivity.size()*sizeof(std::int32_t);
+
+   VisMFBuffer::IO_Buffer io_buffer(VisMFBuffer::GetIOBufferSize());
+
+   std::ofstream myfile;
+   myfile.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
+   myfile.open(piece_name(myID), std::ios::out | std::ios::trunc | std::ios::binary);
    if(myfile.is_open()) {
-      myfile.precision(6);
       myfile << "<?xml version=\"1.0\"?>\n";
-      myfile << "<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+      myfile << "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"" << byte_order()
+         << "\" header_type=\"UInt64\">\n";
       myfile << "<PolyData>\n";
       myfile << "<Piece NumberOfPoints=\"" << m_points.size() << "\" NumberOfVerts=\"0\" "
-         << "NumberOfLines=\"0\" NumberOfString=\"0\" NumberOfPolys=\" "
+         << "NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\""
          << m_connectivity.size() << "\">\n";
-      print_points(myfile);
-      print_connectivity(myfile);
+      myfile << "<Points>\n";
+      myfile << "<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"0\"/>\n";
+      myfile << "</Points>\n";
+      myfile << "<Polys>\n";
+      myfile << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\""
+         << off_connectivity << "\"/>\n";
+      myfile << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\""
+         << off_offsets << "\"/>\n";
+      myfile << "</Polys>\n";
       myfile << "<PointData></PointData>\n";
       myfile << "<CellData></CellData>\n";
       myfile << "</Piece>\n";
       myfile << "</PolyData>\n";
+      myfile << "<AppendedData encoding=\"raw\">\n_";
+      write_block(myfile, points);
+      write_block(myfile, connectivity);
+      write_block(myfile, offsets);
+      myfile << "\n</AppendedData>\n";
       myfile << "</VTKFile>\n";
 
       myfile.close();
@@ -212,12 +284,22 @@ void EBToPVD::WriteEBVTP(const int myID) const
 }
 
 void EBToPVD::WritePVTP(const int nProcs) const
+{
+   Vector<int> procs(nProcs);
+   for(int lc1 = 0; lc1 < nProcs; ++lc1) {
+      procs[lc1] = lc1;
+   }
+   WritePVTP(procs);
+}
+
+void EBToPVD::WritePVTP(const Vector<int>& procs) const
 {
    std::ofstream myfile("eb.pvtp");
 
    if(myfile.is_open()) {
       myfile << "<?xml version=\"1.0\"?>\n";
-      myfile << "<VTKFile type=\"PPolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+      myfile << "<VTKFile type=\"PPolyData\" version=\"1.0\" byte_order=\"" << byte_order()
+         << "\" header_type=\"UInt64\">\n";
       myfile << "<PPolyData GhostLevel=\"0\">\n";
       myfile << "<PPointData/>\n";
       myfile << "<PCellData/>\n";
@@ -225,11 +307,8 @@ void EBToPVD::WritePVTP(const int nProcs) const
       myfile << "<PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n";
       myfile << "</PPoints>\n";
 
-      for(int lc1 = 0; lc1 < nProcs; ++lc1) {
-         std::stringstream ss;
-         ss << std::setw(8) << std::setfill('0') << lc1;
-         std::string clc1 = "eb_" + ss.str() + ".vtp";
-         myfile << "<Piece Source=\"" << clc1 << "\"/>\n";
+      for(int proc : procs) {
+         myfile << "<Piece Source=\"" << piece_name(proc) << "\"/>\n";
       }
 
       myfile << "</PPolyData>\n";
@@ -237,6 +316,7 @@ void EBToPVD::WritePVTP(const int nProcs) const
       myfile.close();
    }
 }
+
 void EBToPVD::reorder_polygon(const std::vector<std::array<Real,3>>& lpoints,
       std::array<int,7>& lconnect,
       const std::array<Real,3>& lnormal)
@@ -381,42 +461,35 @@ void EBToPVD::calc_intersects(int& int_count, std::array<bool,12>& intersects_fl
    }
 }
 
-void EBToPVD::print_points(std::ofstream& myfile) const
+std::size_t EBToPVD::EdgeHash::operator()(const std::array<int,4>& e) const noexcept
 {
-   myfile << "<Points>\n";
-   myfile << "<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-
-   for(size_t lc1 = 0; lc1 < m_points.size(); ++lc1) {
-      myfile << std::fixed << std::scientific
-         << m_points[lc1][0] << " " << m_points[lc1][1] << " " << m_points[lc1][2] << "\n";
+   std::size_t h = static_cast<std::size_t>(e[0]);
+   for(int lc1 = 1; lc1 < 4; ++lc1) {
+      h = h*1000003u ^ static_cast<std::size_t>(static_cast<unsigned int>(e[lc1]));
    }
-
-   myfile << "</DataArray>\n";
-   myfile << "</Points>\n";
+   return h;
 }
 
-void EBToPVD::print_connectivity(std::ofstream& myfile) const
+int EBToPVD::edge_point(int dir, int i, int j, int k, const std::array<Real,3>& p, const Real* dx)
 {
-   myfile << "<Polys>\n";
-   myfile << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
-   for(size_t lc1 = 0; lc1 < m_connectivity.size(); ++lc1) {
-      for(int lc2 = 1; lc2 <= m_connectivity[lc1][0]; ++lc2) {
-         myfile << " " << m_connectivity[lc1][lc2];
+   const std::array<int,4> e = {dir,i,j,k};
+   if(m_merge_tol >= 0.0) {
+      const Real tol = m_merge_tol*dx[dir];
+      const auto range = m_edge_point.equal_range(e);
+      for(auto it = range.first; it != range.second; ++it) {
+         const auto& q = m_points[it->second];
+         if(Math::abs(q[0]-p[0]) <= tol && Math::abs(q[1]-p[1]) <= tol &&
+            Math::abs(q[2]-p[2]) <= tol) {
+            return it->second;
+         }
       }
-      myfile << "\n";
    }
-   myfile << "</DataArray>\n";
-
-   myfile << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-   int lc2 = 0;
-   for(size_t lc1 = 0; lc1 < m_connectivity.size(); ++lc1) {
-      lc2 = lc2 + m_connectivity[lc1][0];
-      myfile << " " << lc2;
+   const int ip = static_cast<int>(m_points.size());
+   m_points.push_back(p);
+   if(m_merge_tol >= 0.0) {
+      m_edge_point.emplace(e, ip);
    }
-   myfile << "\n";
-   myfile << "</DataArray>\n";
-
-   myfile << "</Polys>\n";
+   return ip;
 }
 
 void EBToPVD::EBGridCoverage(const int myID, const Real* problo, const Real* dx,
@@ -1,7 +1,9 @@
 #include <AMReX_EB_STL_utils.H>
 #include <AMReX_EB_triGeomOps_K.H>
 #include <AMReX_IntConv.H>
+#include <algorithm>
 #include <cstring>
+#include <numeric>
 
 namespace amrex
 {
@@ -489,54 +491,155 @@ STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
     }
     else
     {
-        int num_triangles = m_num_tri;
-        const Triangle* tri_pts = m_tri_pts_d.data();
-        XDim3 ptmin = m_ptmin;
-        XDim3 ptmax = m_ptmax;
-        XDim3 ptref = m_ptref;
-        int ref_value = m_boundry_is_outside ? 1 : 0;
-
-        ReduceOps<ReduceOpSum> reduce_op;
-        ReduceData<int> reduce_data(reduce_op);
-        using ReduceTuple = typename decltype(reduce_data)::Type;
-        reduce_op.eval(box, reduce_data,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+        Vector<int> tris(m_num_tri);
+        std::iota(tris.begin(), tris.end(), 0);
+        int mask;
+        if (Gpu::inLaunchRegion()) {
+            // Collect the boxes to be classified node by node, and classify
+            // them all in one launch instead of one reduction per box.
+            Vector<Box> leaves;
+            getBoxMask(box, geom, tris, &leaves);
+            mask = getBoxMask_Eval(leaves, geom);
+        } else {
+            mask = getBoxMask(box, geom, tris, nullptr);
+        }
+        if (!(mask & has_fluid)) {
+            return allcovered;
+        } else if (!(mask & has_body)) {
+            return allregular;
+        } else {
+            return mixedcells;
+        }
+    }
+}
+
+int
+STLtools::getBoxMask (Box const& box, Geometry const& geom, Vector<int> const& tris,
+                      Vector<Box>* leaves) const
+{
+    // The triangles whose bounding boxes touch the region of the nodes of
+    // box.  If there are none, the surface does not pass through the
+    // region, and one node is enough.
+    const auto plo = geom.ProbLoArray();
+    const auto dx  = geom.CellSizeArray();
+    Real lo[3] = {0._rt, 0._rt, 0._rt};
+    Real hi[3] = {0._rt, 0._rt, 0._rt};
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const Real eps = 1.e-6_rt*dx[idim];
+        lo[idim] = plo[idim] + box.smallEnd(idim)*dx[idim] - eps;
+        hi[idim] = plo[idim] + box.bigEnd(idim)*dx[idim] + eps;
+    }
+
+    Vector<int> box_tris;
+    for (int i : tris) {
+        Triangle const& tri = m_tri_pts_h[i];
+        if (std::min({tri.v1.x,tri.v2.x,tri.v3.x}) <= hi[0] &&
+            std::max({tri.v1.x,tri.v2.x,tri.v3.x}) >= lo[0] &&
+            std::min({tri.v1.y,tri.v2.y,tri.v3.y}) <= hi[1] &&
+            std::max({tri.v1.y,tri.v2.y,tri.v3.y}) >= lo[1] &&
+            std::min({tri.v1.z,tri.v2.z,tri.v3.z}) <= hi[2] &&
+            std::max({tri.v1.z,tri.v2.z,tri.v3.z}) >= lo[2])
         {
-            Real coords[3];
-            coords[0]=plo[0]+i*dx[0];
-            coords[1]=plo[1]+j*dx[1];
+            box_tris.push_back(i);
+        }
+    }
+
+    int dir;
+    const int len = box.longside(dir);
+    if (box_tris.empty() || len <= box_type_min_size) {
+        Box leaf = box_tris.empty() ? Box(box.smallEnd(), box.smallEnd(), box.ixType()) : box;
+        if (leaves) {
+            leaves->push_back(leaf);
+            return 0;
+        } else {
+            return getBoxMask_Eval(Vector<Box>{leaf}, geom);
+        }
+    }
+
+    Box lo_box = box;
+    Box hi_box = lo_box.chop(dir, box.smallEnd(dir)+len/2);
+    int mask = getBoxMask(lo_box, geom, box_tris, leaves);
+    if (mask != (has_body|has_fluid)) {
+        mask |= getBoxMask(hi_box, geom, box_tris, leaves);
+    }
+    return mask;
+}
+
+int
+STLtools::getBoxMask_Eval (Vector<Box> const& boxes, Geometry const& geom) const
+{
+    if (boxes.empty()) { return 0; }
+
+    const auto plo = geom.ProbLoArray();
+    const auto dx  = geom.CellSizeArray();
+
+    // The nodes of all the boxes are numbered one after another.
+    const int nboxes = boxes.size();
+    Vector<Long> offsets(nboxes+1, 0);
+    for (int ib = 0; ib < nboxes; ++ib) {
+        offsets[ib+1] = offsets[ib] + boxes[ib].numPts();
+    }
+    const Long npts = offsets[nboxes];
+
+    Gpu::DeviceVector<Box> boxes_d(nboxes);
+    Gpu::DeviceVector<Long> offsets_d(nboxes+1);
+    Gpu::copyAsync(Gpu::hostToDevice, boxes.begin(), boxes.end(), boxes_d.begin());
+    Gpu::copyAsync(Gpu::hostToDevice, offsets.begin(), offsets.end(), offsets_d.begin());
+    const Box* pboxes = boxes_d.data();
+    const Long* poffsets = offsets_d.data();
+
+    int num_triangles = m_num_tri;
+    const Triangle* tri_pts = m_tri_pts_d.data();
+    XDim3 ptmin = m_ptmin;
+    XDim3 ptmax = m_ptmax;
+    XDim3 ptref = m_ptref;
+    int ref_value = m_boundry_is_outside ? 1 : 0;
+
+    ReduceOps<ReduceOpSum> reduce_op;
+    ReduceData<Long> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    reduce_op.eval(npts, reduce_data,
+    [=] AMREX_GPU_DEVICE (Long n) -> ReduceTuple
+    {
+        const int ib = amrex::bisect(poffsets, 0, nboxes, n);
+        const Box& b = pboxes[ib];
+        const auto len = amrex::length(b);
+        const auto lo  = amrex::lbound(b);
+        const Long icell = n - poffsets[ib];
+        const int k = static_cast<int>( icell /   (len.x*len.y));
+        const int j = static_cast<int>((icell - k*Long(len.x*len.y)) /   len.x);
+        const int i = static_cast<int>( icell - k*Long(len.x*len.y)  - j*Long(len.x));
+
+        Real coords[3];
+        coords[0]=plo[0]+(i+lo.x)*dx[0];
+        coords[1]=plo[1]+(j+lo.y)*dx[1];
 #if (AMREX_SPACEDIM == 2)
-            amrex::ignore_unused(k);
-            coords[2]=Real(0.);
+        amrex::ignore_unused(k);
+        coords[2]=Real(0.);
 #else
-            coords[2]=plo[2]+k*dx[2];
+        coords[2]=plo[2]+(k+lo.z)*dx[2];
 #endif
-            int num_intersects=0;
-            if (coords[0] >= ptmin.x && coords[0] <= ptmax.x &&
-                coords[1] >= ptmin.y && coords[1] <= ptmax.y &&
-                coords[2] >= ptmin.z && coords[2] <= ptmax.z)
-            {
-                Real pr[]={ptref.x, ptref.y, ptref.z};
-                for (int tr=0; tr < num_triangles; ++tr) {
-                    if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                        ++num_intersects;
-                    }
+        int num_intersects=0;
+        if (coords[0] >= ptmin.x && coords[0] <= ptmax.x &&
+            coords[1] >= ptmin.y && coords[1] <= ptmax.y &&
+            coords[2] >= ptmin.z && coords[2] <= ptmax.z)
+        {
+            Real pr[]={ptref.x, ptref.y, ptref.z};
+            for (int tr=0; tr < num_triangles; ++tr) {
+                if (line_tri_intersects(pr, coords, tri_pts[tr])) {
+                    ++num_intersects;
                 }
             }
-
-            return (num_intersects % 2 == 0) ? ref_value : 1-ref_value;
-        });
-        ReduceTuple hv = reduce_data.value(reduce_op);
-        Long nfluid = static_cast<Long>(amrex::get<0>(hv));
-        Long npts = box.numPts();
-        if (nfluid == 0) {
-            return allcovered;
-        } else if (nfluid == npts) {
-            return allregular;
-        } else {
-            return mixedcells;
         }
-    }
+
+        return (num_intersects % 2 == 0) ? ref_value : 1-ref_value;
+    });
+    ReduceTuple hv = reduce_data.value(reduce_op);
+    Long nfluid = amrex::get<0>(hv);
+    int mask = 0;
+    if (nfluid > 0) { mask |= has_fluid; }
+    if (nfluid < npts) { mask |= has_body; }
+    return mask;
 }
 
 void
@@ -524,10 +524,10 @@ void FillSignedDistance (MultiFab& mf, EB2::Level const& ls_lev,
             if (ncutcells > 0) {
                 Gpu::DeviceVector<GpuArray<Real,AMREX_SPACEDIM*2> > facets(ncutcells);
                 auto p_facets = facets.data();
-                Array4<Real const> const& bcent = bndrycent.const_array(mfi);
-                AMREX_D_TERM(Array4<Real const> const& apx = areafrac[0]->const_array(mfi);,
-                             Array4<Real const> const& apy = areafrac[1]->const_array(mfi);,
-                             Array4<Real const> const& apz = areafrac[2]->const_array(mfi));
+                CutArray4 const& bcent = bndrycent.const_cut_array(mfi);
+                AMREX_D_TERM(CutArray4 const& apx = areafrac[0]->const_cut_array(mfi);,
+                             CutArray4 const& apy = areafrac[1]->const_cut_array(mfi);,
+                             CutArray4 const& apz = areafrac[2]->const_cut_array(mfi));
                 amrex::ParallelFor(eb_search, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
                 {
                     int icell = eb_search.index(IntVect(AMREX_D_DECL(i,j,k)));
@@ -1,6 +1,7 @@
 
 #include <AMReX_MultiCutFab.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_Scan.H>
 
 #ifdef AMREX_USE_OMP
 #include <omp.h>
@@ -16,7 +17,7 @@ MultiCutFab::MultiCutFab (const BoxArray& ba, const DistributionMapping& dm,
     : m_data(ba,dm,ncomp,ngrow,MFInfo(),DefaultFabFactory<CutFab>()),
       m_cellflags(&cellflags)
 {
-    remove();
+    remove(m_data);
 }
 
 MultiCutFab::~MultiCutFab ()
@@ -28,17 +29,21 @@ MultiCutFab::define (const BoxArray& ba, const DistributionMapping& dm,
 {
     m_data.define(ba,dm,ncomp,ngrow,MFInfo(),DefaultFabFactory<CutFab>()),
     m_cellflags = &cellflags;
-    remove();
+    m_compact = false;
+    m_slot.clear();
+    m_records = LayoutData<Gpu::DeviceVector<Real> >();
+    remove(m_data);
 }
 
+template <class FAB>
 void
-MultiCutFab::remove ()
+MultiCutFab::remove (FabArray<FAB>& fa)
 {
-    for (MFIter mfi(m_data); mfi.isValid(); ++mfi)
+    for (MFIter mfi(fa); mfi.isValid(); ++mfi)
     {
         if (!ok(mfi))
         {
-            delete m_data.release(mfi);
+            delete fa.release(mfi);
         }
     }
 }
@@ -47,6 +52,7 @@ const CutFab&
 MultiCutFab::operator[] (const MFIter& mfi) const noexcept
 {
     AMREX_ASSERT(ok(mfi));
+    assertDense();
     return m_data[mfi];
 }
 
@@ -54,6 +60,7 @@ CutFab&
 MultiCutFab::operator[] (const MFIter& mfi) noexcept
 {
     AMREX_ASSERT(ok(mfi));
+    assertDense();
     return m_data[mfi];
 }
 
@@ -61,6 +68,7 @@ const CutFab&
 MultiCutFab::operator[] (int global_box_index) const noexcept
 {
     AMREX_ASSERT(ok(global_box_index));
+    assertDense();
     return m_data[global_box_index];
 }
 
@@ -68,6 +76,7 @@ CutFab&
 MultiCutFab::operator[] (int global_box_index) noexcept
 {
     AMREX_ASSERT(ok(global_box_index));
+    assertDense();
     return m_data[global_box_index];
 }
 
@@ -75,6 +84,7 @@ Array4<Real const>
 MultiCutFab::const_array (const MFIter& mfi) const noexcept
 {
     AMREX_ASSERT(ok(mfi));
+    assertDense();
     return m_data.array(mfi);
 }
 
@@ -82,6 +92,7 @@ Array4<Real const>
 MultiCutFab::array (const MFIter& mfi) const noexcept
 {
     AMREX_ASSERT(ok(mfi));
+    assertDense();
     return m_data.array(mfi);
 }
 
@@ -89,9 +100,181 @@ Array4<Real>
 MultiCutFab::array (const MFIter& mfi) noexcept
 {
     AMREX_ASSERT(ok(mfi));
+    assertDense();
     return m_data.array(mfi);
 }
 
+Array4<Real const>
+MultiCutFab::const_array (const MFIter& mfi, FArrayBox& scratch) const
+{
+    AMREX_ASSERT(ok(mfi));
+    if (!m_compact) {
+        return m_data.const_array(mfi);
+    }
+
+    const Box& b = m_slot[mfi].box();
+    scratch.resize(b, nComp(), The_Async_Arena());
+    Array4<Real> const& d = scratch.array();
+    CutArray4 const& s = const_cut_array(mfi);
+    ParallelFor(b, nComp(), [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+    {
+        d(i,j,k,n) = s(i,j,k,n);
+    });
+    return scratch.const_array();
+}
+
+CutArray4
+MultiCutFab::const_cut_array (const MFIter& mfi) const noexcept
+{
+    AMREX_ASSERT(ok(mfi));
+    CutArray4 r;
+    r.ncomp = nComp();
+    if (m_compact) {
+        r.slot = m_slot.const_array(mfi);
+        r.records = m_records[mfi].data();
+        r.regular_value = m_regular_value;
+        r.covered_value = m_covered_value;
+    } else {
+        r.dense = m_data.const_array(mfi);
+    }
+    return r;
+}
+
+void
+MultiCutFab::compact (Real regular_value, Real covered_value)
+{
+    if (m_compact) { return; }
+
+    BL_PROFILE("MultiCutFab::compact()");
+
+    const BoxArray ba = boxArray();
+    const DistributionMapping dm = DistributionMap();
+    const int ncomp = nComp();
+    const int ngrow = nGrow();
+
+    m_slot.define(ba, dm, 1, ngrow, MFInfo(), DefaultFabFactory<IArrayBox>());
+    remove(m_slot);
+    m_records.define(ba, dm);
+
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi)
+    {
+        if (!ok(mfi)) { continue; }
+
+        const Box& b = mfi.fabbox();
+        Array4<Real const> const& a = m_data.const_array(mfi);
+        Array4<int> const& slot = m_slot.array(mfi);
+
+        // The records are numbered in the order of the points in the box.
+        const int nrecords = Scan::PrefixSum<int>
+            (b.numPts(),
+             [=] AMREX_GPU_DEVICE (int offset) -> int
+             {
+                 GpuArray<int,3> ijk = b.atOffset3d(offset);
+                 bool is_regular = true;
+                 bool is_covered = true;
+                 for (int n = 0; n < ncomp; ++n) {
+                     const Real v = a(ijk[0],ijk[1],ijk[2],n);
+                     is_regular = is_regular && (v == regular_value);
+                     is_covered = is_covered && (v == covered_value);
+                 }
+                 int s = 0;
+                 if (is_regular) {
+                     s = CutArray4::regular_slot;
+                 } else if (is_covered) {
+                     s = CutArray4::covered_slot;
+                 }
+                 slot(ijk[0],ijk[1],ijk[2]) = s;
+                 return (s == 0) ? 1 : 0;
+             },
+             [=] AMREX_GPU_DEVICE (int offset, int const& x)
+             {
+                 GpuArray<int,3> ijk = b.atOffset3d(offset);
+                 if (slot(ijk[0],ijk[1],ijk[2]) >= 0) {
+                     slot(ijk[0],ijk[1],ijk[2]) = x;
+                 }
+             },
+             Scan::Type::exclusive, Scan::retSum);
+
+        auto& records = m_records[mfi];
+        records.resize(static_cast<std::size_t>(nrecords)*ncomp);
+        Real* AMREX_RESTRICT p = records.data();
+        ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            const int s = slot(i,j,k);
+            if (s >= 0) {
+                for (int n = 0; n < ncomp; ++n) {
+                    p[s*ncomp+n] = a(i,j,k,n);
+                }
+            }
+        });
+    }
+    Gpu::streamSynchronize();
+
+    m_data.clear();
+    m_data.define(ba, dm, ncomp, ngrow, MFInfo().SetAlloc(false), DefaultFabFactory<CutFab>());
+    remove(m_data);
+
+    m_compact = true;
+    m_regular_value = regular_value;
+    m_covered_value = covered_value;
+}
+
+void
+MultiCutFab::expand ()
+{
+    if (!m_compact) { return; }
+
+    BL_PROFILE("MultiCutFab::expand()");
+
+    FabArray<CutFab> dense(boxArray(), DistributionMap(), nComp(), nGrow(), MFInfo(),
+                           DefaultFabFactory<CutFab>());
+    remove(dense);
+    fillDense(dense);
+
+    m_data = std::move(dense);
+    m_compact = false;
+    m_slot.clear();
+    m_records = LayoutData<Gpu::DeviceVector<Real> >();
+}
+
+void
+MultiCutFab::fillDense (FabArray<CutFab>& fa) const
+{
+    const int ncomp = nComp();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(fa); mfi.isValid(); ++mfi)
+    {
+        if (ok(mfi)) {
+            Box const& b = mfi.fabbox();
+            Array4<Real> const& d = fa.array(mfi);
+            CutArray4 const& s = const_cut_array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D(b, ncomp, i, j, k, n,
+            {
+                d(i,j,k,n) = s(i,j,k,n);
+            });
+        }
+    }
+    Gpu::streamSynchronize();
+}
+
+Long
+MultiCutFab::nBytes () const
+{
+    Long nbytes = 0;
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi)
+    {
+        if (!ok(mfi)) { continue; }
+        if (m_compact) {
+            nbytes += m_slot[mfi].nBytes() + m_records[mfi].size()*sizeof(Real);
+        } else {
+            nbytes += m_data[mfi].nBytes();
+        }
+    }
+    return nbytes;
+}
+
 bool
 MultiCutFab::ok (const MFIter& mfi) const noexcept
 {
@@ -107,6 +290,22 @@ MultiCutFab::ok (int global_box_index) const noexcept
 void
 MultiCutFab::setVal (Real val)
 {
+    if (m_compact) {
+        m_regular_value = val;
+        m_covered_value = val;
+        for (MFIter mfi(m_data); mfi.isValid(); ++mfi) {
+            if (ok(mfi)) {
+                auto& records = m_records[mfi];
+                Real* AMREX_RESTRICT p = records.data();
+                ParallelFor(records.size(), [=] AMREX_GPU_DEVICE (Long i) noexcept
+                {
+                    p[i] = val;
+                });
+            }
+        }
+        return;
+    }
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -126,6 +325,8 @@ MultiCutFab::setVal (Real val)
 void
 MultiCutFab::ParallelCopy (const MultiCutFab& src, int scomp, int dcomp, int ncomp, int sng, int dng, const Periodicity& period)
 {
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_compact && !src.m_compact,
+                                     "MultiCutFab::ParallelCopy: compact storage not supported");
     m_data.ParallelCopy(src.m_data, scomp, dcomp, ncomp, sng, dng, period);
 }
 
@@ -143,7 +344,7 @@ MultiCutFab::ToMultiFab (Real regular_value, Real covered_value) const
         Box const& b = mfi.fabbox();
         Array4<Real> const& d = mf.array(mfi);
         if (t == FabType::singlevalued) {
-            Array4<Real const> const& s = m_data.const_array(mfi);
+            CutArray4 const& s = const_cut_array(mfi);
             AMREX_HOST_DEVICE_PARALLEL_FOR_4D(b, ncomp, i, j, k, n,
             {
                 d(i,j,k,n) = s(i,j,k,n);
@@ -13,6 +13,8 @@ namespace amrex {
 void WriteEBSurface (const BoxArray & ba, const DistributionMapping & dmap, const Geometry & geom,
                      const EBFArrayBoxFactory * ebf) {
 
+    BL_PROFILE("WriteEBSurface()");
+
     EBToPVD eb_to_pvd;
 
     const Real* dx     = geom.CellSize();
@@ -36,22 +38,35 @@ void WriteEBSurface (const BoxArray & ba, const DistributionMapping & dmap, cons
         areafrac  =   ebf->getAreaFrac();
         bndrycent = &(ebf->getBndryCent());
 
+        FArrayBox bcscratch;
+        Array<FArrayBox,AMREX_SPACEDIM> apscratch;
+
         eb_to_pvd.EBToPolygon(
                 problo, dx,
                 bx, my_flag.const_array(),
-                bndrycent->const_array(mfi),
-                areafrac[0]->const_array(mfi),
-                areafrac[1]->const_array(mfi),
-                areafrac[2]->const_array(mfi));
+                bndrycent->const_array(mfi, bcscratch),
+                areafrac[0]->const_array(mfi, apscratch[0]),
+                areafrac[1]->const_array(mfi, apscratch[1]),
+                areafrac[2]->const_array(mfi, apscratch[2]));
     }
 
     int cpu = ParallelDescriptor::MyProc();
-    int nProcs = ParallelDescriptor::NProcs();
 
-    eb_to_pvd.WriteEBVTP(cpu);
+    // Every rank with polygons writes its own piece at the same time.
+    const int has_polygons = eb_to_pvd.numPolygons() > 0;
+    if (has_polygons) {
+        eb_to_pvd.WriteEBVTP(cpu);
+    }
 
-    if(ParallelDescriptor::IOProcessor())
-        eb_to_pvd.WritePVTP(nProcs);
+    const auto all_has_polygons = ParallelDescriptor::Gather(has_polygons,
+                                                             ParallelDescriptor::IOProcessorNumber());
+    if(ParallelDescriptor::IOProcessor()) {
+        Vector<int> procs;
+        for (int i = 0; i < static_cast<int>(all_has_polygons.size()); ++i) {
+            if (all_has_polygons[i]) procs.push_back(i);
+        }
+        eb_to_pvd.WritePVTP(procs);
+    }
 
     for (MFIter mfi(mf_ba); mfi.isValid(); ++mfi) {
 
@@ -60,8 +60,8 @@ compute_integrals (MultiFab& intgmf, IntVect nghost)
         else
         {
             // auto const& vf = vfrac.array(mfi);
-            auto const& bc = bcent.array(mfi);
-            auto const& bn = bnorm.array(mfi);
+            auto const& bc = bcent.const_cut_array(mfi);
+            auto const& bn = bnorm.const_cut_array(mfi);
             auto const& fg = flagfab.array();
 
             if (Gpu::inLaunchRegion())
@@ -243,13 +243,13 @@ compute_surface_integrals (MultiFab& sintgmf, IntVect nghost)
         else
         {
             auto const& vf  = vfrac.array(mfi);
-            auto const& bc  = bcent.array(mfi);
-            auto const& bn  = bnorm.array(mfi);
+            auto const& bc = bcent.const_cut_array(mfi);
+            auto const& bn = bnorm.const_cut_array(mfi);
             auto const& fg  = flagfab.array();
-            auto const& apx = area[0]->const_array(mfi);
-            auto const& apy = area[1]->const_array(mfi);
-            auto const& apz = area[2]->const_array(mfi);
-            auto const& ba  = barea.array(mfi);
+            auto const& apx = area[0]->const_cut_array(mfi);
+            auto const& apy = area[1]->const_cut_array(mfi);
+            auto const& apz = area[2]->const_cut_array(mfi);
+            auto const& ba  = barea.const_cut_array(mfi);
 
             if (Gpu::inLaunchRegion())
             {
@@ -398,14 +398,17 @@ HypreABecLap3::prepareSolver ()
             {
                 auto const& flag_a = flags->const_array(mfi);
                 auto const& vfrac_a = vfrac->const_array(mfi);
-                AMREX_D_TERM(auto const& apx = area[0]->const_array(mfi);,
-                             auto const& apy = area[1]->const_array(mfi);,
-                             auto const& apz = area[2]->const_array(mfi);)
-                AMREX_D_TERM(auto const& fcx = fcent[0]->const_array(mfi);,
-                             auto const& fcy = fcent[1]->const_array(mfi);,
-                             auto const& fcz = fcent[2]->const_array(mfi);)
-                auto const& barea_a = barea->const_array(mfi);
-                auto const& bcent_a = bcent->const_array(mfi);
+                // Compact cut-cell data are expanded box by box into scratch fabs.
+                Array<FArrayBox,AMREX_SPACEDIM> apscratch, fcscratch;
+                FArrayBox bascratch, bcscratch;
+                AMREX_D_TERM(auto const& apx = area[0]->const_array(mfi, apscratch[0]);,
+                             auto const& apy = area[1]->const_array(mfi, apscratch[1]);,
+                             auto const& apz = area[2]->const_array(mfi, apscratch[2]);)
+                AMREX_D_TERM(auto const& fcx = fcent[0]->const_array(mfi, fcscratch[0]);,
+                             auto const& fcy = fcent[1]->const_array(mfi, fcscratch[1]);,
+                             auto const& fcz = fcent[2]->const_array(mfi, fcscratch[2]);)
+                auto const& barea_a = barea->const_array(mfi, bascratch);
+                auto const& bcent_a = bcent->const_array(mfi, bcscratch);
                 Array4<Real const> beb = (m_eb_b_coeffs) ? m_eb_b_coeffs->const_array(mfi)
                                                          : Array4<Real const>();
 
@@ -16,6 +16,10 @@
 #include <sundials/sundials_math.h>
 
 #include "AMReX_NVector_MultiFab.H"
+#include "AMReX_Sundials.H"
+
+#include <AMReX_BatchReduce.H>
+#include <AMReX_GpuAsyncArray.H>
 
 namespace amrex {
 namespace sundials {
@@ -28,10 +32,11 @@ namespace sundials {
 
 
 /* ----------------------------------------------------------------------------
- * Function to create a new empty multifab vector
+ * Function to create a new empty multifab vector in the SUNDIALS context
+ * sunctx, or in the AMReX SUNDIALS context if sunctx is NULL
  */
 
-N_Vector N_VNewEmpty_MultiFab(sunindextype length)
+N_Vector N_VNewEmpty_MultiFab(sunindextype length, SUNContext sunctx)
 {
     N_Vector v;
     N_Vector_Ops ops;
@@ -39,12 +44,13 @@ N_Vector N_VNewEmpty_MultiFab(sunindextype length)
 
     /* Create vector */
     v = NULL;
-    v = (N_Vector) malloc(sizeof *v);
+    v = (N_Vector) calloc(1, sizeof *v);
     if (v == NULL) return(NULL);
 
-    /* Create vector operation structure */
+    /* Create vector operation structure (operations that are not set
+       below are NULL) */
     ops = NULL;
-    ops = (N_Vector_Ops) malloc(sizeof *ops);
+    ops = (N_Vector_Ops) calloc(1, sizeof *ops);
     if (ops == NULL) { free(v); return(NULL); }
 
     ops->nvgetvectorid     = NULL;
@@ -77,7 +83,8 @@ N_Vector N_VNewEmpty_MultiFab(sunindextype length)
     ops->nvconstrmask   = N_VConstrMask_MultiFab;
     ops->nvminquotient  = N_VMinQuotient_MultiFab;
 
-    /* fused vector operations (optional, NULL means disabled by default) */
+    /* fused vector operations (optional, NULL means disabled by default,
+       see N_VEnableFusedOps_MultiFab) */
     ops->nvlinearcombination = NULL;
     ops->nvscaleaddmulti     = NULL;
     ops->nvdotprodmulti      = NULL;
@@ -100,9 +107,10 @@ N_Vector N_VNewEmpty_MultiFab(sunindextype length)
     content->own_mf = SUNFALSE;
     content->mf     = NULL;
 
-    /* Attach content and ops */
+    /* Attach content, ops and context */
     v->content = content;
     v->ops     = ops;
+    v->sunctx  = (sunctx != NULL) ? sunctx : *amrex::sundials::The_Sundials_Context();
 
     return(v);
 }
@@ -115,12 +123,13 @@ N_Vector N_VNew_MultiFab(sunindextype length,
                             const amrex::BoxArray &ba,
                             const amrex::DistributionMapping &dm,
                             sunindextype nComp,
-                            sunindextype nGhost)
+                            sunindextype nGhost,
+                            SUNContext sunctx)
 {
     N_Vector v;
 
     v = NULL;
-    v = N_VNewEmpty_MultiFab(length);
+    v = N_VNewEmpty_MultiFab(length, sunctx);
     if (v == NULL) return(NULL);
 
     // Create and attach new MultiFab
@@ -138,12 +147,13 @@ N_Vector N_VNew_MultiFab(sunindextype length,
  * Function to create a MultiFab N_Vector with user-specific MultiFab
  */
 
-N_Vector N_VMake_MultiFab(sunindextype length, amrex::MultiFab *v_mf)
+N_Vector N_VMake_MultiFab(sunindextype length, amrex::MultiFab *v_mf,
+                          SUNContext sunctx)
 {
     N_Vector v;
 
     v = NULL;
-    v = N_VNewEmpty_MultiFab(length);
+    v = N_VNewEmpty_MultiFab(length, sunctx);
     if (v == NULL) return(NULL);
 
     if (length > 0)
@@ -202,12 +212,13 @@ N_Vector N_VCloneEmpty_MultiFab(N_Vector w)
 
     /* Create vector */
     v = NULL;
-    v = (N_Vector) malloc(sizeof *v);
+    v = (N_Vector) calloc(1, sizeof *v);
     if (v == NULL) return(NULL);
 
-    /* Create vector operation structure */
+    /* Create vector operation structure (operations that are not set
+       below are NULL) */
     ops = NULL;
-    ops = (N_Vector_Ops) malloc(sizeof *ops);
+    ops = (N_Vector_Ops) calloc(1, sizeof *ops);
     if (ops == NULL) { free(v); return(NULL); }
 
     ops->nvgetvectorid     = w->ops->nvgetvectorid;
@@ -263,9 +274,10 @@ N_Vector N_VCloneEmpty_MultiFab(N_Vector w)
     content->own_mf = SUNFALSE;
     content->mf     = NULL;
 
-    /* Attach content and ops */
+    /* Attach content, ops and context */
     v->content = content;
     v->ops     = ops;
+    v->sunctx  = w->sunctx;
 
     return(v);
 }
@@ -538,7 +550,10 @@ amrex::Real N_VMin_MultiFab(N_Vector x)
     return min;
 }
 
-amrex::Real NormHelper_NVector_MultiFab(N_Vector x, N_Vector w, N_Vector id, int use_id, bool rms)
+namespace {
+
+/* Local part of the weighted sum of squares, without ghost cells */
+amrex::Real WSqrSumLocal_MultiFab(N_Vector x, N_Vector w, N_Vector id, int use_id)
 {
     using namespace amrex;
 
@@ -547,7 +562,6 @@ amrex::Real NormHelper_NVector_MultiFab(N_Vector x, N_Vector w, N_Vector id, int
     MultiFab *mf_y = amrex::sundials::getMFptr(w);
     MultiFab *mf_id = use_id ? amrex::sundials::getMFptr(id) : NULL;
     sunindextype numcomp = mf_x->nComp();
-    sunindextype N = amrex::sundials::N_VGetLength_MultiFab(x);
     bool local = true;
     IntVect nghost = amrex::IntVect::TheZeroVector();
     Real sum = 0;
@@ -567,6 +581,18 @@ amrex::Real NormHelper_NVector_MultiFab(N_Vector x, N_Vector w, N_Vector id, int
                                 *mf_y, ycomp,
                                 [=] AMREX_GPU_HOST_DEVICE (amrex::Real x, amrex::Real y) -> amrex::Real { return x*x*y*y; },
                                 numcomp, nghost, local);
+
+    return sum;
+}
+
+}
+
+amrex::Real NormHelper_NVector_MultiFab(N_Vector x, N_Vector w, N_Vector id, int use_id, bool rms)
+{
+    using namespace amrex;
+
+    sunindextype N = amrex::sundials::N_VGetLength_MultiFab(x);
+    Real sum = WSqrSumLocal_MultiFab(x, w, id, use_id);
     ParallelDescriptor::ReduceRealSum(sum);
 
     return rms ? SUNRsqrt(sum/N) : SUNRsqrt(sum);
@@ -576,7 +602,7 @@ amrex::Real N_VWL2Norm_MultiFab(N_Vector x, N_Vector w)
 {
     using namespace amrex;
 
-    return NormHelper_NVector_MultiFab(x, w, N_VCloneEmpty_MultiFab(x), false, false);
+    return NormHelper_NVector_MultiFab(x, w, NULL, false, false);
 }
 
 amrex::Real N_VL1Norm_MultiFab(N_Vector x)
@@ -746,5 +772,385 @@ amrex::Real N_VMinQuotient_MultiFab(N_Vector num, N_Vector denom)
     return min;
 }
 
+/*
+ * -----------------------------------------------------------------
+ * fused vector operations
+ * -----------------------------------------------------------------
+ *
+ * Each of these is a single pass over the data.  At every point, the
+ * vectors are read and written in the same order as in the equivalent
+ * sequence of standard operations, so that the output vectors may be
+ * the same as some of the input vectors like SUNDIALS allows.  Ghost
+ * cells are not included.
+ */
+
+namespace {
+
+amrex::Vector<amrex::MultiArray4<amrex::Real const> >
+ConstArrays_MultiFab(int nvec, N_Vector const* V)
+{
+    amrex::Vector<amrex::MultiArray4<amrex::Real const> > r(nvec);
+    for (int i = 0; i < nvec; ++i) {
+        r[i] = amrex::sundials::getMFptr(V[i])->const_arrays();
+    }
+    return r;
+}
+
+amrex::Vector<amrex::MultiArray4<amrex::Real> >
+Arrays_MultiFab(int nvec, N_Vector const* V)
+{
+    amrex::Vector<amrex::MultiArray4<amrex::Real> > r(nvec);
+    for (int i = 0; i < nvec; ++i) {
+        r[i] = amrex::sundials::getMFptr(V[i])->arrays();
+    }
+    return r;
+}
+
+}
+
+int N_VLinearCombination_MultiFab(int nvec, amrex::Real* c, N_Vector* X, N_Vector z)
+{
+    using namespace amrex;
+
+    if (nvec < 1) return(-1);
+
+    MultiFab *mf_z = amrex::sundials::getMFptr(z);
+    sunindextype ncomp = mf_z->nComp();
+
+    auto const& hx = ConstArrays_MultiFab(nvec, X);
+    Gpu::AsyncArray<MultiArray4<Real const> > dx(hx.data(), nvec);
+    Gpu::AsyncArray<Real> dc(c, nvec);
+    auto const* xa = dx.data();
+    auto const* cc = dc.data();
+    auto const& za = mf_z->arrays();
+
+    // z = sum_i c[i]*X[i]
+    amrex::ParallelFor(*mf_z, IntVect(0), ncomp,
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+    {
+        Real r = cc[0] * xa[0][box_no](i,j,k,n);
+        for (int m = 1; m < nvec; ++m) {
+            r += cc[m] * xa[m][box_no](i,j,k,n);
+        }
+        za[box_no](i,j,k,n) = r;
+    });
+    Gpu::streamSynchronize();
+
+    return(0);
+}
+
+int N_VScaleAddMulti_MultiFab(int nvec, amrex::Real* a, N_Vector x, N_Vector* Y, N_Vector* Z)
+{
+    using namespace amrex;
+
+    if (nvec < 1) return(-1);
+
+    MultiFab *mf_x = amrex::sundials::getMFptr(x);
+    sunindextype ncomp = mf_x->nComp();
+
+    auto const& hy = ConstArrays_MultiFab(nvec, Y);
+    auto const& hz = Arrays_MultiFab(nvec, Z);
+    Gpu::AsyncArray<MultiArray4<Real const> > dy(hy.data(), nvec);
+    Gpu::AsyncArray<MultiArray4<Real> > dz(hz.data(), nvec);
+    Gpu::AsyncArray<Real> da(a, nvec);
+    auto const* ya = dy.data();
+    auto const* za = dz.data();
+    auto const* aa = da.data();
+    auto const& xa = mf_x->const_arrays();
+
+    // Z[i] = a[i]*x + Y[i]
+    amrex::ParallelFor(*mf_x, IntVect(0), ncomp,
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+    {
+        for (int m = 0; m < nvec; ++m) {
+            za[m][box_no](i,j,k,n) = aa[m] * xa[box_no](i,j,k,n) + ya[m][box_no](i,j,k,n);
+        }
+    });
+    Gpu::streamSynchronize();
+
+    return(0);
+}
+
+int N_VDotProdMulti_MultiFab(int nvec, N_Vector x, N_Vector* Y, amrex::Real* dotprods)
+{
+    using namespace amrex;
+
+    if (nvec < 1) return(-1);
+
+    MultiFab *mf_x = amrex::sundials::getMFptr(x);
+    sunindextype ncomp = mf_x->nComp();
+    sunindextype nghost = 0;  // do not include ghost cells in dot product
+
+    // x is read once for all the dot products, which share one reduction
+    BatchReduce br;
+    for (int m = 0; m < nvec; ++m) {
+        br.addDot(*mf_x, 0, *amrex::sundials::getMFptr(Y[m]), 0, ncomp, nghost);
+    }
+    br.compute();
+
+    for (int m = 0; m < nvec; ++m) {
+        dotprods[m] = br[m];
+    }
+
+    return(0);
+}
+
+/*
+ * -----------------------------------------------------------------
+ * vector array operations
+ * -----------------------------------------------------------------
+ */
+
+int N_VLinearSumVectorArray_MultiFab(int nvec, amrex::Real a, N_Vector* X,
+                                     amrex::Real b, N_Vector* Y, N_Vector* Z)
+{
+    using namespace amrex;
+
+    if (nvec < 1) return(-1);
+
+    MultiFab *mf_z = amrex::sundials::getMFptr(Z[0]);
+    sunindextype ncomp = mf_z->nComp();
+
+    auto const& hx = ConstArrays_MultiFab(nvec, X);
+    auto const& hy = ConstArrays_MultiFab(nvec, Y);
+    auto const& hz = Arrays_MultiFab(nvec, Z);
+    Gpu::AsyncArray<MultiArray4<Real const> > dx(hx.data(), nvec);
+    Gpu::AsyncArray<MultiArray4<Real const> > dy(hy.data(), nvec);
+    Gpu::AsyncArray<MultiArray4<Real> > dz(hz.data(), nvec);
+    auto const* xa = dx.data();
+    auto const* ya = dy.data();
+    auto const* za = dz.data();
+
+    // Z[i] = a*X[i] + b*Y[i]
+    amrex::ParallelFor(*mf_z, IntVect(0), ncomp,
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+    {
+        for (int m = 0; m < nvec; ++m) {
+            za[m][box_no](i,j,k,n) = a * xa[m][box_no](i,j,k,n) + b * ya[m][box_no](i,j,k,n);
+        }
+    });
+    Gpu::streamSynchronize();
+
+    return(0);
+}
+
+int N_VScaleVectorArray_MultiFab(int nvec, amrex::Real* c, N_Vector* X, N_Vector* Z)
+{
+    using namespace amrex;
+
+    if (nvec < 1) return(-1);
+
+    MultiFab *mf_z = amrex::sundials::getMFptr(Z[0]);
+    sunindextype ncomp = mf_z->nComp();
+
+    auto const& hx = ConstArrays_MultiFab(nvec, X);
+    auto const& hz = Arrays_MultiFab(nvec, Z);
+    Gpu::AsyncArray<MultiArray4<Real const> > dx(hx.data(), nvec);
+    Gpu::AsyncArray<MultiArray4<Real> > dz(hz.data(), nvec);
+    Gpu::AsyncArray<Real> dc(c, nvec);
+    auto const* xa = dx.data();
+    auto const* za = dz.data();
+    auto const* cc = dc.data();
+
+    // Z[i] = c[i]*X[i]
+    amrex::ParallelFor(*mf_z, IntVect(0), ncomp,
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+    {
+        for (int m = 0; m < nvec; ++m) {
+            za[m][box_no](i,j,k,n) = cc[m] * xa[m][box_no](i,j,k,n);
+        }
+    });
+    Gpu::streamSynchronize();
+
+    return(0);
+}
+
+int N_VConstVectorArray_MultiFab(int nvec, amrex::Real c, N_Vector* Z)
+{
+    using namespace amrex;
+
+    if (nvec < 1) return(-1);
+
+    MultiFab *mf_z = amrex::sundials::getMFptr(Z[0]);
+    sunindextype ncomp = mf_z->nComp();
+
+    auto const& hz = Arrays_MultiFab(nvec, Z);
+    Gpu::AsyncArray<MultiArray4<Real> > dz(hz.data(), nvec);
+    auto const* za = dz.data();
+
+    // Z[i] = c
+    amrex::ParallelFor(*mf_z, IntVect(0), ncomp,
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+    {
+        for (int m = 0; m < nvec; ++m) {
+            za[m][box_no](i,j,k,n) = c;
+        }
+    });
+    Gpu::streamSynchronize();
+
+    return(0);
+}
+
+int N_VWrmsNormVectorArray_MultiFab(int nvec, N_Vector* X, N_Vector* W, amrex::Real* nrm)
+{
+    using namespace amrex;
+
+    if (nvec < 1) return(-1);
+
+    // All the norms share one reduction
+    BatchReduce br;
+    for (int m = 0; m < nvec; ++m) {
+        br.addLocalSum(WSqrSumLocal_MultiFab(X[m], W[m], NULL, false));
+    }
+    br.compute();
+
+    for (int m = 0; m < nvec; ++m) {
+        sunindextype N = amrex::sundials::N_VGetLength_MultiFab(X[m]);
+        nrm[m] = SUNRsqrt(br[m]/N);
+    }
+
+    return(0);
+}
+
+int N_VWrmsNormMaskVectorArray_MultiFab(int nvec, N_Vector* X, N_Vector* W,
+                                        N_Vector id, amrex::Real* nrm)
+{
+    using namespace amrex;
+
+    if (nvec < 1) return(-1);
+
+    // All the norms share one reduction
+    BatchReduce br;
+    for (int m = 0; m < nvec; ++m) {
+        br.addLocalSum(WSqrSumLocal_MultiFab(X[m], W[m], id, true));
+    }
+    br.compute();
+
+    for (int m = 0; m < nvec; ++m) {
+        sunindextype N = amrex::sundials::N_VGetLength_MultiFab(X[m]);
+        nrm[m] = SUNRsqrt(br[m]/N);
+    }
+
+    return(0);
+}
+
+int N_VScaleAddMultiVectorArray_MultiFab(int nvec, int nsum, amrex::Real* a,
+                                         N_Vector* X, N_Vector** Y, N_Vector** Z)
+{
+    using namespace amrex;
+
+    if (nvec < 1 || nsum < 1) return(-1);
+
+    MultiFab *mf_x = amrex::sundials::getMFptr(X[0]);
+    sunindextype ncomp = mf_x->nComp();
+
+    // Y[j][i] and Z[j][i] are stored at j*nvec+i
+    Vector<N_Vector> Yflat, Zflat;
+    for (int j = 0; j < nsum; ++j) {
+        Yflat.insert(Yflat.end(), Y[j], Y[j]+nvec);
+        Zflat.insert(Zflat.end(), Z[j], Z[j]+nvec);
+    }
+
+    auto const& hx = ConstArrays_MultiFab(nvec, X);
+    auto const& hy = ConstArrays_MultiFab(nvec*nsum, Yflat.data());
+    auto const& hz = Arrays_MultiFab(nvec*nsum, Zflat.data());
+    Gpu::AsyncArray<MultiArray4<Real const> > dx(hx.data(), nvec);
+    Gpu::AsyncArray<MultiArray4<Real const> > dy(hy.data(), nvec*nsum);
+    Gpu::AsyncArray<MultiArray4<Real> > dz(hz.data(), nvec*nsum);
+    Gpu::AsyncArray<Real> da(a, nsum);
+    auto const* xa = dx.data();
+    auto const* ya = dy.data();
+    auto const* za = dz.data();
+    auto const* aa = da.data();
+
+    // Z[j][i] = a[j]*X[i] + Y[j][i]
+    amrex::ParallelFor(*mf_x, IntVect(0), ncomp,
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+    {
+        for (int iv = 0; iv < nvec; ++iv) {
+            for (int js = 0; js < nsum; ++js) {
+                const int m = js*nvec + iv;
+                za[m][box_no](i,j,k,n) = aa[js] * xa[iv][box_no](i,j,k,n) + ya[m][box_no](i,j,k,n);
+            }
+        }
+    });
+    Gpu::streamSynchronize();
+
+    return(0);
+}
+
+int N_VLinearCombinationVectorArray_MultiFab(int nvec, int nsum, amrex::Real* c,
+                                             N_Vector** X, N_Vector* Z)
+{
+    using namespace amrex;
+
+    if (nvec < 1 || nsum < 1) return(-1);
+
+    MultiFab *mf_z = amrex::sundials::getMFptr(Z[0]);
+    sunindextype ncomp = mf_z->nComp();
+
+    // X[j][i] is stored at j*nvec+i
+    Vector<N_Vector> Xflat;
+    for (int j = 0; j < nsum; ++j) {
+        Xflat.insert(Xflat.end(), X[j], X[j]+nvec);
+    }
+
+    auto const& hx = ConstArrays_MultiFab(nvec*nsum, Xflat.data());
+    auto const& hz = Arrays_MultiFab(nvec, Z);
+    Gpu::AsyncArray<MultiArray4<Real const> > dx(hx.data(), nvec*nsum);
+    Gpu::AsyncArray<MultiArray4<Real> > dz(hz.data(), nvec);
+    Gpu::AsyncArray<Real> dc(c, nsum);
+    auto const* xa = dx.data();
+    auto const* za = dz.data();
+    auto const* cc = dc.data();
+
+    // Z[i] = sum_j c[j]*X[j][i]
+    amrex::ParallelFor(*mf_z, IntVect(0), ncomp,
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+    {
+        for (int iv = 0; iv < nvec; ++iv) {
+            Real r = cc[0] * xa[iv][box_no](i,j,k,n);
+            for (int js = 1; js < nsum; ++js) {
+                r += cc[js] * xa[js*nvec+iv][box_no](i,j,k,n);
+            }
+            za[iv][box_no](i,j,k,n) = r;
+        }
+    });
+    Gpu::streamSynchronize();
+
+    return(0);
+}
+
+int N_VEnableFusedOps_MultiFab(N_Vector v, booleantype tf)
+{
+    if (v == NULL || v->ops == NULL) return(-1);
+
+    if (tf) {
+        v->ops->nvlinearcombination            = N_VLinearCombination_MultiFab;
+        v->ops->nvscaleaddmulti                = N_VScaleAddMulti_MultiFab;
+        v->ops->nvdotprodmulti                 = N_VDotProdMulti_MultiFab;
+        v->ops->nvlinearsumvectorarray         = N_VLinearSumVectorArray_MultiFab;
+        v->ops->nvscalevectorarray             = N_VScaleVectorArray_MultiFab;
+        v->ops->nvconstvectorarray             = N_VConstVectorArray_MultiFab;
+        v->ops->nvwrmsnormvectorarray          = N_VWrmsNormVectorArray_MultiFab;
+        v->ops->nvwrmsnormmaskvectorarray      = N_VWrmsNormMaskVectorArray_MultiFab;
+        v->ops->nvscaleaddmultivectorarray     = N_VScaleAddMultiVectorArray_MultiFab;
+        v->ops->nvlinearcombinationvectorarray = N_VLinearCombinationVectorArray_MultiFab;
+    } else {
+        v->ops->nvlinearcombination            = NULL;
+        v->ops->nvscaleaddmulti                = NULL;
+        v->ops->nvdotprodmulti                 = NULL;
+        v->ops->nvlinearsumvectorarray         = NULL;
+        v->ops->nvscalevectorarray             = NULL;
+        v->ops->nvconstvectorarray             = NULL;
+        v->ops->nvwrmsnormvectorarray          = NULL;
+        v->ops->nvwrmsnormmaskvectorarray      = NULL;
+        v->ops->nvscaleaddmultivectorarray     = NULL;
+        v->ops->nvlinearcombinationvectorarray = NULL;
+    }
+
+    return(0);
+}
+
 }
 }
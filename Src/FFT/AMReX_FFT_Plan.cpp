@@ -0,0 +1,452 @@
+
+#include <AMReX_FFT_Plan.H>
+#include <AMReX_BLassert.H>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace amrex {
+namespace FFT {
+
+namespace {
+
+// In a pass of radix ip, the input is CC(i,j,k) = cc[i+ido*(j+ip*k)] and
+// the output is CH(i,k,u) = ch[i+ido*(k+l1*u)], with i < ido, j,u < ip and
+// k < l1.  Each element is a batch of B values.  Output u is multiplied by
+// the twiddle factor tw[(u-1)*ido+i].  s is -1 for the forward transform
+// and +1 for the backward transform.
+
+void pass2 (int ido, int l1, int B, Real s,
+            Real const* AMREX_RESTRICT ar, Real const* AMREX_RESTRICT ai,
+            Real* AMREX_RESTRICT cr, Real* AMREX_RESTRICT ci,
+            Real const* twr, Real const* twi)
+{
+    const int ao = ido*B;     // input offset between j and j+1
+    const int co = ido*l1*B;  // output offset between u and u+1
+    for (int k = 0; k < l1; ++k) {
+        for (int i = 0; i < ido; ++i) {
+            Real const* a0r = ar + (i+ido*2*k)*B;
+            Real const* a0i = ai + (i+ido*2*k)*B;
+            Real* c0r = cr + (i+ido*k)*B;
+            Real* c0i = ci + (i+ido*k)*B;
+            const Real t1r = twr[i], t1i = -s*twi[i];
+            AMREX_PRAGMA_SIMD
+            for (int b = 0; b < B; ++b) {
+                const Real xr = a0r[b] - a0r[ao+b];
+                const Real xi = a0i[b] - a0i[ao+b];
+                c0r[b] = a0r[b] + a0r[ao+b];
+                c0i[b] = a0i[b] + a0i[ao+b];
+                c0r[co+b] = xr*t1r - xi*t1i;
+                c0i[co+b] = xr*t1i + xi*t1r;
+            }
+        }
+    }
+}
+
+void pass3 (int ido, int l1, int B, Real s,
+            Real const* AMREX_RESTRICT ar, Real const* AMREX_RESTRICT ai,
+            Real* AMREX_RESTRICT cr, Real* AMREX_RESTRICT ci,
+            Real const* twr, Real const* twi)
+{
+    constexpr Real half = Real(0.5);
+    const Real h = s*Real(0.866025403784438646763723170752936183);  // s*sin(2pi/3)
+    const int ao = ido*B;
+    const int co = ido*l1*B;
+    for (int k = 0; k < l1; ++k) {
+        for (int i = 0; i < ido; ++i) {
+            Real const* a0r = ar + (i+ido*3*k)*B;
+            Real const* a0i = ai + (i+ido*3*k)*B;
+            Real* c0r = cr + (i+ido*k)*B;
+            Real* c0i = ci + (i+ido*k)*B;
+            const Real t1r = twr[i],     t1i = -s*twi[i];
+            const Real t2r = twr[ido+i], t2i = -s*twi[ido+i];
+            AMREX_PRAGMA_SIMD
+            for (int b = 0; b < B; ++b) {
+                const Real sr = a0r[ao+b] + a0r[2*ao+b];
+                const Real si = a0i[ao+b] + a0i[2*ao+b];
+                const Real dr = a0r[ao+b] - a0r[2*ao+b];
+                const Real di = a0i[ao+b] - a0i[2*ao+b];
+                const Real mr = a0r[b] - half*sr;
+                const Real mi = a0i[b] - half*si;
+                const Real y1r = mr - h*di, y1i = mi + h*dr;
+                const Real y2r = mr + h*di, y2i = mi - h*dr;
+                c0r[b] = a0r[b] + sr;
+                c0i[b] = a0i[b] + si;
+                c0r[co+b] = y1r*t1r - y1i*t1i;
+                c0i[co+b] = y1r*t1i + y1i*t1r;
+                c0r[2*co+b] = y2r*t2r - y2i*t2i;
+                c0i[2*co+b] = y2r*t2i + y2i*t2r;
+            }
+        }
+    }
+}
+
+void pass4 (int ido, int l1, int B, Real s,
+            Real const* AMREX_RESTRICT ar, Real const* AMREX_RESTRICT ai,
+            Real* AMREX_RESTRICT cr, Real* AMREX_RESTRICT ci,
+            Real const* twr, Real const* twi)
+{
+    const int ao = ido*B;
+    const int co = ido*l1*B;
+    for (int k = 0; k < l1; ++k) {
+        for (int i = 0; i < ido; ++i) {
+            Real const* a0r = ar + (i+ido*4*k)*B;
+            Real const* a0i = ai + (i+ido*4*k)*B;
+            Real* c0r = cr + (i+ido*k)*B;
+            Real* c0i = ci + (i+ido*k)*B;
+            const Real t1r = twr[i],       t1i = -s*twi[i];
+            const Real t2r = twr[ido+i],   t2i = -s*twi[ido+i];
+            const Real t3r = twr[2*ido+i], t3i = -s*twi[2*ido+i];
+            AMREX_PRAGMA_SIMD
+            for (int b = 0; b < B; ++b) {
+                const Real p0r = a0r[b] + a0r[2*ao+b];
+                const Real p0i = a0i[b] + a0i[2*ao+b];
+                const Real p1r = a0r[b] - a0r[2*ao+b];
+                const Real p1i = a0i[b] - a0i[2*ao+b];
+                const Real p2r = a0r[ao+b] + a0r[3*ao+b];
+                const Real p2i = a0i[ao+b] + a0i[3*ao+b];
+                // (s*i) * (a1-a3)
+                const Real p3r = -s*(a0i[ao+b] - a0i[3*ao+b]);
+                const Real p3i =  s*(a0r[ao+b] - a0r[3*ao+b]);
+                const Real y1r = p1r + p3r, y1i = p1i + p3i;
+                const Real y2r = p0r - p2r, y2i = p0i - p2i;
+                const Real y3r = p1r - p3r, y3i = p1i - p3i;
+                c0r[b] = p0r + p2r;
+                c0i[b] = p0i + p2i;
+                c0r[co+b] = y1r*t1r - y1i*t1i;
+                c0i[co+b] = y1r*t1i + y1i*t1r;
+                c0r[2*co+b] = y2r*t2r - y2i*t2i;
+                c0i[2*co+b] = y2r*t2i + y2i*t2r;
+                c0r[3*co+b] = y3r*t3r - y3i*t3i;
+                c0i[3*co+b] = y3r*t3i + y3i*t3r;
+            }
+        }
+    }
+}
+
+void pass5 (int ido, int l1, int B, Real s,
+            Real const* AMREX_RESTRICT ar, Real const* AMREX_RESTRICT ai,
+            Real* AMREX_RESTRICT cr, Real* AMREX_RESTRICT ci,
+            Real const* twr, Real const* twi)
+{
+    constexpr Real c1 = Real( 0.309016994374947424102293417182819059);  // cos(2pi/5)
+    constexpr Real c2 = Real(-0.809016994374947424102293417182819059);  // cos(4pi/5)
+    const Real s1 = s*Real(0.951056516295153572116439333379382143);     // s*sin(2pi/5)
+    const Real s2 = s*Real(0.587785252292473129168705954639072769);     // s*sin(4pi/5)
+    const int ao = ido*B;
+    const int co = ido*l1*B;
+    for (int k = 0; k < l1; ++k) {
+        for (int i = 0; i < ido; ++i) {
+            Real const* a0r = ar + (i+ido*5*k)*B;
+            Real const* a0i = ai + (i+ido*5*k)*B;
+            Real* c0r = cr + (i+ido*k)*B;
+            Real* c0i = ci + (i+ido*k)*B;
+            const Real t1r = twr[i],       t1i = -s*twi[i];
+            const Real t2r = twr[ido+i],   t2i = -s*twi[ido+i];
+            const Real t3r = twr[2*ido+i], t3i = -s*twi[2*ido+i];
+            const Real t4r = twr[3*ido+i], t4i = -s*twi[3*ido+i];
+            AMREX_PRAGMA_SIMD
+            for (int b = 0; b < B; ++b) {
+                const Real x0r = a0r[b], x0i = a0i[b];
+                const Real p1r = a0r[ao+b] + a0r[4*ao+b];
+                const Real p1i = a0i[ao+b] + a0i[4*ao+b];
+                const Real m1r = a0r[ao+b] - a0r[4*ao+b];
+                const Real m1i = a0i[ao+b] - a0i[4*ao+b];
+                const Real p2r = a0r[2*ao+b] + a0r[3*ao+b];
+                const Real p2i = a0i[2*ao+b] + a0i[3*ao+b];
+                const Real m2r = a0r[2*ao+b] - a0r[3*ao+b];
+                const Real m2i = a0i[2*ao+b] - a0i[3*ao+b];
+                const Real e1r = x0r + c1*p1r + c2*p2r;
+                const Real e1i = x0i + c1*p1i + c2*p2i;
+                const Real e2r = x0r + c2*p1r + c1*p2r;
+                const Real e2i = x0i + c2*p1i + c1*p2i;
+                // i*(s1*m1 + s2*m2) and i*(s2*m1 - s1*m2)
+                const Real f1r = -(s1*m1i + s2*m2i), f1i = s1*m1r + s2*m2r;
+                const Real f2r = -(s2*m1i - s1*m2i), f2i = s2*m1r - s1*m2r;
+                const Real y1r = e1r + f1r, y1i = e1i + f1i;
+                const Real y4r = e1r - f1r, y4i = e1i - f1i;
+                const Real y2r = e2r + f2r, y2i = e2i + f2i;
+                const Real y3r = e2r - f2r, y3i = e2i - f2i;
+                c0r[b] = x0r + p1r + p2r;
+                c0i[b] = x0i + p1i + p2i;
+                c0r[co+b] = y1r*t1r - y1i*t1i;
+                c0i[co+b] = y1r*t1i + y1i*t1r;
+                c0r[2*co+b] = y2r*t2r - y2i*t2i;
+                c0i[2*co+b] = y2r*t2i + y2i*t2r;
+                c0r[3*co+b] = y3r*t3r - y3i*t3i;
+                c0i[3*co+b] = y3r*t3i + y3i*t3r;
+                c0r[4*co+b] = y4r*t4r - y4i*t4i;
+                c0i[4*co+b] = y4r*t4i + y4i*t4r;
+            }
+        }
+    }
+}
+
+// Direct DFT of length ip for the remaining prime factors.
+void passg (int ip, int ido, int l1, int B, Real s,
+            Real const* AMREX_RESTRICT ar, Real const* AMREX_RESTRICT ai,
+            Real* AMREX_RESTRICT cr, Real* AMREX_RESTRICT ci,
+            Real const* twr, Real const* twi, Real const* rtr, Real const* rti)
+{
+    const int ao = ido*B;
+    const int co = ido*l1*B;
+    for (int k = 0; k < l1; ++k) {
+        for (int i = 0; i < ido; ++i) {
+            Real const* a0r = ar + (i+ido*ip*k)*B;
+            Real const* a0i = ai + (i+ido*ip*k)*B;
+            Real* c0r = cr + (i+ido*k)*B;
+            Real* c0i = ci + (i+ido*k)*B;
+            for (int u = 0; u < ip; ++u) {
+                Real* AMREX_RESTRICT yr = c0r + u*co;
+                Real* AMREX_RESTRICT yi = c0i + u*co;
+                AMREX_PRAGMA_SIMD
+                for (int b = 0; b < B; ++b) {
+                    yr[b] = a0r[b];
+                    yi[b] = a0i[b];
+                }
+                for (int j = 1; j < ip; ++j) {
+                    const int m = (u*j) % ip;
+                    const Real wr = rtr[m], wi = -s*rti[m];
+                    Real const* AMREX_RESTRICT xr = a0r + j*ao;
+                    Real const* AMREX_RESTRICT xi = a0i + j*ao;
+                    AMREX_PRAGMA_SIMD
+                    for (int b = 0; b < B; ++b) {
+                        yr[b] += xr[b]*wr - xi[b]*wi;
+                        yi[b] += xr[b]*wi + xi[b]*wr;
+                    }
+                }
+                if (u > 0) {
+                    const Real tr = twr[(u-1)*ido+i], ti = -s*twi[(u-1)*ido+i];
+                    AMREX_PRAGMA_SIMD
+                    for (int b = 0; b < B; ++b) {
+                        const Real zr = yr[b], zi = yi[b];
+                        yr[b] = zr*tr - zi*ti;
+                        yi[b] = zr*ti + zi*tr;
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
+
+Plan::Plan (int n)
+    : m_n(n)
+{
+    AMREX_ALWAYS_ASSERT(n > 0);
+
+    Vector<int> factors;
+    int m = n;
+    while (m % 4 == 0) { factors.push_back(4); m /= 4; }
+    while (m % 2 == 0) { factors.push_back(2); m /= 2; }
+    for (int p = 3; m > 1; p += 2) {
+        while (m % p == 0) { factors.push_back(p); m /= p; }
+        if (p*p > m && m > 1) { factors.push_back(m); m = 1; }
+    }
+
+    const double twopi = 6.283185307179586476925286766559005768;
+    int l1 = 1;
+    for (int ip : factors) {
+        Pass pass;
+        pass.ip = ip;
+        pass.l1 = l1;
+        pass.ido = n/(l1*ip);
+        pass.tw = static_cast<int>(m_twr.size());
+        pass.rt = static_cast<int>(m_rtr.size());
+        for (int u = 1; u < ip; ++u) {
+            for (int i = 0; i < pass.ido; ++i) {
+                // Reduce the angle modulo 2 pi exactly before evaluating it.
+                const long long r = (static_cast<long long>(u)*l1*i) % n;
+                const double theta = twopi*static_cast<double>(r)/static_cast<double>(n);
+                m_twr.push_back(static_cast<Real>(std::cos(theta)));
+                m_twi.push_back(static_cast<Real>(-std::sin(theta)));
+            }
+        }
+        if (ip > 5) {
+            for (int j = 0; j < ip; ++j) {
+                const double theta = twopi*static_cast<double>(j)/static_cast<double>(ip);
+                m_rtr.push_back(static_cast<Real>(std::cos(theta)));
+                m_rti.push_back(static_cast<Real>(-std::sin(theta)));
+            }
+        }
+        m_passes.push_back(pass);
+        l1 *= ip;
+    }
+}
+
+void
+Plan::compute (Direction dir, Real* re, Real* im, Real* wre, Real* wim, int B) const
+{
+    const Real s = (dir == Direction::forward) ? Real(-1.) : Real(1.);
+
+    Real* ar = re;
+    Real* ai = im;
+    Real* cr = wre;
+    Real* ci = wim;
+    for (auto const& p : m_passes) {
+        Real const* twr = m_twr.data() + p.tw;
+        Real const* twi = m_twi.data() + p.tw;
+        switch (p.ip) {
+        case 2:
+            pass2(p.ido, p.l1, B, s, ar, ai, cr, ci, twr, twi);
+            break;
+        case 3:
+            pass3(p.ido, p.l1, B, s, ar, ai, cr, ci, twr, twi);
+            break;
+        case 4:
+            pass4(p.ido, p.l1, B, s, ar, ai, cr, ci, twr, twi);
+            break;
+        case 5:
+            pass5(p.ido, p.l1, B, s, ar, ai, cr, ci, twr, twi);
+            break;
+        default:
+            passg(p.ip, p.ido, p.l1, B, s, ar, ai, cr, ci, twr, twi,
+                  m_rtr.data() + p.rt, m_rti.data() + p.rt);
+        }
+        std::swap(ar, cr);
+        std::swap(ai, ci);
+    }
+
+    if (ar != re) {
+        std::copy(ar, ar + m_n*B, re);
+        std::copy(ai, ai + m_n*B, im);
+    }
+}
+
+RealPlan::RealPlan (int n)
+    : m_n(n),
+      m_plan((n % 2 == 0) ? n/2 : n)
+{
+    const double twopi = 6.283185307179586476925286766559005768;
+    if (n % 2 == 0) {
+        for (int k = 0; k <= n/2; ++k) {
+            const double theta = twopi*static_cast<double>(k)/static_cast<double>(n);
+            m_wr.push_back(static_cast<Real>(std::cos(theta)));
+            m_wi.push_back(static_cast<Real>(-std::sin(theta)));
+        }
+    }
+}
+
+void
+RealPlan::forward (Real const* in, Real* re, Real* im, Real* wre, Real* wim, int B) const
+{
+    if (m_n % 2 == 1) {
+        std::copy(in, in + m_n*B, re);
+        std::fill(im, im + m_n*B, Real(0.));
+        m_plan.compute(Direction::forward, re, im, wre, wim, B);
+        return;
+    }
+
+    // Pack the even and odd samples into one complex sequence of length h.
+    const int h = m_n/2;
+    for (int m = 0; m < h; ++m) {
+        Real const* AMREX_RESTRICT x0 = in + 2*m*B;
+        Real* AMREX_RESTRICT zr = re + m*B;
+        Real* AMREX_RESTRICT zi = im + m*B;
+        AMREX_PRAGMA_SIMD
+        for (int b = 0; b < B; ++b) {
+            zr[b] = x0[b];
+            zi[b] = x0[B+b];
+        }
+    }
+
+    m_plan.compute(Direction::forward, re, im, wre, wim, B);
+
+    // With E and O the transforms of the even and odd samples,
+    // X[k] = E[k] + w^k O[k], and X[h-k] = conj(E[k]) + w^(h-k) conj(O[k]).
+    for (int k = 0; k <= h/2; ++k) {
+        const int k2 = h-k;
+        Real* xr = re + k*B;
+        Real* xi = im + k*B;
+        Real* x2r = re + k2*B;
+        Real* x2i = im + k2*B;
+        Real const* z2r = re + (k2 % h)*B;
+        Real const* z2i = im + (k2 % h)*B;
+        const Real w1r = m_wr[k],  w1i = m_wi[k];
+        const Real w2r = m_wr[k2], w2i = m_wi[k2];
+        for (int b = 0; b < B; ++b) {
+            const Real zkr = xr[b], zki = xi[b];
+            const Real zmr = z2r[b], zmi = -z2i[b];   // conj(Z[h-k])
+            const Real er = Real(0.5)*(zkr + zmr);
+            const Real ei = Real(0.5)*(zki + zmi);
+            const Real orr =  Real(0.5)*(zki - zmi);
+            const Real oi  = -Real(0.5)*(zkr - zmr);
+            xr[b] = er + (w1r*orr - w1i*oi);
+            xi[b] = ei + (w1r*oi + w1i*orr);
+            if (k2 != k) {
+                x2r[b] =  er + (w2r*orr + w2i*oi);
+                x2i[b] = -ei + (w2i*orr - w2r*oi);
+            }
+        }
+    }
+}
+
+void
+RealPlan::backward (Real* re, Real* im, Real* out, Real* wre, Real* wim, int B) const
+{
+    if (m_n % 2 == 1) {
+        const int h = m_n/2;
+        for (int k = h+1; k < m_n; ++k) {
+            std::copy(re + (m_n-k)*B, re + (m_n-k+1)*B, re + k*B);
+            for (int b = 0; b < B; ++b) {
+                im[k*B+b] = -im[(m_n-k)*B+b];
+            }
+        }
+        m_plan.compute(Direction::backward, re, im, wre, wim, B);
+        std::copy(re, re + m_n*B, out);
+        return;
+    }
+
+    // Invert the post-processing of forward, up to a factor of two:
+    // Z[k] = E + i O with E = X[k] + conj(X[h-k]) and
+    // O = (X[k] - conj(X[h-k])) conj(w^k).
+    const int h = m_n/2;
+    for (int k = 0; k <= h/2; ++k) {
+        const int k2 = h-k;
+        Real* xr = re + k*B;
+        Real* xi = im + k*B;
+        Real* x2r = re + k2*B;
+        Real* x2i = im + k2*B;
+        const Real w1r = m_wr[k],  w1i = -m_wi[k];
+        const Real w2r = m_wr[k2], w2i = -m_wi[k2];
+        for (int b = 0; b < B; ++b) {
+            const Real ar = xr[b],  ai = xi[b];
+            const Real cr = x2r[b], ci = x2i[b];
+            // k
+            {
+                const Real er = ar + cr, ei = ai - ci;
+                const Real dr = ar - cr, di = ai + ci;
+                const Real orr = dr*w1r - di*w1i;
+                const Real oi  = dr*w1i + di*w1r;
+                xr[b] = er - oi;
+                xi[b] = ei + orr;
+            }
+            // h-k
+            if (k2 != k && k2 < h) {
+                const Real er = cr + ar, ei = ci - ai;
+                const Real dr = cr - ar, di = ci + ai;
+                const Real orr = dr*w2r - di*w2i;
+                const Real oi  = dr*w2i + di*w2r;
+                x2r[b] = er - oi;
+                x2i[b] = ei + orr;
+            }
+        }
+    }
+
+    m_plan.compute(Direction::backward, re, im, wre, wim, B);
+
+    for (int m = 0; m < h; ++m) {
+        Real* AMREX_RESTRICT x0 = out + 2*m*B;
+        Real const* AMREX_RESTRICT zr = re + m*B;
+        Real const* AMREX_RESTRICT zi = im + m*B;
+        AMREX_PRAGMA_SIMD
+        for (int b = 0; b < B; ++b) {
+            x0[b] = zr[b];
+            x0[B+b] = zi[b];
+        }
+    }
+}
+
+}}
@@ -0,0 +1,65 @@
+
+#include <AMReX_FFT_Poisson.H>
+#include <AMReX_BLProfiler.H>
+
+#include <cmath>
+
+namespace amrex {
+namespace FFT {
+
+Poisson::Poisson (Geometry const& geom)
+    : m_geom(geom),
+      m_r2c(geom.Domain())
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(geom.isAllPeriodic(),
+                                     "FFT::Poisson: the domain must be periodic in all directions");
+}
+
+void
+Poisson::solve (MultiFab& soln, MultiFab const& rhs)
+{
+    BL_PROFILE("FFT::Poisson::solve()");
+
+    // Eigenvalues of the Laplacian in each direction
+    IntVect const len = m_geom.Domain().length();
+    constexpr double twopi = 2.*3.14159265358979323846264338327950288;
+    Array<Vector<Real>,AMREX_SPACEDIM> lambda;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const int n = len[idim];
+        const Real dxinv = m_geom.InvCellSize(idim);
+        lambda[idim].resize(n);
+        for (int k = 0; k < n; ++k) {
+            if (m_spectral) {
+                const int kk = (k <= n/2) ? k : k-n;
+                const Real w = static_cast<Real>(twopi*kk/n)*dxinv;
+                lambda[idim][k] = -w*w;
+            } else {
+                const Real c = static_cast<Real>(std::cos(twopi*k/n));
+                lambda[idim][k] = Real(2.)*(c-Real(1.))*dxinv*dxinv;
+            }
+        }
+    }
+
+    const Real a = m_a;
+    const Real b = m_b;
+    const Real scale = Real(1.)/static_cast<Real>(m_geom.Domain().d_numPts());
+
+    m_r2c.forwardThenBackward(rhs, soln,
+        [&] (int i, int j, int k, GpuComplex<Real>& v) noexcept
+        {
+            amrex::ignore_unused(j,k);
+            const Real lap = AMREX_D_TERM(lambda[0][i], + lambda[1][j], + lambda[2][k]);
+            const Real denom = a - b*lap;
+            if (denom == Real(0.)) {
+                v = GpuComplex<Real>(Real(0.), Real(0.));
+            } else {
+                v *= scale/denom;
+            }
+        });
+
+    if (soln.nGrowVect().max() > 0) {
+        soln.FillBoundary(m_geom.periodicity());
+    }
+}
+
+}}
@@ -0,0 +1,304 @@
+
+#include <AMReX_FFT_R2C.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+namespace amrex {
+namespace FFT {
+
+namespace {
+
+// Number of lines transformed together.
+constexpr int batch_size = 8;
+
+// Splits the directions of domain not marked in whole into at most nprocs
+// boxes of nearly equal size.
+BoxArray decompose (Box const& domain, IntVect const& whole, int nprocs)
+{
+    IntVect const len = domain.length();
+    Vector<int> sdirs;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (!whole[idim]) { sdirs.push_back(idim); }
+    }
+
+    IntVect np(1);
+    if (sdirs.size() == 1) {
+        np[sdirs[0]] = std::min(nprocs, len[sdirs[0]]);
+    } else if (sdirs.size() == 2) {
+        const int n1 = len[sdirs[0]];
+        const int n2 = len[sdirs[1]];
+        int best = 0, bestdiff = 0;
+        for (int p1 = 1; p1 <= std::min(nprocs, n1); ++p1) {
+            const int p2 = std::min(nprocs/p1, n2);
+            const int diff = std::abs((n1+p1-1)/p1 - (n2+p2-1)/p2);
+            if (p1*p2 > best || (p1*p2 == best && diff < bestdiff)) {
+                best = p1*p2;
+                bestdiff = diff;
+                np[sdirs[0]] = p1;
+                np[sdirs[1]] = p2;
+            }
+        }
+    }
+
+    BoxList bl;
+    IntVect const& dlo = domain.smallEnd();
+    LoopOnCpu(Box(IntVect(0), np-1), [&] (int i, int j, int k) noexcept
+    {
+        amrex::ignore_unused(j,k);
+        IntVect const iv(AMREX_D_DECL(i,j,k));
+        IntVect lo, hi;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            lo[idim] = dlo[idim] + (len[idim]*iv[idim])/np[idim];
+            hi[idim] = dlo[idim] + (len[idim]*(iv[idim]+1))/np[idim] - 1;
+        }
+        bl.push_back(Box(lo,hi));
+    });
+    return BoxArray(std::move(bl));
+}
+
+// One box per process.
+DistributionMapping make_dm (BoxArray const& ba)
+{
+    Vector<int> pmap(ba.size());
+    std::iota(pmap.begin(), pmap.end(), 0);
+    return DistributionMapping(std::move(pmap));
+}
+
+}
+
+R2C::R2C (Box const& domain)
+    : m_domain(domain),
+      m_rplan(domain.length(0))
+{
+    BL_PROFILE("FFT::R2C::R2C()");
+
+    AMREX_ALWAYS_ASSERT(domain.ok() && domain.ixType().cellCentered());
+
+    IntVect const len = domain.length();
+    m_spectral_domain = Box(IntVect(0), len-1);
+    m_spectral_domain.setBig(0, len[0]/2);
+    for (int idim = 1; idim < AMREX_SPACEDIM; ++idim) {
+        m_plan[idim] = Plan(len[idim]);
+    }
+
+    const int nprocs = ParallelDescriptor::NProcs();
+
+#if (AMREX_SPACEDIM == 3)
+    if (nprocs <= len[2]) {
+        m_dirs = {{0,1},{2}};     // xy-slabs, then z-pencils
+    } else {
+        m_dirs = {{0},{1},{2}};   // x-, y- and z-pencils
+    }
+#elif (AMREX_SPACEDIM == 2)
+    m_dirs = {{0},{1}};
+#else
+    m_dirs = {{0}};
+#endif
+
+    for (int s = 0, ns = static_cast<int>(m_dirs.size()); s < ns; ++s) {
+        IntVect whole(0);
+        for (int idim : m_dirs[s]) { whole[idim] = 1; }
+        if (s == 0) {
+            BoxArray const rba = decompose(m_domain, whole, nprocs);
+            DistributionMapping const dm = make_dm(rba);
+            m_rmf.define(rba, dm, 1, 0, MFInfo().SetArena(The_Pinned_Arena()));
+            BoxList bl;
+            for (int i = 0, nb = static_cast<int>(rba.size()); i < nb; ++i) {
+                Box b = rba[i];
+                b.shift(-m_domain.smallEnd());
+                b.setSmall(0, 0);
+                b.setBig(0, len[0]/2);
+                bl.push_back(b);
+            }
+            m_cmf.push_back(std::make_unique<cMultiFab>(BoxArray(std::move(bl)), dm, 1, 0,
+                                                        MFInfo().SetArena(The_Pinned_Arena())));
+        } else {
+            BoxArray const ba = decompose(m_spectral_domain, whole, nprocs);
+            m_cmf.push_back(std::make_unique<cMultiFab>(ba, make_dm(ba), 1, 0,
+                                                        MFInfo().SetArena(The_Pinned_Arena())));
+        }
+    }
+}
+
+void
+R2C::forward (MultiFab const& inmf, int icomp)
+{
+    BL_PROFILE("FFT::R2C::forward()");
+
+    m_rmf.ParallelCopy(inmf, icomp, 0, 1);
+    Gpu::streamSynchronize();
+
+    transform_real(Direction::forward);
+
+    for (int s = 0, ns = static_cast<int>(m_dirs.size()); s < ns; ++s) {
+        if (s > 0) {
+            m_cmf[s]->ParallelCopy(*m_cmf[s-1], 0, 0, 1);
+            Gpu::streamSynchronize();
+        }
+        for (int idim : m_dirs[s]) {
+            if (idim > 0) {
+                transform_complex(*m_cmf[s], idim, Direction::forward);
+            }
+        }
+    }
+}
+
+void
+R2C::backward (MultiFab& outmf, int ocomp)
+{
+    BL_PROFILE("FFT::R2C::backward()");
+
+    for (int s = static_cast<int>(m_dirs.size())-1; s >= 0; --s) {
+        for (auto it = m_dirs[s].rbegin(); it != m_dirs[s].rend(); ++it) {
+            if (*it > 0) {
+                transform_complex(*m_cmf[s], *it, Direction::backward);
+            }
+        }
+        if (s > 0) {
+            m_cmf[s-1]->ParallelCopy(*m_cmf[s], 0, 0, 1);
+            Gpu::streamSynchronize();
+        }
+    }
+
+    transform_real(Direction::backward);
+
+    outmf.ParallelCopy(m_rmf, 0, ocomp, 1);
+}
+
+void
+R2C::transform_real (Direction dir)
+{
+    BL_PROFILE("FFT::R2C::transform_real()");
+
+    const int n = m_rplan.size();
+    const int nw = m_rplan.workSize();
+    constexpr int B = batch_size;
+
+    for (MFIter mfi(m_rmf); mfi.isValid(); ++mfi) {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& r = m_rmf.array(mfi);
+        Array4<GpuComplex<Real> > const& c = m_cmf[0]->array(mfi);
+        const Dim3 lo = amrex::lbound(bx);
+        const Dim3 hi = amrex::ubound(bx);
+        const Dim3 clo = amrex::lbound(c);
+        const int dj = clo.y - lo.y;
+        const int dk = clo.z - lo.z;
+        const int nyb = (hi.y-lo.y+B)/B;
+        const int ntasks = (hi.z-lo.z+1)*nyb;
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        {
+            Vector<Real> buf((n+4*nw)*B);
+            Real* rl = buf.data();
+            Real* re = rl + n*B;
+            Real* im = re + nw*B;
+            Real* wre = im + nw*B;
+            Real* wim = wre + nw*B;
+
+#ifdef AMREX_USE_OMP
+#pragma omp for
+#endif
+            for (int t = 0; t < ntasks; ++t) {
+                const int k = lo.z + t/nyb;
+                const int j0 = lo.y + (t%nyb)*B;
+                const int nb = std::min(B, hi.y-j0+1);
+                if (dir == Direction::forward) {
+                    for (int b = 0; b < nb; ++b) {
+                        Real const* AMREX_RESTRICT p = r.ptr(lo.x,j0+b,k);
+                        for (int e = 0; e < n; ++e) {
+                            rl[e*nb+b] = p[e];
+                        }
+                    }
+                    m_rplan.forward(rl, re, im, wre, wim, nb);
+                    for (int b = 0; b < nb; ++b) {
+                        GpuComplex<Real>* AMREX_RESTRICT p = c.ptr(0,j0+b+dj,k+dk);
+                        for (int e = 0; e <= n/2; ++e) {
+                            p[e] = GpuComplex<Real>(re[e*nb+b], im[e*nb+b]);
+                        }
+                    }
+                } else {
+                    for (int b = 0; b < nb; ++b) {
+                        GpuComplex<Real> const* AMREX_RESTRICT p = c.ptr(0,j0+b+dj,k+dk);
+                        for (int e = 0; e <= n/2; ++e) {
+                            re[e*nb+b] = p[e].real();
+                            im[e*nb+b] = p[e].imag();
+                        }
+                    }
+                    m_rplan.backward(re, im, rl, wre, wim, nb);
+                    for (int b = 0; b < nb; ++b) {
+                        Real* AMREX_RESTRICT p = r.ptr(lo.x,j0+b,k);
+                        for (int e = 0; e < n; ++e) {
+                            p[e] = rl[e*nb+b];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+R2C::transform_complex (cMultiFab& cmf, int idim, Direction dir)
+{
+    BL_PROFILE("FFT::R2C::transform_complex()");
+
+    Plan const& plan = m_plan[idim];
+    const int n = plan.size();
+    constexpr int B = batch_size;
+
+    for (MFIter mfi(cmf); mfi.isValid(); ++mfi) {
+        Box const& bx = mfi.validbox();
+        Array4<GpuComplex<Real> > const& a = cmf.array(mfi);
+        const Dim3 lo = amrex::lbound(bx);
+        const Dim3 hi = amrex::ubound(bx);
+        // The lines along idim are batched over contiguous x.
+        const Long stride = (idim == 1) ? a.jstride : a.kstride;
+        const int nxb = (hi.x-lo.x+B)/B;
+        const int nother = (idim == 1) ? (hi.z-lo.z+1) : (hi.y-lo.y+1);
+        const int ntasks = nother*nxb;
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        {
+            Vector<Real> buf(4*n*B);
+            Real* re = buf.data();
+            Real* im = re + n*B;
+            Real* wre = im + n*B;
+            Real* wim = wre + n*B;
+
+#ifdef AMREX_USE_OMP
+#pragma omp for
+#endif
+            for (int t = 0; t < ntasks; ++t) {
+                const int o = t/nxb;
+                const int i0 = lo.x + (t%nxb)*B;
+                const int nb = std::min(B, hi.x-i0+1);
+                GpuComplex<Real>* p0 = (idim == 1) ? a.ptr(i0,lo.y,lo.z+o)
+                                                   : a.ptr(i0,lo.y+o,lo.z);
+                for (int e = 0; e < n; ++e) {
+                    GpuComplex<Real> const* AMREX_RESTRICT p = p0 + e*stride;
+                    for (int b = 0; b < nb; ++b) {
+                        re[e*nb+b] = p[b].real();
+                        im[e*nb+b] = p[b].imag();
+                    }
+                }
+                plan.compute(dir, re, im, wre, wim, nb);
+                for (int e = 0; e < n; ++e) {
+                    GpuComplex<Real>* AMREX_RESTRICT p = p0 + e*stride;
+                    for (int b = 0; b < nb; ++b) {
+                        p[b] = GpuComplex<Real>(re[e*nb+b], im[e*nb+b]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+}}
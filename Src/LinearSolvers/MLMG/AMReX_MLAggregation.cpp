@@ -0,0 +1,591 @@
+
+#include <AMReX_MLAggregation.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX_ParallelReduce.H>
+
+#include <cmath>
+
+namespace amrex {
+
+namespace {
+
+constexpr int nsten = AMREX_D_TERM(3,*3,*3);
+// Component of offset (oi,oj,ok) in the stencil MultiFab
+constexpr int sj = (AMREX_SPACEDIM >= 2) ? 3 : 0;
+constexpr int sk = (AMREX_SPACEDIM == 3) ? 9 : 0;
+constexpr int jr = (AMREX_SPACEDIM >= 2) ? 1 : 0;
+constexpr int kr = (AMREX_SPACEDIM == 3) ? 1 : 0;
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+int floor2 (int i) noexcept { return (i < 0) ? -((-i+1)/2) : i/2; }
+
+Periodicity make_period (Box const& domain, IntVect const& periodic)
+{
+    IntVect period(0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (periodic[idim]) { period[idim] = domain.length(idim); }
+    }
+    return Periodicity(period);
+}
+
+}
+
+MLAggregation::MLAggregation (MLLinOp& a_lp)
+    : linop(a_lp)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(linop.isCellCentered() && linop.getNComp() == 1,
+                                     "MLAggregation: only single-component cell-centered operators are supported");
+}
+
+MLAggregation::~MLAggregation () = default;
+
+void
+MLAggregation::precondition (MultiFab& z, const MultiFab& r)
+{
+    BL_PROFILE("MLAggregation::precondition()");
+
+    if (m_levels.empty()) {
+        m_levels.resize(1);
+        m_levels[0].ba = r.boxArray();
+        m_levels[0].dm = r.DistributionMap();
+        setup();
+    }
+
+    Level& L = m_levels[0];
+    MultiFab::Copy(L.b, r, 0, 0, 1, 0);
+    vcycle(0);
+    MultiFab::Copy(z, L.x, 0, 0, 1, 0);
+}
+
+void
+MLAggregation::setup ()
+{
+    BL_PROFILE("MLAggregation::setup()");
+
+    const Real t0 = amrex::second();
+
+    const Geometry& geom = linop.Geom(0, linop.NMGLevels(0)-1);
+    m_levels[0].domain = geom.Domain();
+    m_levels[0].periodic = IntVect(AMREX_D_DECL(geom.isPeriodic(0),
+                                                geom.isPeriodic(1),
+                                                geom.isPeriodic(2)));
+    probe();
+
+    int lev = 0;
+    while (m_levels[lev].domain.numPts() > max_coarse_cells && coarsen(lev)) {
+        ++lev;
+    }
+
+    for (auto& L : m_levels) {
+        L.x.define(L.ba, L.dm, 1, 1);
+        L.b.define(L.ba, L.dm, 1, 0);
+        L.r.define(L.ba, L.dm, 1, 0);
+        L.x.setVal(0.0);
+
+        L.dinv.define(L.ba, L.dm, 1, 0);
+        for (MFIter mfi(L.dinv, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.tilebox();
+            auto const& s = L.sten.const_array(mfi);
+            auto const& d = L.dinv.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                Real l1 = 0.0;
+                for (int n = 0; n < nsten; ++n) { l1 += std::abs(s(i,j,k,n)); }
+                d(i,j,k) = (s(i,j,k,nsten/2) != Real(0.0)) ? Real(1.0)/l1 : Real(0.0);
+            });
+        }
+
+        // Away from embedded boundaries the stencils usually are stars, for
+        // which a cheaper kernel is used.
+        L.star.assign(L.sten.local_size(), 1);
+        for (MFIter mfi(L.sten); mfi.isValid(); ++mfi) {
+            for (int n = 0; n < nsten; ++n) {
+                const int noffsets = AMREX_D_TERM((n%3 != 1), + ((n/3)%3 != 1), + (n/9 != 1));
+                if (noffsets > 1 &&
+                    L.sten[mfi].maxabs<RunOn::Device>(mfi.validbox(), n) != Real(0.0)) {
+                    L.star[mfi.LocalIndex()] = 0;
+                    break;
+                }
+            }
+        }
+    }
+
+    setupCoarsest();
+
+    if (verbose > 0) {
+        amrex::Print() << "MLAggregation: " << NLevels() << " levels, setup time "
+                       << amrex::second()-t0 << " s\n";
+        for (int ilev = 0; ilev < NLevels(); ++ilev) {
+            amrex::Print() << "    level " << ilev << ": " << m_levels[ilev].domain
+                           << ", " << m_levels[ilev].ba.size() << " boxes"
+                           << ((ilev == NLevels()-1) ? (m_direct ? ", direct solve" : ", smoother")
+                                                     : "") << "\n";
+        }
+    }
+}
+
+// Extracts the stencil of the bottom operator.  The cells are colored so
+// that no two neighbors in a 3x3x3 block share a color, and the operator is
+// applied to the indicator function of each color.
+void
+MLAggregation::probe ()
+{
+    BL_PROFILE("MLAggregation::probe()");
+
+    Level& L = m_levels[0];
+    const int mglev = linop.NMGLevels(0)-1;
+
+    MultiFab xp(L.ba, L.dm, 1, 1, MFInfo(), *linop.Factory(0,mglev));
+    MultiFab yp(L.ba, L.dm, 1, 0, MFInfo(), *linop.Factory(0,mglev));
+    L.sten.define(L.ba, L.dm, nsten, 0);
+    L.sten.setVal(0.0);
+
+    GpuArray<int,3> dlo{{0,0,0}}, len{{1,1,1}}, per{{0,0,0}}, ncolor{{1,1,1}};
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        dlo[idim] = L.domain.smallEnd(idim);
+        len[idim] = L.domain.length(idim);
+        per[idim] = L.periodic[idim];
+        if (per[idim] && len[idim] > 2) {
+            // The colors must wrap around consistently.
+            int m = 3;
+            while (len[idim] % m != 0) { ++m; }
+            ncolor[idim] = m;
+        } else {
+            ncolor[idim] = std::min(3, len[idim]);
+        }
+    }
+
+    for (int kc = 0; kc < ncolor[2]; ++kc) {
+    for (int jc = 0; jc < ncolor[1]; ++jc) {
+    for (int ic = 0; ic < ncolor[0]; ++ic) {
+        const GpuArray<int,3> color{{ic,jc,kc}};
+
+        xp.setVal(0.0);
+        for (MFIter mfi(xp, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.tilebox();
+            auto const& x = xp.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                if ((i-dlo[0])%ncolor[0] == color[0] &&
+                    (j-dlo[1])%ncolor[1] == color[1] &&
+                    (k-dlo[2])%ncolor[2] == color[2]) {
+                    x(i,j,k) = 1.0;
+                }
+            });
+        }
+
+        linop.apply(0, mglev, yp, xp, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        linop.normalize(0, mglev, yp);
+
+        for (MFIter mfi(yp, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.tilebox();
+            auto const& y = yp.const_array(mfi);
+            auto const& s = L.sten.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // In each direction, at most one offset reaches a cell of this color.
+                const int p[3] = {i, j, k};
+                const int r[3] = {1, jr, kr};
+                int o[3];
+                for (int d = 0; d < 3; ++d) {
+                    o[d] = -2;
+                    for (int t = -r[d]; t <= r[d]; ++t) {
+                        int q = p[d]+t;
+                        bool inside = true;
+                        if (per[d]) {
+                            // If the period is less than 3, several offsets
+                            // reach the same cell.  Their sum is stored once.
+                            inside = len[d] >= 3 || (t >= 0 && t < len[d]);
+                            q = dlo[d] + ((q-dlo[d])%len[d] + len[d])%len[d];
+                        } else {
+                            inside = q >= dlo[d] && q < dlo[d]+len[d];
+                        }
+                        if (inside && (q-dlo[d])%ncolor[d] == color[d]) { o[d] = t; }
+                    }
+                }
+                if (o[0] != -2 && o[1] != -2 && o[2] != -2) {
+                    s(i,j,k,(o[0]+1)+sj*(o[1]+1)+sk*(o[2]+1)) = y(i,j,k);
+                }
+            });
+        }
+    }}}
+}
+
+// Builds level lev+1 by aggregating 2x2x2 cells of level lev.  Returns
+// false if lev cannot be coarsened.
+bool
+MLAggregation::coarsen (int lev)
+{
+    BL_PROFILE("MLAggregation::coarsen()");
+
+    {
+        const Level& F = m_levels[lev];
+        const IntVect len = F.domain.length();
+        bool can = false;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (F.periodic[idim] && len[idim] % 2 != 0 && len[idim] > 1) { return false; }
+            can = can || (len[idim] > 1);
+        }
+        if (!can) { return false; }
+    }
+
+    m_levels.emplace_back();
+    Level& F = m_levels[lev];
+    Level& C = m_levels[lev+1];
+
+    C.domain = amrex::coarsen(F.domain, 2);
+    C.periodic = F.periodic;
+
+    BoxArray cba = F.ba;
+    cba.coarsen(2);
+    const bool same_layout = F.ba.coarsenable(2);
+    if (same_layout) {
+        C.ba = cba;
+        C.dm = F.dm;
+    } else {
+        // The coarsened boxes may overlap.  The partial sums on them are
+        // added into a new layout.
+        C.ba = BoxArray(C.domain);
+        C.ba.maxSize(32);
+        C.dm = DistributionMapping(C.ba);
+        F.crse_tmp.define(cba, F.dm, nsten, 0);
+    }
+    C.sten.define(C.ba, C.dm, nsten, 0);
+
+    MultiFab& dst = same_layout ? C.sten : F.crse_tmp;
+    for (MFIter mfi(F.sten); mfi.isValid(); ++mfi) {
+        const Box& fbx = mfi.validbox();
+        const Box& cbx = amrex::coarsen(fbx, 2);
+        const Dim3 flo = amrex::lbound(fbx);
+        const Dim3 fhi = amrex::ubound(fbx);
+        auto const& sf = F.sten.const_array(mfi);
+        auto const& sc = dst.array(mfi);
+        amrex::ParallelFor(cbx, [=] AMREX_GPU_DEVICE (int ic, int jc, int kc) noexcept
+        {
+            Real a[nsten];
+            for (int n = 0; n < nsten; ++n) { a[n] = 0.0; }
+            for (int k = amrex::max(2*kc,flo.z); k <= amrex::min(2*kc+kr,fhi.z); ++k) {
+            for (int j = amrex::max(2*jc,flo.y); j <= amrex::min(2*jc+jr,fhi.y); ++j) {
+            for (int i = amrex::max(2*ic,flo.x); i <= amrex::min(2*ic+1,fhi.x); ++i) {
+                int n = 0;
+                for (int ok = -kr; ok <= kr; ++ok) {
+                for (int oj = -jr; oj <= jr; ++oj) {
+                for (int oi = -1; oi <= 1; ++oi) {
+                    const int m = (floor2(i+oi)-ic+1) + sj*(floor2(j+oj)-jc+1)
+                        +                               sk*(floor2(k+ok)-kc+1);
+                    a[m] += sf(i,j,k,n++);
+                }}}
+            }}}
+            for (int n = 0; n < nsten; ++n) { sc(ic,jc,kc,n) = a[n]; }
+        });
+    }
+
+    if (!same_layout) {
+        C.sten.setVal(0.0);
+        C.sten.ParallelAdd(F.crse_tmp);
+        F.crse_tmp.define(cba, F.dm, 1, 0);
+    }
+
+    return true;
+}
+
+void
+MLAggregation::setupCoarsest ()
+{
+    BL_PROFILE("MLAggregation::setupCoarsest()");
+
+    const Level& L = m_levels.back();
+    m_direct = L.domain.numPts() <= max_coarse_cells;
+    if (!m_direct) { return; }
+
+    const int n = static_cast<int>(L.domain.numPts());
+    m_ncoarse = n;
+    m_lu.assign(static_cast<std::size_t>(n)*n, 0.0);
+    m_piv.resize(n);
+
+    const Dim3 dlo = amrex::lbound(L.domain);
+    const IntVect len = L.domain.length();
+    auto cellid = [&] (int i, int j, int k) -> int
+    {
+        amrex::ignore_unused(j,k);
+        AMREX_D_TERM(i = (i-dlo.x+len[0])%len[0];,
+                     j = (j-dlo.y+len[1])%len[1];,
+                     k = (k-dlo.z+len[2])%len[2];)
+        return AMREX_D_TERM(i, + len[0]*j, + len[0]*len[1]*k);
+    };
+
+    MultiFab hsten(L.ba, L.dm, nsten, 0, MFInfo().SetArena(The_Pinned_Arena()));
+    MultiFab::Copy(hsten, L.sten, 0, 0, nsten, 0);
+    Gpu::streamSynchronize();
+
+    for (MFIter mfi(hsten); mfi.isValid(); ++mfi) {
+        auto const& s = hsten.const_array(mfi);
+        LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            const int row = cellid(i,j,k);
+            int m = 0;
+            for (int ok = -kr; ok <= kr; ++ok) {
+            for (int oj = -jr; oj <= jr; ++oj) {
+            for (int oi = -1; oi <= 1; ++oi) {
+                // Entries that leave a non-periodic domain are zero.
+                const Real v = s(i,j,k,m++);
+                if (v != Real(0.0)) {
+                    m_lu[static_cast<std::size_t>(row)*n + cellid(i+oi,j+oj,k+ok)] += v;
+                }
+            }}}
+        });
+    }
+
+    ParallelAllReduce::Sum(m_lu.data(), n*n, ParallelContext::CommunicatorSub());
+
+    // Inactive cells get identity rows.  For a singular operator, the last
+    // active equation is replaced by one fixing the sum of the solution.
+    Vector<int> active(n, 0);
+    int last_active = -1;
+    for (int row = 0; row < n; ++row) {
+        Real* a = m_lu.data() + static_cast<std::size_t>(row)*n;
+        if (a[row] == Real(0.0)) {
+            for (int col = 0; col < n; ++col) { a[col] = 0.0; }
+            a[row] = 1.0;
+        } else {
+            active[row] = 1;
+            last_active = row;
+        }
+    }
+    m_singular_row = -1;
+    if (linop.isBottomSingular() && last_active >= 0) {
+        Real* a = m_lu.data() + static_cast<std::size_t>(last_active)*n;
+        for (int col = 0; col < n; ++col) { a[col] = static_cast<Real>(active[col]); }
+        m_singular_row = last_active;
+    }
+
+    // LU with partial pivoting
+    for (int col = 0; col < n; ++col) {
+        int p = col;
+        for (int row = col+1; row < n; ++row) {
+            if (std::abs(m_lu[static_cast<std::size_t>(row)*n+col]) >
+                std::abs(m_lu[static_cast<std::size_t>(p)*n+col])) {
+                p = row;
+            }
+        }
+        m_piv[col] = p;
+        if (p != col) {
+            for (int c = 0; c < n; ++c) {
+                std::swap(m_lu[static_cast<std::size_t>(p)*n+c], m_lu[static_cast<std::size_t>(col)*n+c]);
+            }
+        }
+        const Real d = m_lu[static_cast<std::size_t>(col)*n+col];
+        if (d == Real(0.0)) {
+            m_direct = false;
+            return;
+        }
+        for (int row = col+1; row < n; ++row) {
+            Real* a = m_lu.data() + static_cast<std::size_t>(row)*n;
+            const Real* u = m_lu.data() + static_cast<std::size_t>(col)*n;
+            const Real f = a[col] / d;
+            a[col] = f;
+            if (f != Real(0.0)) {
+                for (int c = col+1; c < n; ++c) { a[c] -= f*u[c]; }
+            }
+        }
+    }
+
+    m_hvec.define(L.ba, L.dm, 1, 0, MFInfo().SetArena(The_Pinned_Arena()));
+}
+
+void
+MLAggregation::vcycle (int lev)
+{
+    if (lev == NLevels()-1) {
+        coarsestSolve();
+        return;
+    }
+
+    smooth(lev, nu1, true);
+    residual(lev);
+    restrictResidual(lev);
+    vcycle(lev+1);
+    interpolateCorrection(lev);
+    smooth(lev, nu2, false);
+}
+
+void
+MLAggregation::smooth (int lev, int nsweeps, bool zero_initial_guess)
+{
+    BL_PROFILE("MLAggregation::smooth()");
+
+    Level& L = m_levels[lev];
+    for (int isweep = 0; isweep < nsweeps; ++isweep) {
+        if (isweep == 0 && zero_initial_guess) {
+            // x = D^{-1} b
+            MultiFab::Copy(L.r, L.b, 0, 0, 1, 0);
+            L.x.setVal(0.0);
+        } else {
+            residual(lev);
+        }
+        for (MFIter mfi(L.x, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.tilebox();
+            auto const& x = L.x.array(mfi);
+            auto const& r = L.r.const_array(mfi);
+            auto const& d = L.dinv.const_array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                x(i,j,k) += d(i,j,k) * r(i,j,k);
+            });
+        }
+    }
+}
+
+void
+MLAggregation::residual (int lev)
+{
+    Level& L = m_levels[lev];
+    L.x.FillBoundary(make_period(L.domain, L.periodic));
+
+    for (MFIter mfi(L.r, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.tilebox();
+        auto const& r = L.r.array(mfi);
+        auto const& b = L.b.const_array(mfi);
+        auto const& x = L.x.const_array(mfi);
+        auto const& s = L.sten.const_array(mfi);
+        if (L.star[mfi.LocalIndex()]) {
+            constexpr int c = nsten/2;
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                r(i,j,k) = b(i,j,k) - s(i,j,k,c)*x(i,j,k)
+                    AMREX_D_TERM(- s(i,j,k,c-1 )*x(i-1,j,k) - s(i,j,k,c+1 )*x(i+1,j,k),
+                                 - s(i,j,k,c-sj)*x(i,j-1,k) - s(i,j,k,c+sj)*x(i,j+1,k),
+                                 - s(i,j,k,c-sk)*x(i,j,k-1) - s(i,j,k,c+sk)*x(i,j,k+1));
+            });
+        } else {
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                Real ax = 0.0;
+                int n = 0;
+                for (int ok = -kr; ok <= kr; ++ok) {
+                for (int oj = -jr; oj <= jr; ++oj) {
+                for (int oi = -1; oi <= 1; ++oi) {
+                    ax += s(i,j,k,n++) * x(i+oi,j+oj,k+ok);
+                }}}
+                r(i,j,k) = b(i,j,k) - ax;
+            });
+        }
+    }
+}
+
+void
+MLAggregation::restrictResidual (int lev)
+{
+    Level& F = m_levels[lev];
+    Level& C = m_levels[lev+1];
+    const bool same_layout = F.crse_tmp.empty();
+    MultiFab& dst = same_layout ? C.b : F.crse_tmp;
+
+    for (MFIter mfi(F.r); mfi.isValid(); ++mfi) {
+        const Box& fbx = mfi.validbox();
+        const Box& cbx = amrex::coarsen(fbx, 2);
+        const Dim3 flo = amrex::lbound(fbx);
+        const Dim3 fhi = amrex::ubound(fbx);
+        auto const& rf = F.r.const_array(mfi);
+        auto const& bc = dst.array(mfi);
+        amrex::ParallelFor(cbx, [=] AMREX_GPU_DEVICE (int ic, int jc, int kc) noexcept
+        {
+            Real a = 0.0;
+            for (int k = amrex::max(2*kc,flo.z); k <= amrex::min(2*kc+kr,fhi.z); ++k) {
+            for (int j = amrex::max(2*jc,flo.y); j <= amrex::min(2*jc+jr,fhi.y); ++j) {
+            for (int i = amrex::max(2*ic,flo.x); i <= amrex::min(2*ic+1,fhi.x); ++i) {
+                a += rf(i,j,k);
+            }}}
+            bc(ic,jc,kc) = a;
+        });
+    }
+
+    if (!same_layout) {
+        C.b.setVal(0.0);
+        C.b.ParallelAdd(F.crse_tmp);
+    }
+}
+
+void
+MLAggregation::interpolateCorrection (int lev)
+{
+    Level& F = m_levels[lev];
+    Level& C = m_levels[lev+1];
+    const bool same_layout = F.crse_tmp.empty();
+    if (!same_layout) {
+        F.crse_tmp.ParallelCopy(C.x, 0, 0, 1);
+    }
+    const MultiFab& src = same_layout ? C.x : F.crse_tmp;
+
+    for (MFIter mfi(F.x, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.tilebox();
+        auto const& xf = F.x.array(mfi);
+        auto const& xc = src.const_array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            xf(i,j,k) += xc(floor2(i),floor2(j),floor2(k));
+        });
+    }
+}
+
+void
+MLAggregation::coarsestSolve ()
+{
+    BL_PROFILE("MLAggregation::coarsestSolve()");
+
+    if (!m_direct) {
+        smooth(NLevels()-1, nu_coarsest, true);
+        return;
+    }
+
+    Level& L = m_levels.back();
+    const int n = m_ncoarse;
+    const Dim3 dlo = amrex::lbound(L.domain);
+    const IntVect len = L.domain.length();
+    auto cellid = [&] (int i, int j, int k) -> int
+    {
+        amrex::ignore_unused(j,k,len);
+        return AMREX_D_TERM((i-dlo.x), + len[0]*(j-dlo.y), + len[0]*len[1]*(k-dlo.z));
+    };
+
+    MultiFab::Copy(m_hvec, L.b, 0, 0, 1, 0);
+    Gpu::streamSynchronize();
+
+    Vector<Real> v(n, 0.0);
+    for (MFIter mfi(m_hvec); mfi.isValid(); ++mfi) {
+        auto const& b = m_hvec.const_array(mfi);
+        LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            v[cellid(i,j,k)] = b(i,j,k);
+        });
+    }
+    ParallelAllReduce::Sum(v.data(), n, ParallelContext::CommunicatorSub());
+    if (m_singular_row >= 0) { v[m_singular_row] = 0.0; }
+
+    for (int row = 0; row < n; ++row) {
+        std::swap(v[row], v[m_piv[row]]);
+    }
+    for (int row = 1; row < n; ++row) {
+        const Real* a = m_lu.data() + static_cast<std::size_t>(row)*n;
+        Real sum = v[row];
+        for (int c = 0; c < row; ++c) { sum -= a[c]*v[c]; }
+        v[row] = sum;
+    }
+    for (int row = n-1; row >= 0; --row) {
+        const Real* a = m_lu.data() + static_cast<std::size_t>(row)*n;
+        Real sum = v[row];
+        for (int c = row+1; c < n; ++c) { sum -= a[c]*v[c]; }
+        v[row] = sum / a[row];
+    }
+
+    for (MFIter mfi(m_hvec); mfi.isValid(); ++mfi) {
+        auto const& x = m_hvec.array(mfi);
+        LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            x(i,j,k) = v[cellid(i,j,k)];
+        });
+    }
+    MultiFab::Copy(L.x, m_hvec, 0, 0, 1, 0);
+}
+
+}
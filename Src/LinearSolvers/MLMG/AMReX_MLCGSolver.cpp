@@ -5,6 +5,7 @@
 #include <AMReX_MLCGSolver.H>
 #include <AMReX_VisMF.H>
 #include <AMReX_ParallelReduce.H>
+#include <AMReX_BatchReduce.H>
 #include <AMReX_MLMG.H>
 
 #ifdef AMREX_USE_OMP
@@ -118,7 +119,9 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
     sol.setVal(0);
 
-    Real rnorm = norm_inf(r);
+    // rho for the first iteration is computed together with the norm.
+    Real rnorm, rho;
+    norm_inf_dotxy(r, rh, r, rnorm, rho);
     const Real rnorm0   = rnorm;
 
     if ( verbose > 0 )
@@ -142,7 +145,6 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
     for (; iter <= maxiter; ++iter)
     {
-        const Real rho = dotxy(rh,r);
         if ( rho == 0 )
         {
             ret = 1; break;
@@ -157,7 +159,11 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
             sxay(p, p, -omega, v, nghost);
             sxay(p, r,   beta, p, nghost);
         }
-        MultiFab::Copy(ph,p,0,0,ncomp,nghost);
+        if (precond) {
+            precond(ph,p);
+        } else {
+            MultiFab::Copy(ph,p,0,0,ncomp,nghost);
+        }
         Lp.apply(amrlev, mglev, v, ph, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
         Lp.normalize(amrlev, mglev, v);
 
@@ -188,7 +194,11 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
         if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
 
-        MultiFab::Copy(sh,s,0,0,ncomp,nghost);
+        if (precond) {
+            precond(sh,s);
+        } else {
+            MultiFab::Copy(sh,s,0,0,ncomp,nghost);
+        }
         Lp.apply(amrlev, mglev, t, sh, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
         Lp.normalize(amrlev, mglev, t);
         //
@@ -215,7 +225,8 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, r);
 
-        rnorm = norm_inf(r);
+        rho_1 = rho;
+        norm_inf_dotxy(r, rh, r, rnorm, rho);
 
         if ( verbose > 2 )
         {
@@ -231,7 +242,6 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         {
             ret = 4; break;
         }
-        rho_1 = rho;
     }
 
     if ( verbose > 0 )
@@ -290,7 +300,10 @@ MLCGSolver::solve_cg (MultiFab&       sol,
 
     sol.setVal(0);
 
-    Real       rnorm    = norm_inf(r);
+    // z is a copy of r, so rho = dotxy(z,r) for the first iteration is
+    // computed together with the norm.
+    Real rnorm, rho;
+    norm_inf_dotxy(r, r, r, rnorm, rho);
     const Real rnorm0   = rnorm;
 
     if ( verbose > 0 )
@@ -316,8 +329,6 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     {
         MultiFab::Copy(z,r,0,0,ncomp,nghost);
 
-        Real rho = dotxy(z,r);
-
         if ( rho == 0 )
         {
             ret = 1; break;
@@ -353,7 +364,9 @@ MLCGSolver::solve_cg (MultiFab&       sol,
         }
         sxay(sol, sol, alpha, p, nghost);
         sxay(  r,   r,-alpha, q, nghost);
-        rnorm = norm_inf(r);
+
+        rho_1 = rho;
+        norm_inf_dotxy(r, r, r, rnorm, rho);
 
         if ( verbose > 2 )
         {
@@ -364,8 +377,6 @@ MLCGSolver::solve_cg (MultiFab&       sol,
         }
 
         if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
-
-        rho_1 = rho;
     }
 
     if ( verbose > 0 )
@@ -418,5 +429,19 @@ MLCGSolver::norm_inf (const MultiFab& res, bool local)
     return result;
 }
 
+void
+MLCGSolver::norm_inf_dotxy (const MultiFab& res, const MultiFab& r, const MultiFab& z,
+                            Real& rnorm, Real& rz)
+{
+    BatchReduce br(Lp.BottomCommunicator());
+    const int inorm = br.addLocalMax(norm_inf(res, true));
+    const int idot  = br.addLocalSum(dotxy(r, z, true));
+    {
+        BL_PROFILE("MLCGSolver::ParallelAllReduce");
+        br.compute();
+    }
+    rnorm = br[inorm];
+    rz = br[idot];
+}
 
 }
@@ -52,7 +52,7 @@ namespace {
     struct PSEBTag {
         Array4<Real> flo;
         Array4<Real> fhi;
-        Array4<Real const> ap;
+        CutArray4 ap;
         Array4<int const> mlo;
         Array4<int const> mhi;
         Real bcllo;
@@ -994,7 +994,7 @@ MLCellLinOp::prepareForSolve ()
                                 const Orientation olo(idim,Orientation::low);
                                 const Orientation ohi(idim,Orientation::high);
                                 auto const& ap = (fabtyp == FabType::singlevalued)
-                                    ? area[idim]->const_array(mfi) : Array4<Real const>{};
+                                    ? area[idim]->const_cut_array(mfi) : CutArray4{};
                                 for (int icomp = 0; icomp < ncomp; ++icomp) {
                                     tags.emplace_back(PSEBTag{undrrelxr[olo].array(mfi),
                                                               undrrelxr[ohi].array(mfi),
@@ -1188,7 +1188,7 @@ MLCellLinOp::prepareForSolve ()
                             const Real bclhi = bdlv[icomp][ohi];
 #ifdef AMREX_USE_EB
                             if (fabtyp == FabType::singlevalued) {
-                                Array4<Real const> const& ap = area[idim]->const_array(mfi);
+                                CutArray4 const& ap = area[idim]->const_cut_array(mfi);
                                 if (idim == 0) {
                                     mllinop_comp_interp_coef0_x_eb
                                         (0, blo, blen, flo, mlo, ap, bctlo, bcllo,
@@ -786,12 +786,12 @@ MLEBABecLap::compGrad (int amrlev, const Array<MultiFab*,AMREX_SPACEDIM>& grad,
             });
 #endif
         } else if (compute_grad_at_centroid) {
-            AMREX_D_TERM(Array4<Real const> const& apx = area[0]->const_array(mfi);,
-                         Array4<Real const> const& apy = area[1]->const_array(mfi);,
-                         Array4<Real const> const& apz = area[2]->const_array(mfi););
-            AMREX_D_TERM(Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
-                         Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
-                         Array4<Real const> const& fcz = fcent[2]->const_array(mfi););
+            AMREX_D_TERM(CutArray4 const& apx = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& apy = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& apz = area[2]->const_cut_array(mfi););
+            AMREX_D_TERM(CutArray4 const& fcx = fcent[0]->const_cut_array(mfi);,
+                         CutArray4 const& fcy = fcent[1]->const_cut_array(mfi);,
+                         CutArray4 const& fcz = fcent[2]->const_cut_array(mfi););
             Array4<int const> const& msk = ccmask.const_array(mfi);
 
             bool phi_on_centroid = (m_phi_loc == Location::CellCentroid);
@@ -814,9 +814,9 @@ MLEBABecLap::compGrad (int amrlev, const Array<MultiFab*,AMREX_SPACEDIM>& grad,
             );
         } else {
 
-            AMREX_D_TERM(Array4<Real const> const& ax = area[0]->const_array(mfi);,
-                         Array4<Real const> const& ay = area[1]->const_array(mfi);,
-                         Array4<Real const> const& az = area[2]->const_array(mfi););
+            AMREX_D_TERM(CutArray4 const& ax = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& ay = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& az = area[2]->const_cut_array(mfi););
 
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_phi_loc == Location::CellCenter,
              "If computing the gradient at face centers we assume phi at cell centers");
@@ -902,14 +902,14 @@ MLEBABecLap::normalize (int amrlev, int mglev, MultiFab& mf) const
             Array4<int const> const& ccmfab = ccmask.const_array(mfi);
             Array4<EBCellFlag const> const& flagfab = flags->const_array(mfi);
             Array4<Real const> const& vfracfab = vfrac->const_array(mfi);
-            AMREX_D_TERM(Array4<Real const> const& apxfab = area[0]->const_array(mfi);,
-                         Array4<Real const> const& apyfab = area[1]->const_array(mfi);,
-                         Array4<Real const> const& apzfab = area[2]->const_array(mfi););
-            AMREX_D_TERM(Array4<Real const> const& fcxfab = fcent[0]->const_array(mfi);,
-                         Array4<Real const> const& fcyfab = fcent[1]->const_array(mfi);,
-                         Array4<Real const> const& fczfab = fcent[2]->const_array(mfi););
-            Array4<Real const> const& bafab = barea->const_array(mfi);
-            Array4<Real const> const& bcfab = bcent->const_array(mfi);
+            AMREX_D_TERM(CutArray4 const& apxfab = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& apyfab = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& apzfab = area[2]->const_cut_array(mfi););
+            AMREX_D_TERM(CutArray4 const& fcxfab = fcent[0]->const_cut_array(mfi);,
+                         CutArray4 const& fcyfab = fcent[1]->const_cut_array(mfi);,
+                         CutArray4 const& fczfab = fcent[2]->const_cut_array(mfi););
+            CutArray4 const& bafab = barea->const_cut_array(mfi);
+            CutArray4 const& bcfab = bcent->const_cut_array(mfi);
 
             bool beta_on_centroid = (m_beta_loc == Location::FaceCentroid);
 
@@ -1111,7 +1111,7 @@ MLEBABecLap::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
                     }
                     else // irregular
                     {
-                        const auto& ap = area[idim]->const_array(mfi);
+                        const auto& ap = area[idim]->const_cut_array(mfi);
                         const auto& mask = ccmask.const_array(mfi);
                         if (idim == 0) {
                             AMREX_LAUNCH_HOST_DEVICE_LAMBDA (
@@ -1251,10 +1251,10 @@ MLEBABecLap::getEBFluxes (const Vector<MultiFab*>& a_flux, const Vector<MultiFab
                 } else {
                     Array4<EBCellFlag const> const& flagfab = flags->const_array(mfi);
                     Array4<Real const> const& vfracfab = vfrac->const_array(mfi);
-                    AMREX_D_TERM(Array4<Real const> const& apxfab = area[0]->const_array(mfi);,
-                                 Array4<Real const> const& apyfab = area[1]->const_array(mfi);,
-                                 Array4<Real const> const& apzfab = area[2]->const_array(mfi););
-                    Array4<Real const> const& bcfab = bcent->const_array(mfi);
+                    AMREX_D_TERM(CutArray4 const& apxfab = area[0]->const_cut_array(mfi);,
+                                 CutArray4 const& apyfab = area[1]->const_cut_array(mfi);,
+                                 CutArray4 const& apzfab = area[2]->const_cut_array(mfi););
+                    CutArray4 const& bcfab = bcent->const_cut_array(mfi);
                     Array4<Real const> const& bebfab = (is_eb_dirichlet)
                         ? m_eb_b_coeffs[amrlev][mglev]->const_array(mfi) : foo;
                     Array4<Real const> const& phiebfab = (is_eb_dirichlet && m_is_eb_inhomog)
@@ -90,15 +90,15 @@ MLEBABecLap::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) c
             Array4<int const> const& ccmfab = ccmask.const_array(mfi);
             Array4<EBCellFlag const> const& flagfab = flags->const_array(mfi);
             Array4<Real const> const& vfracfab = vfrac->const_array(mfi);
-            AMREX_D_TERM(Array4<Real const> const& apxfab = area[0]->const_array(mfi);,
-                         Array4<Real const> const& apyfab = area[1]->const_array(mfi);,
-                         Array4<Real const> const& apzfab = area[2]->const_array(mfi););
-            AMREX_D_TERM(Array4<Real const> const& fcxfab = fcent[0]->const_array(mfi);,
-                         Array4<Real const> const& fcyfab = fcent[1]->const_array(mfi);,
-                         Array4<Real const> const& fczfab = fcent[2]->const_array(mfi););
-            Array4<Real const> const& bafab = barea->const_array(mfi);
-            Array4<Real const> const& bcfab = bcent->const_array(mfi);
-            Array4<Real const> const& ccfab = ccent->const_array(mfi);
+            AMREX_D_TERM(CutArray4 const& apxfab = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& apyfab = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& apzfab = area[2]->const_cut_array(mfi););
+            AMREX_D_TERM(CutArray4 const& fcxfab = fcent[0]->const_cut_array(mfi);,
+                         CutArray4 const& fcyfab = fcent[1]->const_cut_array(mfi);,
+                         CutArray4 const& fczfab = fcent[2]->const_cut_array(mfi););
+            CutArray4 const& bafab = barea->const_cut_array(mfi);
+            CutArray4 const& bcfab = bcent->const_cut_array(mfi);
+            CutArray4 const& ccfab = ccent->const_cut_array(mfi);
             Array4<Real const> const& bebfab = (is_eb_dirichlet)
                 ? m_eb_b_coeffs[amrlev][mglev]->const_array(mfi) : foo;
             Array4<Real const> const& phiebfab = (is_eb_dirichlet && is_eb_inhomog)
@@ -277,14 +277,14 @@ MLEBABecLap::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
             Array4<int const> const& ccmfab = ccmask.const_array(mfi);
             Array4<EBCellFlag const> const& flagfab = flags->const_array(mfi);
             Array4<Real const> const& vfracfab = vfrac->const_array(mfi);
-            AMREX_D_TERM(Array4<Real const> const& apxfab = area[0]->const_array(mfi);,
-                         Array4<Real const> const& apyfab = area[1]->const_array(mfi);,
-                         Array4<Real const> const& apzfab = area[2]->const_array(mfi););
-            AMREX_D_TERM(Array4<Real const> const& fcxfab = fcent[0]->const_array(mfi);,
-                         Array4<Real const> const& fcyfab = fcent[1]->const_array(mfi);,
-                         Array4<Real const> const& fczfab = fcent[2]->const_array(mfi););
-            Array4<Real const> const& bafab = barea->const_array(mfi);
-            Array4<Real const> const& bcfab = bcent->const_array(mfi);
+            AMREX_D_TERM(CutArray4 const& apxfab = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& apyfab = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& apzfab = area[2]->const_cut_array(mfi););
+            AMREX_D_TERM(CutArray4 const& fcxfab = fcent[0]->const_cut_array(mfi);,
+                         CutArray4 const& fcyfab = fcent[1]->const_cut_array(mfi);,
+                         CutArray4 const& fczfab = fcent[2]->const_cut_array(mfi););
+            CutArray4 const& bafab = barea->const_cut_array(mfi);
+            CutArray4 const& bcfab = bcent->const_cut_array(mfi);
             Array4<Real const> const& bebfab = (is_eb_dirichlet)
                 ? m_eb_b_coeffs[amrlev][mglev]->const_array(mfi) : foo;
 
@@ -362,12 +362,12 @@ MLEBABecLap::FFlux (int amrlev, const MFIter& mfi, const Array<FArrayBox*,AMREX_
     } else if (compute_flux_at_centroid) {
         const auto& area = factory->getAreaFrac();
         const auto& fcent = factory->getFaceCent();
-        AMREX_D_TERM(Array4<Real const> const& apx = area[0]->const_array(mfi);,
-                     Array4<Real const> const& apy = area[1]->const_array(mfi);,
-                     Array4<Real const> const& apz = area[2]->const_array(mfi););
-        AMREX_D_TERM(Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
-                     Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
-                     Array4<Real const> const& fcz = fcent[2]->const_array(mfi););
+        AMREX_D_TERM(CutArray4 const& apx = area[0]->const_cut_array(mfi);,
+                     CutArray4 const& apy = area[1]->const_cut_array(mfi);,
+                     CutArray4 const& apz = area[2]->const_cut_array(mfi););
+        AMREX_D_TERM(CutArray4 const& fcx = fcent[0]->const_cut_array(mfi);,
+                     CutArray4 const& fcy = fcent[1]->const_cut_array(mfi);,
+                     CutArray4 const& fcz = fcent[2]->const_cut_array(mfi););
         Array4<Real const> const& phi = sol.const_array();
         AMREX_D_TERM(Array4<Real const> const& bxcoef = bx.const_array();,
                      Array4<Real const> const& bycoef = by.const_array();,
@@ -401,9 +401,9 @@ MLEBABecLap::FFlux (int amrlev, const MFIter& mfi, const Array<FArrayBox*,AMREX_
         );
     } else {
         const auto& area = factory->getAreaFrac();
-        AMREX_D_TERM(Array4<Real const> const& apx = area[0]->const_array(mfi);,
-                     Array4<Real const> const& apy = area[1]->const_array(mfi);,
-                     Array4<Real const> const& apz = area[2]->const_array(mfi););
+        AMREX_D_TERM(CutArray4 const& apx = area[0]->const_cut_array(mfi);,
+                     CutArray4 const& apy = area[1]->const_cut_array(mfi);,
+                     CutArray4 const& apz = area[2]->const_cut_array(mfi););
         Array4<Real const> const& phi = sol.const_array();
         AMREX_D_TERM(Array4<Real const> const& bxcoef = bx.const_array();,
                      Array4<Real const> const& bycoef = by.const_array();,
@@ -260,13 +260,13 @@ MLEBTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode
             Array4<int const> const& ccm = mask.const_array(mfi);
             Array4<EBCellFlag const> const& flag = flags->const_array(mfi);
             Array4<Real const> const& vol = vfrac->const_array(mfi);
-            AMREX_D_TERM(Array4<Real const> const& apx = area[0]->const_array(mfi);,
-                         Array4<Real const> const& apy = area[1]->const_array(mfi);,
-                         Array4<Real const> const& apz = area[2]->const_array(mfi););
-            AMREX_D_TERM(Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
-                         Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
-                         Array4<Real const> const& fcz = fcent[2]->const_array(mfi););
-            Array4<Real const> const& bc = bcent->const_array(mfi);
+            AMREX_D_TERM(CutArray4 const& apx = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& apy = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& apz = area[2]->const_cut_array(mfi););
+            AMREX_D_TERM(CutArray4 const& fcx = fcent[0]->const_cut_array(mfi);,
+                         CutArray4 const& fcy = fcent[1]->const_cut_array(mfi);,
+                         CutArray4 const& fcz = fcent[2]->const_cut_array(mfi););
+            CutArray4 const& bc = bcent->const_cut_array(mfi);
 
             Array4<Real const> foo;
             const bool is_eb_dirichlet =  isEBDirichlet();
@@ -376,9 +376,9 @@ MLEBTensorOp::compCrossTerms(int amrlev, int mglev, MultiFab const& mf) const
           }
           else
           {
-            AMREX_D_TERM(Array4<Real const> const& apx = area[0]->const_array(mfi);,
-                         Array4<Real const> const& apy = area[1]->const_array(mfi);,
-                         Array4<Real const> const& apz = area[2]->const_array(mfi););
+            AMREX_D_TERM(CutArray4 const& apx = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& apy = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& apz = area[2]->const_cut_array(mfi););
             Array4<EBCellFlag const> const& flag = flags->const_array(mfi);
 
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM
@@ -461,7 +461,7 @@ MLEBTensorOp::compFlux (int amrlev, const Array<MultiFab*,AMREX_SPACEDIM>& fluxe
               const Box& nbx = mfi.nodaltilebox(idim);
               Array4<Real      > dst = fluxes[idim]->array(mfi);
               Array4<Real const> src = fluxmf[idim].array(mfi);
-              Array4<Real const> const& ap = area[idim]->array(mfi);
+              CutArray4 const& ap = area[idim]->const_cut_array(mfi);
 
               AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( nbx, tbx,
               {
@@ -484,12 +484,12 @@ MLEBTensorOp::compFlux (int amrlev, const Array<MultiFab*,AMREX_SPACEDIM>& fluxe
                          Array4<Real      > Az = fluxes[2]->array(mfi););
 
             const auto& fcent = factory->getFaceCent();
-            AMREX_D_TERM(Array4<Real const> const& apx = area[0]->const_array(mfi);,
-                         Array4<Real const> const& apy = area[1]->const_array(mfi);,
-                         Array4<Real const> const& apz = area[2]->const_array(mfi););
-            AMREX_D_TERM(Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
-                         Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
-                         Array4<Real const> const& fcz = fcent[2]->const_array(mfi););
+            AMREX_D_TERM(CutArray4 const& apx = area[0]->const_cut_array(mfi);,
+                         CutArray4 const& apy = area[1]->const_cut_array(mfi);,
+                         CutArray4 const& apz = area[2]->const_cut_array(mfi););
+            AMREX_D_TERM(CutArray4 const& fcx = fcent[0]->const_cut_array(mfi);,
+                         CutArray4 const& fcy = fcent[1]->const_cut_array(mfi);,
+                         CutArray4 const& fcz = fcent[2]->const_cut_array(mfi););
             Array4<int const> const& msk = ccmask.const_array(mfi);
 
             int face_only = 0;
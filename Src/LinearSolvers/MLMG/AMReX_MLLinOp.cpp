@@ -895,6 +895,19 @@ MLLinOp::resizeMultiGrid (int new_size)
     }
 }
 
+#ifdef AMREX_USE_EB
+void
+MLLinOp::requireDenseCutData ()
+{
+    for (auto const& factories : m_factory) {
+        for (auto const& f : factories) {
+            auto ebf = dynamic_cast<EBFArrayBoxFactory*>(f.get());
+            if (ebf) { ebf->requireDenseCutData(); }
+        }
+    }
+}
+#endif
+
 #ifdef AMREX_USE_PETSC
 std::unique_ptr<PETScABecLap>
 MLLinOp::makePETSc () const
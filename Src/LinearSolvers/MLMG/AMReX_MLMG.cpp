@@ -1014,6 +1014,16 @@ MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
     cg_solver.setMaxIter(bottom_maxiter);
     if (cf_strategy == CFStrategy::ghostnodes) cg_solver.setNGhost(linop.getNGrow());
 
+    if (bottom_solver == BottomSolver::aggregation) {
+        if (agg_solver == nullptr) { // The setup is reused until the operator changes.
+            agg_solver = std::make_unique<MLAggregation>(linop);
+            agg_solver->setVerbose(bottom_verbose);
+            agg_solver->setMaxCoarseCells(agg_max_coarse_cells);
+        }
+        cg_solver.setPreconditioner([this] (MultiFab& z, const MultiFab& r)
+                                    { agg_solver->precondition(z, r); });
+    }
+
     int ret = cg_solver.solve(x, b, bottom_reltol, bottom_abstol);
     if (ret != 0 && verbose > 1) {
         amrex::Print() << "MLMG: Bottom solve failed.\n";
@@ -1157,6 +1167,7 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         linop_prepared = true;
     } else if (linop.needsUpdate()) {
         linop.update();
+        agg_solver.reset();
 
 #if defined(AMREX_USE_HYPRE) && (AMREX_SPACEDIM > 1)
         hypre_solver.reset();
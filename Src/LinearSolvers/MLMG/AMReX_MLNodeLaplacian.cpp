@@ -56,6 +56,10 @@ MLNodeLaplacian::define (const Vector<Geometry>& a_geom,
 
     MLNodeLinOp::define(a_geom, cc_grids, a_dmap, a_info, a_factory);
 
+#ifdef AMREX_USE_EB
+    requireDenseCutData();
+#endif
+
     m_const_sigma = a_const_sigma;
     m_sigma.resize(m_num_amr_levels);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
@@ -400,6 +404,8 @@ MLNodeLaplacian::setSigma (int amrlev, const MultiFab& a_sigma)
     } else {
         MultiFab::Copy(*m_sigma[amrlev][0][0], a_sigma, 0, 0, 1, 0);
     }
+
+    m_needs_update = true;
 }
 
 void
@@ -467,6 +473,24 @@ MLNodeLaplacian::prepareForSolve ()
 #endif
 
     buildStencil();
+
+    m_needs_update = false;
+}
+
+void
+MLNodeLaplacian::update ()
+{
+    BL_PROFILE("MLNodeLaplacian::update()");
+
+    if (MLNodeLinOp::needsUpdate()) MLNodeLinOp::update();
+
+    averageDownCoeffs();
+
+    // The stencils of the assembled and RAP operators were built from the
+    // old sigma.
+    buildStencil();
+
+    m_needs_update = false;
 }
 
 void
@@ -184,6 +184,7 @@ MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
     BL_PROFILE("MLNodeLaplacian::Fapply()");
 
     const auto& sigma = m_sigma[amrlev][mglev];
+    // Built for RAP, or for the assembled stencil of the Sigma strategy
     const auto& stencil = m_stencil[amrlev][mglev];
     const auto dxinvarr = m_geom[amrlev][mglev].InvCellSizeArray();
 #if (AMREX_SPACEDIM == 2)
@@ -199,7 +200,7 @@ MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
         auto yarr_ma = out.arrays();
         auto dmskarr_ma = dmsk.const_arrays();
 
-        if (m_coarsening_strategy == CoarseningStrategy::RAP)
+        if (stencil)
         {
             auto stenarr_ma = stencil->const_arrays();
             ParallelFor(out, [=] AMREX_GPU_DEVICE(int box_no, int i, int j, int k) noexcept
@@ -262,7 +263,7 @@ MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
             Array4<Real> const& yarr = out.array(mfi);
             Array4<int const> const& dmskarr = dmsk.const_array(mfi);
 
-            if (m_coarsening_strategy == CoarseningStrategy::RAP)
+            if (stencil)
             {
                 Array4<Real const> const& stenarr = stencil->const_array(mfi);
                 amrex::LoopConcurrentOnCpu(bx, [&] (int i, int j, int k) noexcept
@@ -330,6 +331,7 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
     BL_PROFILE("MLNodeLaplacian::Fsmooth()");
 
     const auto& sigma = m_sigma[amrlev][mglev];
+    // Built for RAP, or for the assembled stencil of the Sigma strategy
     const auto& stencil = m_stencil[amrlev][mglev];
     const auto dxinvarr = m_geom[amrlev][mglev].InvCellSizeArray();
 #if (AMREX_SPACEDIM == 2)
@@ -344,7 +346,7 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
         auto solarr_ma = sol.arrays();
         auto rhsarr_ma = rhs.const_arrays();
         auto dmskarr_ma = dmsk.const_arrays();
-        if (m_coarsening_strategy == CoarseningStrategy::RAP)
+        if (stencil)
         {
             auto starr_ma = stencil->const_arrays();
             for (int ns = 0; ns < m_smooth_num_sweeps; ++ns)
@@ -427,7 +429,7 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 
         if (m_use_gauss_seidel)
         {
-            if (m_coarsening_strategy == CoarseningStrategy::RAP)
+            if (stencil)
             {
 #ifdef AMREX_USE_OMP
 #pragma omp parallel
@@ -538,7 +540,7 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
             MultiFab Ax(sol.boxArray(), sol.DistributionMap(), 1, 0);
             Fapply(amrlev, mglev, Ax, sol);
 
-            if (m_coarsening_strategy == CoarseningStrategy::RAP)
+            if (stencil)
             {
 #ifdef AMREX_USE_OMP
 #pragma omp parallel
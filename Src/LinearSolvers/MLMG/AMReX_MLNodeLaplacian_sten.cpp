@@ -11,6 +11,8 @@
 #include <omp.h>
 #endif
 
+#include <limits>
+
 namespace amrex {
 
 void
@@ -25,7 +27,10 @@ MLNodeLaplacian::buildStencil ()
         m_s0_norm0[amrlev].resize(m_num_mg_levels[amrlev],0.0);
     }
 
-    if (m_coarsening_strategy != CoarseningStrategy::RAP) return;
+    if (m_coarsening_strategy != CoarseningStrategy::RAP) {
+        buildAssembledStencil();
+        return;
+    }
 
     const int ncomp_s = (AMREX_SPACEDIM == 2) ? 5 : 9;
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(AMREX_SPACEDIM != 1,
@@ -365,4 +370,149 @@ MLNodeLaplacian::buildStencil ()
     m_s0_norm0[0].back() = m_stencil[0].back()->norm0(0,0) * m_normalization_threshold;
 }
 
+void
+MLNodeLaplacian::buildAssembledStencil ()
+{
+    BL_PROFILE("MLNodeLaplacian::buildAssembledStencil()");
+
+    // Stencils from a previous solve are stale because sigma may have changed.
+    for (auto& v : m_stencil) {
+        for (auto& p : v) { p.reset(); }
+    }
+
+    if (m_assembled_stencil == 0 || AMREX_SPACEDIM == 1 || m_is_rz ||
+        m_sigma[0][0][0] == nullptr) { return; }
+
+    const int ncomp_s = (AMREX_SPACEDIM == 2) ? 5 : 9;
+
+    Long budget = m_stencil_memory_budget;
+    if (budget < 0) {
+#ifdef AMREX_USE_GPU
+        budget = static_cast<Long>(Gpu::Device::freeMemAvailable() / 2);
+        ParallelAllReduce::Min(budget, ParallelContext::CommunicatorSub());
+#else
+        budget = std::numeric_limits<Long>::max();
+#endif
+    }
+
+    Long nbytes_used = 0;
+    int nlevs_total = 0;
+    int nlevs_assembled = 0;
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
+            ++nlevs_total;
+
+            const bool ha = (m_use_harmonic_average && mglev > 0) || m_use_mapped;
+            if (m_assembled_stencil < 0 && !ha) { continue; }
+
+            // Keep the line solve of Fsmooth after semicoarsening.
+            if (amrlev == 0 && mglev > 0 && mg_coarsen_ratio_vec[mglev-1] != mg_coarsen_ratio) {
+                continue;
+            }
+
+            const BoxArray& nba = amrex::convert(m_grids[amrlev][mglev], IntVect::TheNodeVector());
+            const DistributionMapping& dm = m_dmap[amrlev][mglev];
+
+            if (m_assembled_stencil < 0) {
+                Long nbytes = 0;
+                const int myproc = ParallelDescriptor::MyProc();
+                for (int i = 0, N = static_cast<int>(nba.size()); i < N; ++i) {
+                    if (dm[i] == myproc) {
+                        nbytes += amrex::grow(nba[i],1).numPts();
+                    }
+                }
+                nbytes *= ncomp_s * static_cast<Long>(sizeof(Real));
+                ParallelAllReduce::Max(nbytes, ParallelContext::CommunicatorSub());
+                if (nbytes_used + nbytes > budget) { continue; }
+                nbytes_used += nbytes;
+            }
+
+            m_stencil[amrlev][mglev] = std::make_unique<MultiFab>(nba, dm, ncomp_s, 1);
+            MultiFab& stencil = *m_stencil[amrlev][mglev];
+            stencil.setVal(0.0);
+            ++nlevs_assembled;
+
+            const auto& sigma = m_sigma[amrlev][mglev];
+            const int nsig = ha ? AMREX_SPACEDIM : 1;
+            const auto dxinvarr = m_geom[amrlev][mglev].InvCellSizeArray();
+
+            MFItInfo mfi_info;
+            if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            {
+                FArrayBox sgfab;
+                for (MFIter mfi(stencil,mfi_info); mfi.isValid(); ++mfi)
+                {
+                    // The stencil is needed on the low side ghost nodes.  Any
+                    // cell outside sigma's box is treated as zero, as in
+                    // buildStencil.
+                    Box vbx = mfi.validbox();
+                    AMREX_D_TERM(vbx.growLo(0,1);, vbx.growLo(1,1);, vbx.growLo(2,1));
+                    Box bx = mfi.growntilebox(1);
+                    bx &= vbx;
+                    const Box& ccbxg1 = amrex::grow(amrex::enclosedCells(bx),1);
+                    const Box& btmp = ccbxg1 & (*sigma[0])[mfi].box();
+
+                    sgfab.resize(ccbxg1, nsig);
+                    Elixir sgeli = sgfab.elixir();
+                    for (int n = 0; n < nsig; ++n) {
+                        Array4<Real const> const& sgarr_orig = sigma[n]->const_array(mfi);
+                        Array4<Real> const& sgarr = sgfab.array(n);
+                        AMREX_HOST_DEVICE_FOR_3D(ccbxg1, i, j, k,
+                        {
+                            if (btmp.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                                sgarr(i,j,k) = sgarr_orig(i,j,k);
+                            } else {
+                                sgarr(i,j,k) = 0.0;
+                            }
+                        });
+                    }
+
+                    Array4<Real> const& starr = stencil.array(mfi);
+                    if (ha) {
+                        AMREX_D_TERM(Array4<Real const> const& sxarr = sgfab.const_array(0);,
+                                     Array4<Real const> const& syarr = sgfab.const_array(1);,
+                                     Array4<Real const> const& szarr = sgfab.const_array(2););
+                        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+                        {
+                            mlndlap_set_stencil_ha(tbx, starr, AMREX_D_DECL(sxarr,syarr,szarr), dxinvarr);
+                        });
+                    } else {
+                        Array4<Real const> const& sgarr = sgfab.const_array();
+                        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+                        {
+                            mlndlap_set_stencil(tbx, starr, sgarr, dxinvarr);
+                        });
+                    }
+                }
+            }
+
+            // The diagonal is only needed on the valid nodes.
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            for (MFIter mfi(stencil,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                Array4<Real> const& starr = stencil.array(mfi);
+                AMREX_HOST_DEVICE_PARALLEL_FOR_3D(bx, i, j, k,
+                {
+                    mlndlap_set_stencil_s0(i,j,k,starr);
+                });
+            }
+        }
+    }
+
+    Gpu::streamSynchronize();
+
+    if (verbose > 0 && nlevs_assembled > 0) {
+        amrex::Print() << "MLNodeLaplacian: assembled stencil on " << nlevs_assembled
+                       << " of " << nlevs_total << " levels\n";
+    }
+}
+
 }
@@ -0,0 +1,178 @@
+//
+// Runs the Advection_AmrLevel single vortex problem with amr.adaptive_regrid
+// and a tagged region that is set by the test.  While the region stays put,
+// the regrids are skipped and the fine grids do not change.  When it moves
+// out of the fine grids, the next check regrids because the tags escaped,
+// and when it is emptied, because there are no tags.  The decisions are
+// read back from amr.regrid_log.
+//
+#include <AMReX_Amr.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+
+#include <AmrLevelAdv.H>
+
+#include <fstream>
+
+using namespace amrex;
+
+namespace {
+
+// The tagged cells in the index space of level 0.
+Box tag_region;
+
+class AmrLevelCheck
+    :
+    public AmrLevelAdv
+{
+public:
+    using AmrLevelAdv::AmrLevelAdv;
+
+    void errorEst (TagBoxArray& tags, int /*clearval*/, int /*tagval*/, Real /*time*/,
+                   int /*n_error_buf*/, int /*ngrow*/) override
+    {
+        if (level > 0 || tag_region.isEmpty()) { return; }
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+            const Box bx = mfi.validbox() & tag_region;
+            if (bx.ok()) {
+                tags[mfi].setVal<RunOn::Device>(TagBox::SET, bx);
+            }
+        }
+    }
+};
+
+class LevelBldCheck
+    :
+    public LevelBld
+{
+    void variableSetUp () override { AmrLevelAdv::variableSetUp(); }
+    void variableCleanUp () override { AmrLevelAdv::variableCleanUp(); }
+    AmrLevel* operator() () override { return new AmrLevelCheck; }
+    AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom,
+                          const BoxArray& ba, const DistributionMapping& dm,
+                          Real time) override
+    {
+        return new AmrLevelCheck(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+LevelBldCheck check_bld;
+
+struct Decision { int step; std::string action, reason; };
+
+// The value of a field of a JSON line of the regrid log.
+std::string field (std::string const& line, std::string const& key)
+{
+    const std::string k = "\"" + key + "\":";
+    auto pos = line.find(k);
+    AMREX_ALWAYS_ASSERT(pos != std::string::npos);
+    pos += k.size();
+    if (line[pos] == '"') {
+        ++pos;
+        return line.substr(pos, line.find('"', pos) - pos);
+    }
+    return line.substr(pos, line.find_first_of(",}", pos) - pos);
+}
+
+// The decisions of the log with steps in [first,last].  The check at the
+// start of a step is logged with the number of steps done before it.
+Vector<Decision> read_decisions (std::string const& file, int first, int last)
+{
+    Vector<Decision> r;
+    std::ifstream is(file);
+    std::string line;
+    while (std::getline(is, line)) {
+        const int step = std::stoi(field(line, "step"));
+        if (step >= first && step <= last) {
+            r.push_back({step, field(line, "action"), field(line, "reason")});
+            amrex::Print() << "  step " << step << ": " << r.back().action
+                           << (r.back().reason.empty() ? "" : " (" + r.back().reason + ")")
+                           << "\n";
+        }
+    }
+    return r;
+}
+
+void advance (Amr& amr, int nsteps)
+{
+    const int last = amr.levelSteps(0) + nsteps;
+    while (amr.okToContinue() && amr.levelSteps(0) < last) {
+        amr.coarseTimeStep(-1.0);
+    }
+}
+
+}
+
+int
+main (int   argc,
+      char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        std::string regrid_log;
+        int regrid_int = 0;
+        {
+            ParmParse pp("amr");
+            pp.get("regrid_log", regrid_log);
+            pp.get("regrid_int", regrid_int);
+        }
+        const bool ioproc = ParallelDescriptor::IOProcessor();
+
+        // The regrid log is appended to; start with none.
+        if (ioproc && FileSystem::Exists(regrid_log)) {
+            FileSystem::Remove(regrid_log);
+        }
+        ParallelDescriptor::Barrier();
+
+        tag_region = Box(IntVect(8), IntVect(15));
+
+        Amr amr(&check_bld);
+        amr.init(0.0, -1.0);
+        AMREX_ALWAYS_ASSERT(amr.finestLevel() == 1);
+        const BoxArray ba_fixed = amr.boxArray(1);
+        AMREX_ALWAYS_ASSERT(ba_fixed.contains(amrex::refine(tag_region, amr.refRatio(0))));
+
+        // The tags do not move: every check skips the regrid.
+        amrex::Print() << "Fixed tags\n";
+        advance(amr, 3*regrid_int);
+        if (ioproc) {
+            auto const& d = read_decisions(regrid_log, 0, amr.levelSteps(0)-1);
+            AMREX_ALWAYS_ASSERT(d.size() >= 2);
+            for (auto const& x : d) {
+                AMREX_ALWAYS_ASSERT(x.action == "none" || x.action == "rebalance");
+            }
+        }
+        AMREX_ALWAYS_ASSERT(amr.finestLevel() == 1 && amr.boxArray(1) == ba_fixed);
+
+        // The tags move out of the fine grids: the next check regrids.
+        amrex::Print() << "Moved tags\n";
+        tag_region.shift(IntVect(8));
+        int first = amr.levelSteps(0);
+        advance(amr, regrid_int);
+        if (ioproc) {
+            auto const& d = read_decisions(regrid_log, first, amr.levelSteps(0)-1);
+            AMREX_ALWAYS_ASSERT(d.size() == 1);
+            AMREX_ALWAYS_ASSERT(d[0].action == "regrid" && d[0].reason == "tags escaped");
+        }
+        AMREX_ALWAYS_ASSERT(amr.finestLevel() == 1 && amr.boxArray(1) != ba_fixed);
+        AMREX_ALWAYS_ASSERT(amr.boxArray(1).contains(amrex::refine(tag_region, amr.refRatio(0))));
+
+        // The tags are gone: the next check regrids and the fine level goes.
+        amrex::Print() << "No tags\n";
+        tag_region = Box();
+        first = amr.levelSteps(0);
+        advance(amr, regrid_int);
+        if (ioproc) {
+            auto const& d = read_decisions(regrid_log, first, amr.levelSteps(0)-1);
+            AMREX_ALWAYS_ASSERT(d.size() == 1);
+            AMREX_ALWAYS_ASSERT(d[0].action == "regrid" && d[0].reason == "no tags");
+        }
+        AMREX_ALWAYS_ASSERT(amr.finestLevel() == 0);
+
+        amrex::Print() << "adaptive regrid test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,164 @@
+#include <AMReX.H>
+#include <AMReX_AmrMesh.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+
+using namespace amrex;
+
+namespace {
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool is_tagged (IntVect const& iv, Real radius, Real width, Real center)
+    {
+        Real r2 = 0.0;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            Real d = (iv[idim] + Real(0.5)) - center;
+            r2 += d*d;
+        }
+        Real r = std::sqrt(r2);
+        return r > radius - width && r < radius + width;
+    }
+}
+
+// Tags a spherical shell on level 0 and builds level 1 from it.
+class ClusterMesh
+    : public AmrMesh
+{
+public:
+    ClusterMesh (Geometry const& geom, AmrInfo const& info, Real radius, Real width)
+        : AmrMesh(geom, info), m_radius(radius), m_width(width)
+    {
+        m_center = Real(0.5) * geom.Domain().length(0);
+    }
+
+    void ErrorEst (int /*lev*/, TagBoxArray& tags, Real /*time*/, int /*ngrow*/) override
+    {
+        const Real radius = m_radius, width = m_width, center = m_center;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+            auto const& tag = tags.array(mfi);
+            amrex::ParallelFor(mfi.validbox(),
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                if (is_tagged(IntVect(AMREX_D_DECL(i,j,k)), radius, width, center)) {
+                    tag(i,j,k) = TagBox::SET;
+                }
+            });
+        }
+    }
+
+    void useDistributedClustering (bool flag) { SetUseDistributedClustering(flag); }
+
+    Real m_radius, m_width, m_center;
+};
+
+void test ()
+{
+    int n_cell = 128;
+    int max_grid_size = 32;
+    int blocking_factor = 8;
+    int nreps = 3;
+    Real grid_eff = 0.7;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("blocking_factor", blocking_factor);
+        pp.query("grid_eff", grid_eff);
+        pp.query("nreps", nreps);
+    }
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+
+    AmrInfo info;
+    info.max_level = 1;
+    info.max_grid_size = {IntVect(max_grid_size)};
+    info.blocking_factor = {IntVect(blocking_factor)};
+    info.grid_eff = grid_eff;
+
+    const Real radius = Real(0.3)*n_cell;
+    const Real width = Real(1.5);
+    ClusterMesh mesh(geom, info, radius, width);
+
+    BoxArray ba0 = mesh.MakeBaseGrids();
+    mesh.SetBoxArray(0, ba0);
+    mesh.SetDistributionMap(0, DistributionMapping(ba0));
+    mesh.SetFinestLevel(0);
+
+    Long ntagged = 0;
+    for (BoxIterator bit(domain); bit.ok(); ++bit) {
+        if (is_tagged(bit(), radius, width, mesh.m_center)) { ++ntagged; }
+    }
+    const IntVect rr = mesh.refRatio(0);
+
+    {
+        // The tags in ghost cells are not counted.
+        TagBoxArray tags(ba0, mesh.DistributionMap(0), 2);
+        mesh.ErrorEst(0, tags, 0.0, 0);
+        tags.setBndry(TagBox::SET);
+        AMREX_ALWAYS_ASSERT(tags.numTags() == ntagged);
+    }
+
+    {
+        TagBoxArray tags(ba0, mesh.DistributionMap(0));
+        tags.setVal(TagBox::CLEAR);
+        mesh.ErrorEst(0, tags, 0.0, 0);
+        AMREX_ALWAYS_ASSERT(tags.numTags() == ntagged);
+
+        Gpu::PinnedVector<IntVect> tagvec;
+        tags.collate(tagvec);
+        if (ParallelDescriptor::IOProcessor()) {
+            AMREX_ALWAYS_ASSERT(static_cast<Long>(tagvec.size()) == ntagged);
+            for (auto const& iv : tagvec) {
+                AMREX_ALWAYS_ASSERT(is_tagged(iv, radius, width, mesh.m_center));
+            }
+        }
+    }
+
+    amrex::Print() << "Clustering " << ntagged << " tagged cells on " << ba0.size()
+                   << " grids with " << ParallelDescriptor::NProcs() << " processes\n";
+
+    for (int distributed = 0; distributed < 2; ++distributed)
+    {
+        mesh.useDistributedClustering(distributed);
+
+        Vector<BoxArray> new_grids(2);
+        int new_finest = 0;
+        mesh.MakeNewGrids(0, 0.0, new_finest, new_grids);
+
+        ParallelDescriptor::Barrier();
+        Real t0 = amrex::second();
+        for (int irep = 0; irep < nreps; ++irep) {
+            new_grids[1] = BoxArray();
+            mesh.MakeNewGrids(0, 0.0, new_finest, new_grids);
+        }
+        Real t = (amrex::second() - t0) / nreps;
+        ParallelDescriptor::ReduceRealMax(t);
+
+        AMREX_ALWAYS_ASSERT(new_finest == 1);
+        BoxArray const& ba1 = new_grids[1];
+        AMREX_ALWAYS_ASSERT(ba1.isDisjoint());
+        for (BoxIterator bit(domain); bit.ok(); ++bit) {
+            if (is_tagged(bit(), radius, width, mesh.m_center)) {
+                AMREX_ALWAYS_ASSERT(ba1.contains(amrex::refine(Box(bit(),bit()),rr)));
+            }
+        }
+
+        Real eff = static_cast<Real>(ntagged) * AMREX_D_TERM(rr[0],*rr[1],*rr[2])
+            / static_cast<Real>(ba1.d_numPts());
+        amrex::Print() << (distributed ? "  distributed" : "  serial     ")
+                       << " clustering: " << ba1.size() << " grids, efficiency "
+                       << eff << ", " << t << " s per MakeNewGrids\n";
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    test();
+    amrex::Finalize();
+}
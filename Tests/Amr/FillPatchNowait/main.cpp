@@ -0,0 +1,219 @@
+//
+// Compares the split-phase FillPatchSingleLevel_nowait and
+// FillPatchTwoLevels_nowait with the blocking fills, for destinations on
+// the grids of the sources and on other grids.  When the destination is
+// on other grids, the copy of its valid cells must still be in flight when
+// the handle is returned.
+//
+#include <AMReX.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+constexpr Real sentinel = -1.e30;
+
+void init (MultiFab& mf, Geometry const& geom, Real t)
+{
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (AMREX_SPACEDIM == 3) ? (k+0.5)*dx[2] : Real(0.);
+            a(i,j,k,n) = std::sin(6.2831853*x) * (1.+y*y) + z*(n+1) + t;
+        });
+    }
+}
+
+// The number of valid cells of mf that still hold the sentinel.
+Long num_unfilled (MultiFab const& mf)
+{
+    Long n = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.const_array(mfi);
+        const Box& bx = mfi.validbox();
+        amrex::LoopOnCpu(bx, mf.nComp(), [&] (int i, int j, int k, int c)
+        {
+            if (a(i,j,k,c) == sentinel) { ++n; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(n);
+    return n;
+}
+
+// The max difference between the cells of a and b, ghost cells included.
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrowVect());
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), a.nGrowVect());
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), a.nGrowVect());
+    return d.norm0(0, a.nComp(), a.nGrowVect());
+}
+
+// A DistributionMapping with the grids of dm moved to the next rank.
+DistributionMapping shifted (DistributionMapping const& dm)
+{
+    Vector<int> pmap = dm.ProcessorMap();
+    for (auto& p : pmap) { p = (p+1) % ParallelDescriptor::NProcs(); }
+    return DistributionMapping(std::move(pmap));
+}
+
+// Checks the fill started by start against the blocking fill by fill into
+// a MultiFab on ba and dm.  expect_pending says whether some valid cells
+// must not have been copied yet when start returns.
+template <typename Start, typename Fill>
+void check (std::string const& name, BoxArray const& ba, DistributionMapping const& dm,
+            int ncomp, int ngrow, bool expect_pending, Start&& start, Fill&& fill)
+{
+    MultiFab ref(ba, dm, ncomp, ngrow);
+    ref.setVal(sentinel);
+    fill(ref);
+
+    MultiFab mf(ba, dm, ncomp, ngrow);
+    mf.setVal(sentinel);
+    FillPatchHandle handle = start(mf);
+    const Long nunfilled = num_unfilled(mf);
+    AMREX_ALWAYS_ASSERT(handle.isPending());
+    handle.finish();
+
+    const Real diff = max_diff(mf, ref);
+    amrex::Print() << name << ": " << nunfilled << " valid cells pending on return, "
+                   << "max difference " << diff << "\n";
+    AMREX_ALWAYS_ASSERT(diff == 0.0);
+    AMREX_ALWAYS_ASSERT(num_unfilled(mf) == 0);
+    if (expect_pending) {
+        AMREX_ALWAYS_ASSERT(nunfilled > 0);
+    } else {
+        AMREX_ALWAYS_ASSERT(nunfilled == 0);
+    }
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    int dst_max_grid_size = 8;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("dst_max_grid_size", dst_max_grid_size);
+    }
+
+    const int ncomp = 2;
+    const int ngrow = 2;
+    // Only local copies can finish before the handle is returned.
+    const bool remote = ParallelDescriptor::NProcs() > 1;
+
+    const RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    const Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,0,0)};
+    const Box fdomain(IntVect(0), IntVect(n_cell-1));
+    const Box cdomain = amrex::coarsen(fdomain, 2);
+    Geometry fgeom(fdomain, rb, CoordSys::cartesian, is_periodic);
+    Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+
+    PhysBCFunctNoOp physbc;
+
+    // Single level
+    {
+        BoxArray ba(fdomain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        MultiFab s0(ba, dm, ncomp, 0), s1(ba, dm, ncomp, 0);
+        init(s0, fgeom, 0.);
+        init(s1, fgeom, 1.);
+
+        BoxArray dba(fdomain);
+        dba.maxSize(dst_max_grid_size);
+        DistributionMapping ddm(dba);
+
+        for (int nsrc = 1; nsrc <= 2; ++nsrc) {
+            Vector<MultiFab*> smf{&s0};
+            Vector<Real> stime{0.};
+            Real time = 0.;
+            if (nsrc == 2) {
+                smf.push_back(&s1);
+                stime.push_back(1.);
+                time = 0.25;
+            }
+            auto start = [&] (MultiFab& mf) {
+                return FillPatchSingleLevel_nowait(mf, mf.nGrowVect(), time, smf, stime,
+                                                   0, 0, ncomp, fgeom, physbc, 0);
+            };
+            auto fill = [&] (MultiFab& mf) {
+                FillPatchSingleLevel(mf, mf.nGrowVect(), time, smf, stime,
+                                     0, 0, ncomp, fgeom, physbc, 0);
+            };
+            const std::string name = "single level, " + std::to_string(nsrc) + " source(s)";
+            check(name + ", same grids", ba, dm, ncomp, ngrow, false, start, fill);
+            check(name + ", other ranks", ba, shifted(dm), ncomp, ngrow, remote, start, fill);
+            check(name + ", other grids", dba, shifted(ddm), ncomp, ngrow, remote, start, fill);
+        }
+    }
+
+    // Two levels, with the fine level covering the middle half of the domain
+    {
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+        MultiFab c0(cba, cdm, ncomp, 0);
+        init(c0, cgeom, 0.);
+
+        const Box fbox = amrex::grow(fdomain, -n_cell/4);
+        BoxArray fba(fbox);
+        fba.maxSize(max_grid_size);
+        DistributionMapping fdm(fba);
+        MultiFab f0(fba, fdm, ncomp, 0);
+        init(f0, fgeom, 0.);
+
+        BoxArray dba(fbox);
+        dba.maxSize(dst_max_grid_size);
+        DistributionMapping ddm(dba);
+
+        Vector<MultiFab*> cmf{&c0}, fmf{&f0};
+        Vector<Real> ctime{0.}, ftime{0.};
+        Vector<BCRec> bcs(ncomp);
+        for (auto& bc : bcs) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                const int t = is_periodic[idim] ? BCType::int_dir : BCType::foextrap;
+                bc.setLo(idim, t);
+                bc.setHi(idim, t);
+            }
+        }
+
+        auto start = [&] (MultiFab& mf) {
+            return FillPatchTwoLevels_nowait(mf, mf.nGrowVect(), 0., cmf, ctime, fmf, ftime,
+                                             0, 0, ncomp, cgeom, fgeom, physbc, 0, physbc, 0,
+                                             IntVect(2), &cell_cons_interp, bcs, 0);
+        };
+        auto fill = [&] (MultiFab& mf) {
+            FillPatchTwoLevels(mf, mf.nGrowVect(), 0., cmf, ctime, fmf, ftime,
+                               0, 0, ncomp, cgeom, fgeom, physbc, 0, physbc, 0,
+                               IntVect(2), &cell_cons_interp, bcs, 0);
+        };
+        check("two levels, same grids", fba, fdm, ncomp, ngrow, false, start, fill);
+        check("two levels, other grids", dba, shifted(ddm), ncomp, ngrow, remote, start, fill);
+    }
+
+    amrex::Print() << "FillPatch nowait test passed\n";
+}
@@ -0,0 +1,187 @@
+//
+// Compares FillPatchTwoLevels with the coarse/fine patches pooled in the
+// FPinfo cache (fabarray.pool_fillpatch_patches) with the unpooled fills:
+// two fills with the same FPinfo, and a fill whose coarse boundary functor
+// does another fill with the same FPinfo while the patches of the first are
+// in use.  Then checks that the pool is freed by flushFPPatchPool.
+//
+#include <AMReX.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_Print.H>
+
+#include <functional>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+void init (MultiFab& mf, Geometry const& geom, Real t)
+{
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (AMREX_SPACEDIM == 3) ? (k+0.5)*dx[2] : Real(0.);
+            a(i,j,k,n) = std::sin(6.2831853*x) * (1.+y*y) + z*(n+1) + t;
+        });
+    }
+}
+
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrowVect());
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), a.nGrowVect());
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), a.nGrowVect());
+    return d.norm0(0, a.nComp(), a.nGrowVect());
+}
+
+struct Levels
+{
+    Geometry cgeom, fgeom;
+    Vector<MultiFab*> cmf, fmf;
+    Vector<Real> time{0.};
+    Vector<BCRec> bcs;
+};
+
+void fill (MultiFab& mf, Levels const& lev, std::function<void()> const& nested)
+{
+    // A boundary functor that does nothing but run nested on its first call.
+    struct BC
+    {
+        std::function<void()> nested;
+        void operator() (MultiFab&, int, int, IntVect const&, Real, int) {
+            if (nested) {
+                auto f = std::move(nested);
+                nested = nullptr;
+                f();
+            }
+        }
+    };
+    BC cbc{nested}, fbc{nullptr};
+    FillPatchTwoLevels(mf, mf.nGrowVect(), 0., lev.cmf, lev.time, lev.fmf, lev.time,
+                       0, 0, mf.nComp(), lev.cgeom, lev.fgeom, cbc, 0, fbc, 0,
+                       IntVect(2), &cell_cons_interp, lev.bcs, 0);
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 8;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    const int ncomp = 2;
+    const int ngrow = 2;
+
+    const RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    const Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,0,0)};
+    const Box fdomain(IntVect(0), IntVect(n_cell-1));
+    const Box cdomain = amrex::coarsen(fdomain, 2);
+
+    Levels a, b;
+    a.cgeom = b.cgeom = Geometry(cdomain, rb, CoordSys::cartesian, is_periodic);
+    a.fgeom = b.fgeom = Geometry(fdomain, rb, CoordSys::cartesian, is_periodic);
+    a.bcs.resize(ncomp);
+    for (auto& bc : a.bcs) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const int t = is_periodic[idim] ? BCType::int_dir : BCType::foextrap;
+            bc.setLo(idim, t);
+            bc.setHi(idim, t);
+        }
+    }
+    b.bcs = a.bcs;
+
+    // The fine level covers the middle half of the domain.  The sources of
+    // a and b have the same grids and different data.
+    BoxArray cba(cdomain);
+    cba.maxSize(max_grid_size);
+    DistributionMapping cdm(cba);
+    BoxArray fba(amrex::grow(fdomain, -n_cell/4));
+    fba.maxSize(max_grid_size);
+    DistributionMapping fdm(fba);
+    MultiFab ca(cba, cdm, ncomp, 0), fa(fba, fdm, ncomp, 0);
+    MultiFab cb(cba, cdm, ncomp, 0), fb(fba, fdm, ncomp, 0);
+    init(ca, a.cgeom, 0.);
+    init(fa, a.fgeom, 0.);
+    init(cb, b.cgeom, 10.);
+    init(fb, b.fgeom, 10.);
+    a.cmf = {&ca};
+    a.fmf = {&fa};
+    b.cmf = {&cb};
+    b.fmf = {&fb};
+
+    // The destinations all have the grids of the fine sources, so the fills
+    // share one FPinfo.
+    auto make_dst = [&] () { return MultiFab(fba, fdm, ncomp, ngrow); };
+
+    Array<MultiFab,2> twice;
+    Array<MultiFab,2> outer, inner;
+    for (bool pool : {false, true})
+    {
+        FabArrayBase::pool_fillpatch_patches = pool;
+
+        MultiFab& t = twice[pool];
+        t = make_dst();
+        MultiFab t1 = make_dst();
+        t.setVal(0.);
+        t1.setVal(0.);
+        fill(t1, a, nullptr);
+        fill(t, a, nullptr);
+        AMREX_ALWAYS_ASSERT(max_diff(t, t1) == 0.0);
+
+        outer[pool] = make_dst();
+        inner[pool] = make_dst();
+        outer[pool].setVal(0.);
+        inner[pool].setVal(0.);
+        MultiFab& in = inner[pool];
+        fill(outer[pool], a, [&] () { fill(in, b, nullptr); });
+    }
+
+    const Real dtwice = max_diff(twice[1], twice[0]);
+    const Real douter = max_diff(outer[1], outer[0]);
+    const Real dinner = max_diff(inner[1], inner[0]);
+    amrex::Print() << "pooled vs unpooled: two fills " << dtwice << ", nested fill "
+                   << douter << " outside and " << dinner << " inside\n";
+    AMREX_ALWAYS_ASSERT(dtwice == 0.0 && douter == 0.0 && dinner == 0.0);
+    AMREX_ALWAYS_ASSERT(max_diff(outer[1], inner[1]) > 1.0);
+
+    // The pooled patches are kept in the FPinfo, and none is left busy.
+    const FabArrayBase::FPinfo& fpc = FabArrayBase::TheFPinfo(fa, twice[1], IntVect(ngrow),
+                                                              cell_cons_interp.BoxCoarsener(IntVect(2)),
+                                                              a.fgeom, a.cgeom, nullptr);
+    auto npooled = [&] () {
+        int n = 0;
+        for (auto const& p : fpc.m_patch_pool) {
+            AMREX_ALWAYS_ASSERT(!p.second.busy);
+            if (p.second.mf) { ++n; }
+        }
+        return n;
+    };
+    AMREX_ALWAYS_ASSERT(fpc.m_patch_busy.empty());
+    AMREX_ALWAYS_ASSERT(npooled() > 0);
+    FabArrayBase::flushFPPatchPool();
+    AMREX_ALWAYS_ASSERT(npooled() == 0);
+
+    amrex::Print() << "FillPatch pool test passed\n";
+}
@@ -0,0 +1,133 @@
+//
+// Runs the Advection_AmrLevel single vortex problem with
+// amr.incremental_regrid.  After the new level of a regrid is filled from
+// the old one, which moves the FABs of unchanged boxes into it, the old
+// data are read a second time.  That copies the moved FABs back, and the
+// result must match the new level.  The run is done with
+// amr.incremental_regrid_max_imbalance so large that the unchanged boxes
+// always keep their rank, and so small that a new DistributionMapping is
+// made unless the ranks are exactly balanced.
+//
+#include <AMReX_Amr.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <AmrLevelAdv.H>
+
+using namespace amrex;
+
+namespace {
+
+Real max_imbalance = 0.0;
+int  nregrids = 0;
+Long ncells_moved = 0;
+
+class AmrLevelCheck
+    :
+    public AmrLevelAdv
+{
+public:
+    using AmrLevelAdv::AmrLevelAdv;
+
+    void init (AmrLevel& old) override
+    {
+        AmrLevelAdv::init(old);
+        ++nregrids;
+        ncells_moved += parent->regridCellsReused(level);
+
+        // A second read of the old data, into a MultiFab that is not state
+        // data, so that nothing is moved.
+        MultiFab const& S_new = get_new_data(Phi_Type);
+        MultiFab S_again(grids, dmap, S_new.nComp(), 0);
+        FillPatch(old, S_again, 0, state[Phi_Type].curTime(), Phi_Type, 0, S_new.nComp());
+        MultiFab::Subtract(S_again, S_new, 0, 0, S_new.nComp(), 0);
+        const Real err = S_again.norm0(0, S_new.nComp(), IntVect(0));
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(err == 0.0, "the moved FABs were not copied back");
+
+        // The unchanged boxes keep their rank, unless the load imbalance
+        // exceeds the cap.  Then the map is a new one.
+        BoxArray const& oba = old.boxArray();
+        DistributionMapping const& odm = old.DistributionMap();
+        bool kept = true;
+        Vector<Long> load(ParallelDescriptor::NProcs(), 0);
+        for (int i = 0; i < grids.size(); ++i) {
+            for (auto const& is : oba.intersections(grids[i])) {
+                if (oba[is.first] == grids[i] && odm[is.first] != dmap[i]) { kept = false; }
+            }
+            load[dmap[i]] += grids[i].numPts();
+        }
+        const Real imbalance = *std::max_element(load.begin(), load.end())
+            / (static_cast<Real>(grids.numPts()) / ParallelDescriptor::NProcs());
+        const bool fresh = dmap.ProcessorMap() == DistributionMapping(grids).ProcessorMap();
+        amrex::Print() << "Level " << level << ": " << parent->regridCellsReused(level)
+                       << " cells moved, load imbalance " << imbalance
+                       << (fresh ? ", new map" : "") << "\n";
+        AMREX_ALWAYS_ASSERT(fresh || (kept && imbalance <= max_imbalance));
+        if (max_imbalance > 1.e10) {
+            AMREX_ALWAYS_ASSERT(kept);
+        }
+    }
+};
+
+class LevelBldCheck
+    :
+    public LevelBld
+{
+    void variableSetUp () override { AmrLevelAdv::variableSetUp(); }
+    void variableCleanUp () override { AmrLevelAdv::variableCleanUp(); }
+    AmrLevel* operator() () override { return new AmrLevelCheck; }
+    AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom,
+                          const BoxArray& ba, const DistributionMapping& dm,
+                          Real time) override
+    {
+        return new AmrLevelCheck(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+LevelBldCheck check_bld;
+
+}
+
+int
+main (int   argc,
+      char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int max_step = 8;
+        {
+            ParmParse pp;
+            pp.query("max_step",max_step);
+        }
+        const Real strt_time = 0.0;
+        const Real stop_time = -1.0;
+
+        for (Real cap : {Real(1.e20), Real(1.0)})
+        {
+            max_imbalance = cap;
+            nregrids = 0;
+            ncells_moved = 0;
+            {
+                ParmParse pp("amr");
+                pp.remove("incremental_regrid_max_imbalance");
+                pp.add("incremental_regrid_max_imbalance", cap);
+            }
+
+            Amr amr(&check_bld);
+            amr.init(strt_time,stop_time);
+            while (amr.okToContinue() && amr.levelSteps(0) < max_step) {
+                amr.coarseTimeStep(stop_time);
+            }
+
+            amrex::Print() << "amr.incremental_regrid_max_imbalance = " << cap << ": "
+                           << nregrids << " regrids of a level, "
+                           << ncells_moved << " cells moved\n";
+            AMREX_ALWAYS_ASSERT(nregrids > 0);
+            if (cap > 1.e10) {
+                AMREX_ALWAYS_ASSERT(ncells_moved > 0);
+            }
+        }
+    }
+    amrex::Finalize();
+}
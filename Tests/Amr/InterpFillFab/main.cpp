@@ -0,0 +1,149 @@
+//
+// Compares InterpFillFab, which interpolates in time straight from the
+// source fabs with FillFabLinComb, with the implementation that fills two
+// temporaries set to NaN and interpolates between them.  The sources have
+// a hole, so some destination cells are covered by no source: these must be
+// NaN in both, and the other components of the destination untouched.
+//
+#include <AMReX.H>
+#include <AMReX_MFCopyDescriptor.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cstring>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+constexpr Real sentinel = -1.e30;
+
+void init (MultiFab& mf, Real t)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = std::sin(0.3*i+0.1*n) * (1.+0.01*j*j) + 0.7*k + t*(n+1);
+        });
+    }
+}
+
+// InterpFillFab before FillFabLinComb.
+void interp_fill_fab_temporaries (MultiFabCopyDescriptor& mfcd, Vector<FillBoxId> const& ids,
+                                  MultiFabId id1, MultiFabId id2, FArrayBox& dest,
+                                  Real t1, Real t2, Real t, int src_comp, int dest_comp,
+                                  int num_comp)
+{
+    FArrayBox dest1(dest.box(), dest.nComp());
+    dest1.setVal<RunOn::Host>(std::numeric_limits<Real>::quiet_NaN());
+    FArrayBox dest2(dest.box(), dest.nComp());
+    dest2.setVal<RunOn::Host>(std::numeric_limits<Real>::quiet_NaN());
+    mfcd.FillFab(id1, ids[0], dest1);
+    mfcd.FillFab(id2, ids[1], dest2);
+    dest.linInterp<RunOn::Host>(dest1, src_comp, dest2, src_comp, t1, t2, t,
+                                dest.box(), dest_comp, num_comp);
+}
+
+// The number of values of a that are NaN, or -1 if a and b differ in any
+// bit.
+Long num_nan_if_same (FArrayBox const& a, FArrayBox const& b)
+{
+    if (std::memcmp(a.dataPtr(), b.dataPtr(), a.nBytes()) != 0) { return -1; }
+    Long n = 0;
+    for (Long i = 0, N = a.size(); i < N; ++i) {
+        if (std::isnan(a.dataPtr()[i])) { ++n; }
+    }
+    return n;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 8;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    const int ncomp = 3;
+
+    // The domain without a box in the middle.
+    const Box domain(IntVect(0), IntVect(n_cell-1));
+    const Box hole(IntVect(n_cell/4+1), IntVect(n_cell/2+2));
+    BoxArray ba(amrex::boxDiff(domain, hole));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    MultiFab s1(ba, dm, ncomp, 0), s2(ba, dm, ncomp, 0);
+    init(s1, 1.0);
+    init(s2, 2.0);
+    const Real t1 = 1.0, t2 = 2.0, t = 1.3;
+
+    // Destination boxes that cover the hole, cross grids, and stick out of
+    // the domain.  Every rank fills all of them.
+    Vector<Box> dest_boxes{amrex::grow(hole, 2),
+                           Box(IntVect(n_cell/2-3), IntVect(n_cell/2+4)),
+                           amrex::grow(Box(IntVect(0), IntVect(max_grid_size)), 2),
+                           domain};
+
+    // The components: all of them, and one in the middle of the destination.
+    struct Comps { int src, dest, num; };
+    for (Comps const& c : {Comps{0,0,ncomp}, Comps{1,1,1}})
+    {
+        MultiFabCopyDescriptor mfcd;
+        MultiFabId id1 = mfcd.RegisterMultiFab(&s1);
+        MultiFabId id2 = mfcd.RegisterMultiFab(&s2);
+        Vector<Vector<FillBoxId> > ids(dest_boxes.size());
+        for (int i = 0; i < dest_boxes.size(); ++i) {
+            BoxList unfilled(IndexType::TheCellType());
+            InterpAddBox(mfcd, &unfilled, ids[i], dest_boxes[i], id1, id2, t1, t2, t,
+                         c.src, c.dest, c.num, false);
+        }
+        mfcd.CollectData();
+
+        Long nnan = 0;
+        for (int i = 0; i < dest_boxes.size(); ++i) {
+            FArrayBox dest(dest_boxes[i], ncomp), ref(dest_boxes[i], ncomp);
+            dest.setVal<RunOn::Host>(sentinel);
+            ref.setVal<RunOn::Host>(sentinel);
+            InterpFillFab(mfcd, ids[i], id1, id2, dest, t1, t2, t, c.src, c.dest, c.num, false);
+            interp_fill_fab_temporaries(mfcd, ids[i], id1, id2, ref, t1, t2, t,
+                                        c.src, c.dest, c.num);
+            const Long n = num_nan_if_same(dest, ref);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(n >= 0, "InterpFillFab differs from the temporaries");
+            nnan += n;
+
+            // The uncovered cells are NaN in the components filled, and only there.
+            const Box uncovered = dest_boxes[i] & hole;
+            if (uncovered.ok()) {
+                const auto& a = dest.const_array();
+                amrex::LoopOnCpu(uncovered, ncomp, [&] (int ii, int jj, int kk, int n)
+                {
+                    const bool filled = n >= c.dest && n < c.dest + c.num;
+                    AMREX_ALWAYS_ASSERT(filled ? std::isnan(a(ii,jj,kk,n))
+                                               : a(ii,jj,kk,n) == sentinel);
+                });
+            }
+        }
+        ParallelDescriptor::ReduceLongSum(nnan);
+        amrex::Print() << "components " << c.dest << " to " << c.dest+c.num-1
+                       << ": the same as with temporaries, " << nnan << " NaN values\n";
+        AMREX_ALWAYS_ASSERT(nnan > 0);
+    }
+
+    amrex::Print() << "InterpFillFab test passed\n";
+}
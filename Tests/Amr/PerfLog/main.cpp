@@ -0,0 +1,345 @@
+//
+// Runs the Advection_AmrLevel single vortex problem with amr.perf_log and
+// checks the records against the run.  There is one record per coarse step
+// and one entry per level, with the cell, grid and advance counts of the
+// step.  A fixed region is tagged, on level 0 only at first, so that the
+// finest level is made by a regrid during the run.  The interpolater of the
+// state sleeps on every call, so that the FillPatch in advance, the
+// FillPatch of init after a regrid and the FillCoarsePatch of the new level
+// take a known minimum time, which the recorded FillPatch time of the level
+// must cover.  It must also stay below
+// the step time, which it would not if a FillPatch done inside another were
+// counted twice.  The run is done with the JSON and the CSV format, and
+// with amr.record_perf_info = 0, which must not write a log.
+//
+#include <AMReX_Amr.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+
+#include <AmrLevelAdv.H>
+
+#include <chrono>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace amrex;
+
+namespace {
+
+Amr* the_amr = nullptr;
+
+// The tagged cells in the index space of level 0, and the levels tagged.
+Box tag_region;
+int tag_levels = 0;
+std::chrono::milliseconds interp_sleep(0);
+
+// Per level, over one coarse step on this rank.
+Vector<Long> ninterp;
+Vector<int>  nadvance;
+
+class SlowInterp
+    :
+    public CellConservativeLinear
+{
+public:
+    void interp (const FArrayBox& crse, int crse_comp, FArrayBox& fine, int fine_comp,
+                 int ncomp, const Box& fine_region, const IntVect& ratio,
+                 const Geometry& crse_geom, const Geometry& fine_geom,
+                 Vector<BCRec> const& bcr, int actual_comp, int actual_state,
+                 RunOn gpu_or_cpu) override
+    {
+        int lev = 0;
+        while (the_amr->Geom(lev).Domain() != fine_geom.Domain()) { ++lev; }
+        // One at a time, so that the sleeps add up on each rank.
+#ifdef AMREX_USE_OMP
+#pragma omp critical (perflog_interp)
+#endif
+        {
+            ++ninterp[lev];
+            std::this_thread::sleep_for(interp_sleep);
+        }
+        CellConservativeLinear::interp(crse, crse_comp, fine, fine_comp, ncomp, fine_region,
+                                       ratio, crse_geom, fine_geom, bcr, actual_comp,
+                                       actual_state, gpu_or_cpu);
+    }
+};
+
+SlowInterp slow_interp;
+
+class AmrLevelCheck
+    :
+    public AmrLevelAdv
+{
+public:
+    using AmrLevelAdv::AmrLevelAdv;
+
+    Real advance (Real time, Real dt, int iteration, int ncycle) override
+    {
+        ++nadvance[level];
+        return AmrLevelAdv::advance(time, dt, iteration, ncycle);
+    }
+
+    void errorEst (TagBoxArray& tags, int /*clearval*/, int /*tagval*/, Real /*time*/,
+                   int /*n_error_buf*/, int /*ngrow*/) override
+    {
+        if (level >= tag_levels) { return; }
+        Box region = tag_region;
+        for (int lev = 0; lev < level; ++lev) {
+            region.refine(parent->refRatio(lev));
+        }
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+            const Box bx = mfi.validbox() & region;
+            if (bx.ok()) {
+                tags[mfi].setVal<RunOn::Device>(TagBox::SET, bx);
+            }
+        }
+    }
+
+    static void variableSetUp ()
+    {
+        AmrLevelAdv::variableSetUp();
+        const StateDescriptor& desc = desc_lst[Phi_Type];
+        desc_lst.setComponent(Phi_Type, 0, desc.name(0), desc.getBC(0),
+                              desc.bndryFill(0), &slow_interp);
+    }
+};
+
+class LevelBldCheck
+    :
+    public LevelBld
+{
+    void variableSetUp () override { AmrLevelCheck::variableSetUp(); }
+    void variableCleanUp () override { AmrLevelAdv::variableCleanUp(); }
+    AmrLevel* operator() () override { return new AmrLevelCheck; }
+    AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom,
+                          const BoxArray& ba, const DistributionMapping& dm,
+                          Real time) override
+    {
+        return new AmrLevelCheck(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+LevelBldCheck check_bld;
+
+struct LevelRecord
+{
+    int  level = -1;
+    Long ncells = 0;
+    int  ngrids = 0;
+    int  nadvance = 0;
+    Real advance_time = 0, regrid_time = 0, fillpatch_time = 0, post_step_time = 0;
+    Long fab_bytes = 0;
+    Real load_balance_eff = 0;
+};
+
+struct StepRecord
+{
+    int  step = -1;
+    Real step_time = 0;
+    Vector<LevelRecord> levels;
+};
+
+// The value of a field of a JSON object.
+std::string field (std::string const& s, std::string const& key)
+{
+    const std::string k = "\"" + key + "\":";
+    auto pos = s.find(k);
+    AMREX_ALWAYS_ASSERT(pos != std::string::npos);
+    pos += k.size();
+    return s.substr(pos, s.find_first_of(",}]", pos) - pos);
+}
+
+LevelRecord level_record (std::function<std::string(std::string const&)> const& get)
+{
+    LevelRecord r;
+    r.level            = std::stoi(get("level"));
+    r.ncells           = std::stol(get("ncells"));
+    r.ngrids           = std::stoi(get("ngrids"));
+    r.nadvance         = std::stoi(get("nadvance"));
+    r.advance_time     = std::stod(get("advance_time"));
+    r.regrid_time      = std::stod(get("regrid_time"));
+    r.fillpatch_time   = std::stod(get("fillpatch_time"));
+    r.post_step_time   = std::stod(get("post_step_time"));
+    r.fab_bytes        = std::stol(get("fab_bytes"));
+    r.load_balance_eff = std::stod(get("load_balance_eff"));
+    return r;
+}
+
+Vector<StepRecord> read_json (std::string const& file)
+{
+    Vector<StepRecord> r;
+    std::ifstream is(file);
+    std::string line;
+    while (std::getline(is, line)) {
+        StepRecord s;
+        s.step = std::stoi(field(line, "step"));
+        s.step_time = std::stod(field(line, "step_time"));
+        const std::string key = "{\"level\":";
+        for (auto pos = line.find(key); pos != std::string::npos; pos = line.find(key, pos+1)) {
+            const std::string lev = line.substr(pos, line.find('}', pos) - pos + 1);
+            s.levels.push_back(level_record([&] (std::string const& k) { return field(lev, k); }));
+        }
+        r.push_back(std::move(s));
+    }
+    return r;
+}
+
+Vector<StepRecord> read_csv (std::string const& file)
+{
+    Vector<StepRecord> r;
+    std::ifstream is(file);
+    std::string line;
+    std::getline(is, line);
+    AMREX_ALWAYS_ASSERT(line == "step,time,dt,step_time,cell_updates_per_sec,level,ncells,"
+                        "ngrids,nadvance,advance_time,regrid_time,fillpatch_time,"
+                        "post_step_time,fab_bytes,comm_bytes,load_balance_eff");
+    Vector<std::string> columns;
+    {
+        std::istringstream ss(line);
+        for (std::string c; std::getline(ss, c, ','); ) { columns.push_back(c); }
+    }
+    while (std::getline(is, line)) {
+        Vector<std::string> values;
+        std::istringstream ss(line);
+        for (std::string v; std::getline(ss, v, ','); ) { values.push_back(v); }
+        AMREX_ALWAYS_ASSERT(values.size() == columns.size());
+        auto get = [&] (std::string const& k) {
+            for (int i = 0; i < columns.size(); ++i) {
+                if (columns[i] == k) { return values[i]; }
+            }
+            amrex::Abort("no column " + k);
+            return std::string();
+        };
+        const int step = std::stoi(get("step"));
+        if (r.empty() || r.back().step != step) {
+            r.push_back(StepRecord{});
+            r.back().step = step;
+            r.back().step_time = std::stod(get("step_time"));
+        }
+        r.back().levels.push_back(level_record(get));
+    }
+    return r;
+}
+
+}
+
+int
+main (int   argc,
+      char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int max_step = 6;
+        int sleep_ms = 10;
+        {
+            ParmParse pp;
+            pp.query("max_step", max_step);
+            pp.query("interp_sleep_ms", sleep_ms);
+        }
+        interp_sleep = std::chrono::milliseconds(sleep_ms);
+        const Real sleep_time = 1.e-3 * sleep_ms;
+        tag_region = Box(IntVect(8), IntVect(23));
+        const bool ioproc = ParallelDescriptor::IOProcessor();
+
+        for (const char* fmt : {"json", "csv", "off"})
+        {
+            const std::string format = fmt;
+            const std::string perf_log = "perf_log." + format;
+            {
+                ParmParse pp("amr");
+                pp.remove("perf_log");
+                pp.remove("perf_log_format");
+                pp.remove("record_perf_info");
+                pp.add("perf_log", perf_log);
+                if (format == "off") {
+                    pp.add("record_perf_info", false);
+                } else {
+                    pp.add("perf_log_format", format);
+                }
+            }
+
+            // The log is appended to; start with none.
+            if (ioproc && FileSystem::Exists(perf_log)) {
+                FileSystem::Remove(perf_log);
+            }
+            ParallelDescriptor::Barrier();
+
+            Amr amr(&check_bld);
+            the_amr = &amr;
+            ninterp.assign(amr.maxLevel()+1, 0);
+            nadvance.assign(amr.maxLevel()+1, 0);
+            tag_levels = 1;
+            amr.init(0.0, -1.0);
+            AMREX_ALWAYS_ASSERT(amr.finestLevel() == 1);
+
+            // What each step did: its levels, grids and cells, its advances
+            // and the least time its FillPatches took on any rank.
+            Vector<StepRecord> expected;
+            Long ninterp_total = 0;
+            while (amr.okToContinue() && amr.levelSteps(0) < max_step) {
+                std::fill(ninterp.begin(), ninterp.end(), 0);
+                std::fill(nadvance.begin(), nadvance.end(), 0);
+                if (amr.levelSteps(0) == 2) { tag_levels = 2; }
+                amr.coarseTimeStep(-1.0);
+
+                ParallelDescriptor::ReduceLongMax(ninterp.data(), ninterp.size());
+                StepRecord s;
+                s.step = amr.levelSteps(0);
+                for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+                    LevelRecord r;
+                    r.level = lev;
+                    r.ncells = amr.cellCount(lev);
+                    r.ngrids = amr.numGrids(lev);
+                    r.nadvance = nadvance[lev];
+                    r.fillpatch_time = ninterp[lev] * sleep_time;
+                    s.levels.push_back(r);
+                    ninterp_total += ninterp[lev];
+                }
+                expected.push_back(std::move(s));
+            }
+            AMREX_ALWAYS_ASSERT(ninterp_total > 0 && amr.finestLevel() == 2);
+
+            if (ioproc)
+            {
+                if (format == "off") {
+                    AMREX_ALWAYS_ASSERT(!FileSystem::Exists(perf_log));
+                    continue;
+                }
+                auto const& records = (format == "json") ? read_json(perf_log) : read_csv(perf_log);
+                amrex::Print() << perf_log << ": " << records.size() << " records\n";
+                AMREX_ALWAYS_ASSERT(records.size() == expected.size());
+                for (int i = 0; i < records.size(); ++i)
+                {
+                    StepRecord const& s = records[i];
+                    StepRecord const& e = expected[i];
+                    AMREX_ALWAYS_ASSERT(s.step == e.step && s.levels.size() == e.levels.size());
+                    for (int lev = 0; lev < s.levels.size(); ++lev)
+                    {
+                        LevelRecord const& r = s.levels[lev];
+                        LevelRecord const& x = e.levels[lev];
+                        amrex::Print() << "  step " << s.step << " level " << lev
+                                       << ": fillpatch_time " << r.fillpatch_time
+                                       << ", at least " << x.fillpatch_time
+                                       << ", step_time " << s.step_time << "\n";
+                        AMREX_ALWAYS_ASSERT(r.level == lev && r.ncells == x.ncells &&
+                                            r.ngrids == x.ngrids && r.nadvance == x.nadvance);
+                        AMREX_ALWAYS_ASSERT(r.advance_time >= 0 && r.regrid_time >= 0 &&
+                                            r.post_step_time >= 0 && r.fab_bytes > 0);
+                        AMREX_ALWAYS_ASSERT(r.load_balance_eff > 0 && r.load_balance_eff <= 1.0001);
+                        AMREX_ALWAYS_ASSERT(r.fillpatch_time >= x.fillpatch_time);
+                        AMREX_ALWAYS_ASSERT(r.fillpatch_time <= s.step_time);
+                    }
+                }
+            }
+        }
+
+        amrex::Print() << "perf log test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,167 @@
+//
+// Runs the Advection_AmrLevel single vortex problem with checkpoints
+// written to a stage directory and drained in the background, checks the
+// checksums and completion marker of each checkpoint, and restarts from
+// the last one.  The runs end like the usual drivers, without calling
+// Amr::finishCheckpointDrain(): once with the last checkpoint written by
+// coarseTimeStep(), and once with the driver writing it after the loop.
+//
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <fstream>
+#include <sstream>
+
+using namespace amrex;
+
+amrex::LevelBld* getLevelBld ();
+
+namespace {
+
+void check_checkpoint (std::string const& ckfile, std::string const& stage_dir)
+{
+    if (!ParallelDescriptor::IOProcessor()) { return; }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!FileSystem::Exists(ckfile + ".temp"),
+                                     ckfile + ".temp was not renamed");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!FileSystem::Exists(stage_dir + "/" + ckfile + ".node0"),
+                                     "the stage directory of " + ckfile + " was not removed");
+    {
+        std::ifstream marker(ckfile + "/CheckpointComplete");
+        std::string name;
+        marker >> name;
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(name == ckfile, ckfile + " has no completion marker");
+    }
+
+    std::ifstream checksums(ckfile + "/Checksums");
+    AMREX_ALWAYS_ASSERT(checksums.good());
+    Vector<char> buf(1024*1024);
+    int nfiles = 0;
+    std::string line;
+    while (std::getline(checksums, line)) {
+        std::istringstream is(line);
+        std::uint32_t crc;
+        Long nbytes;
+        std::string rel;
+        is >> std::hex >> crc >> std::dec >> nbytes >> rel;
+        AMREX_ALWAYS_ASSERT(!is.fail());
+
+        std::ifstream ifs(ckfile + "/" + rel, std::ios::in | std::ios::binary);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ifs.good(), "cannot open " + ckfile + "/" + rel);
+        std::uint32_t crc_file = 0;
+        Long nbytes_file = 0;
+        while (ifs) {
+            ifs.read(buf.data(), buf.size());
+            const auto n = ifs.gcount();
+            if (n <= 0) { break; }
+            crc_file = amrex::CRC32(buf.data(), n, crc_file);
+            nbytes_file += n;
+        }
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(crc_file == crc && nbytes_file == nbytes,
+                                         "wrong checksum for " + ckfile + "/" + rel);
+        ++nfiles;
+    }
+    AMREX_ALWAYS_ASSERT(nfiles > 0);
+    amrex::Print() << ckfile << ": " << nfiles << " files match their checksums\n";
+}
+
+// Runs max_step steps like the Advection_AmrLevel driver, writing the
+// checkpoints check_file*, and returns the coarse level at the end.
+MultiFab run (int max_step, std::string const& check_file)
+{
+    {
+        ParmParse pp;
+        pp.remove("max_step");
+        pp.add("max_step", max_step);
+        ParmParse ppa("amr");
+        ppa.remove("check_file");
+        ppa.add("check_file", check_file);
+        ppa.remove("restart");
+    }
+    const Real strt_time = 0.0;
+    const Real stop_time = -1.0;
+
+    Amr amr(getLevelBld());
+    amr.init(strt_time,stop_time);
+    while (amr.okToContinue() && amr.levelSteps(0) < max_step) {
+        amr.coarseTimeStep(stop_time);
+    }
+    if (amr.stepOfLastCheckPoint() < amr.levelSteps(0)) {
+        amr.checkPoint();
+    }
+
+    MultiFab const& phi0 = amr.getLevel(0).get_new_data(0);
+    MultiFab phi(phi0.boxArray(), phi0.DistributionMap(), phi0.nComp(), 0);
+    MultiFab::Copy(phi, phi0, 0, 0, phi0.nComp(), 0);
+    return phi;
+}
+
+// Restarts from ckfile, which is at step, and compares the coarse level
+// with phi.
+void restart (std::string const& ckfile, int step, MultiFab const& phi)
+{
+    {
+        ParmParse pp("amr");
+        pp.remove("restart");
+        pp.add("restart", ckfile);
+    }
+    Amr amr(getLevelBld());
+    amr.init(0.0,-1.0);
+    AMREX_ALWAYS_ASSERT(amr.levelSteps(0) == step);
+
+    MultiFab const& phi0 = amr.getLevel(0).get_new_data(0);
+    MultiFab diff(phi.boxArray(), phi.DistributionMap(), phi.nComp(), 0);
+    diff.ParallelCopy(phi0, 0, 0, phi.nComp());
+    MultiFab::Subtract(diff, phi, 0, 0, phi.nComp(), 0);
+    const Real err = diff.norm0(0, phi.nComp(), IntVect(0));
+    amrex::Print() << "Restart from " << ckfile << ": max difference " << err << "\n";
+    AMREX_ALWAYS_ASSERT(err == 0.0);
+}
+
+}
+
+int
+main (int   argc,
+      char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int max_step = 4;
+        {
+            ParmParse pp;
+            pp.query("max_step",max_step);
+        }
+        std::string stage_dir;
+        int check_int = -1;
+        {
+            ParmParse pp("amr");
+            pp.get("checkpoint_stage_dir", stage_dir);
+            pp.get("check_int", check_int);
+        }
+        AMREX_ALWAYS_ASSERT(check_int > 0 && max_step % check_int == 0);
+
+        // The last checkpoint is written by coarseTimeStep(), then by the
+        // driver after the loop.
+        for (int nsteps : {max_step, max_step+1})
+        {
+            const std::string check_file = "chk" + std::to_string(nsteps) + "_";
+            MultiFab phi = run(nsteps, check_file);
+
+            int last = 0;
+            for (int step = check_int; step <= nsteps; step += check_int) {
+                check_checkpoint(amrex::Concatenate(check_file, step), stage_dir);
+                last = step;
+            }
+            if (last < nsteps) {
+                check_checkpoint(amrex::Concatenate(check_file, nsteps), stage_dir);
+            }
+
+            restart(amrex::Concatenate(check_file, nsteps), nsteps, phi);
+        }
+    }
+    amrex::Finalize();
+}
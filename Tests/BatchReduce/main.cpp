@@ -0,0 +1,129 @@
+#include <AMReX.H>
+#include <AMReX_BatchReduce.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+bool close (Real a, Real b)
+{
+    return std::abs(a-b) <= Real(1.e-12)*std::max(std::abs(a),std::abs(b));
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    MultiFab x(ba,dm,2,1), y(ba,dm,2,1);
+    for (MFIter mfi(x); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.fabbox();
+        auto const& xa = x.array(mfi);
+        auto const& ya = y.array(mfi);
+        amrex::ParallelFor(bx, 2, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            xa(i,j,k,n) = std::sin(0.1*i+n) + 0.01*j - 0.2*k;
+            ya(i,j,k,n) = std::cos(0.2*j) * (k+n) - 0.3;
+        });
+    }
+
+    const int myproc = ParallelDescriptor::MyProc();
+    const Real lsum = Real(1.5) + myproc;
+    const Real lmax = Real(0.25) * myproc;
+
+    // The results of separate reductions
+    const Real dot = MultiFab::Dot(x, 0, y, 0, 2, 1);
+    const Real nrm0 = x.norm0(0, 2, IntVect(0));
+    const Real nrm1 = x.norm1(0, 0) + x.norm1(1, 0);
+    const Real nrm2 = std::sqrt(MultiFab::Dot(y, 1, 1, 1));
+    Real sum = lsum, mx = lmax;
+    ParallelAllReduce::Sum(sum, ParallelContext::CommunicatorSub());
+    ParallelAllReduce::Max(mx, ParallelContext::CommunicatorSub());
+
+    auto check = [&] (BatchReduce const& br, int idot, int in0, int in1, int in2,
+                      int isum, int imax, std::string const& name)
+    {
+        amrex::Print() << name << ": dot " << br[idot] << " " << dot
+                       << ", norm0 " << br[in0] << " " << nrm0
+                       << ", norm1 " << br[in1] << " " << nrm1
+                       << ", norm2 " << br[in2] << " " << nrm2
+                       << ", sum " << br[isum] << " " << sum
+                       << ", max " << br[imax] << " " << mx << "\n";
+        AMREX_ALWAYS_ASSERT(close(br[idot],dot) && br[in0] == nrm0 &&
+                            close(br[in1],nrm1) && close(br[in2],nrm2) &&
+                            br[isum] == sum && br[imax] == mx);
+    };
+
+    BatchReduce br;
+    for (int async = 0; async < 2; ++async) {
+        br.clear();
+        int idot = br.addDot(x, 0, y, 0, 2, 1);
+        int in0 = br.addNorm0(x, 0, 2);
+        int in1 = br.addNorm1(x, 0, 2);
+        int in2 = br.addNorm2(y, 1, 1, 1);
+        int isum = br.addLocalSum(lsum);
+        int imax = br.addLocalMax(lmax);
+        if (async) {
+            br.computeAsync();
+            br.wait();
+        } else {
+            br.compute();
+        }
+        check(br, idot, in0, in1, in2, isum, imax, async ? "computeAsync" : "compute");
+    }
+
+#ifdef BL_USE_MPI
+    // A BatchReduce reduces over its own communicator, not over all the
+    // processes.  Split them in two halves.
+    if (ParallelDescriptor::NProcs() > 1) {
+        MPI_Comm comm;
+        const int nprocs = ParallelDescriptor::NProcs();
+        const int color = (myproc < nprocs/2) ? 0 : 1;
+        BL_MPI_REQUIRE( MPI_Comm_split(ParallelDescriptor::Communicator(), color,
+                                       myproc, &comm) );
+        Real hsum = lsum, hmax = lmax;
+        ParallelAllReduce::Sum(hsum, comm);
+        ParallelAllReduce::Max(hmax, comm);
+        for (int async = 0; async < 2; ++async) {
+            BatchReduce hbr(comm);
+            int isum = hbr.addLocalSum(lsum);
+            int imax = hbr.addLocalMax(lmax);
+            if (async) {
+                hbr.computeAsync();
+                hbr.wait();
+            } else {
+                hbr.compute();
+            }
+            AMREX_ALWAYS_ASSERT(hbr[isum] == hsum && hbr[imax] == hmax);
+        }
+        BL_MPI_REQUIRE( MPI_Comm_free(&comm) );
+        amrex::Print() << "sub-communicator reductions passed\n";
+    }
+#endif
+
+    amrex::Print() << "BatchReduce test passed\n";
+}
@@ -0,0 +1,174 @@
+//
+// Compares the classification of boxes as regular, covered or cut done by
+// GeometryShop with the Lipschitz bounds of the implicit functions, and by
+// STLtools with the boxes batched by the triangles near them, with the
+// classification of every node of the boxes.
+//
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EB_STL_utils.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <fstream>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// The boxes of domain chopped into boxes of each size, unshifted and
+// shifted by half the size.  Each process gets a share of them.
+Vector<Box> make_boxes (Box const& domain, Vector<int> const& sizes)
+{
+    Vector<Box> boxes;
+    for (int s : sizes) {
+        for (int shift : {0, s/2}) {
+            BoxArray ba(amrex::grow(domain, s));
+            ba.maxSize(s);
+            for (int i = 0; i < ba.size(); ++i) {
+                const Box b = amrex::shift(ba[i], IntVect(shift)) & domain;
+                if (b.ok()) { boxes.push_back(b); }
+            }
+        }
+    }
+    Vector<Box> my_boxes;
+    for (int i = ParallelDescriptor::MyProc(); i < boxes.size();
+         i += ParallelDescriptor::NProcs()) {
+        my_boxes.push_back(boxes[i]);
+    }
+    return my_boxes;
+}
+
+void check (std::string const& name, Long nbad, Long ncut, Long nboxes)
+{
+    ParallelDescriptor::ReduceLongSum(nbad);
+    ParallelDescriptor::ReduceLongSum(ncut);
+    ParallelDescriptor::ReduceLongSum(nboxes);
+    amrex::Print() << "  " << name << ": " << nboxes << " boxes, " << ncut
+                   << " cut, " << nbad << " misclassified\n";
+    AMREX_ALWAYS_ASSERT(nbad == 0);
+    AMREX_ALWAYS_ASSERT(ncut > 0 && ncut < nboxes);
+}
+
+template <class F>
+void check_if (std::string const& name, F const& f, Geometry const& geom,
+               Vector<Box> const& boxes)
+{
+    static_assert(EB2::HasLipschitz<F>::value, "the implicit function has no Lipschitz bound");
+    using Shop = EB2::GeometryShop<F>;
+    Shop gshop(f);
+    Long nbad = 0, ncut = 0;
+    for (Box const& bx : boxes) {
+        const int mask = gshop.getBoxMask_Cpu(bx, geom);
+        const int type = !(mask & Shop::has_body)  ? Shop::allregular
+                       : !(mask & Shop::has_fluid) ? Shop::allcovered : Shop::mixedcells;
+        if (gshop.getBoxType_Cpu(bx, geom) != type) { ++nbad; }
+        if (type == Shop::mixedcells) { ++ncut; }
+    }
+    check(name, nbad, ncut, boxes.size());
+}
+
+#if (AMREX_SPACEDIM == 3)
+void check_stl (Geometry const& geom, Vector<Box> const& boxes)
+{
+    // A tetrahedron with vertices p[0] to p[3].
+    const std::string fname = "tetrahedron.stl";
+    if (ParallelDescriptor::IOProcessor()) {
+        const Real p[4][3] = {{0.15,0.2,0.1}, {0.85,0.3,0.2}, {0.4,0.9,0.15}, {0.45,0.45,0.9}};
+        const int facets[4][3] = {{0,2,1}, {0,1,3}, {1,2,3}, {0,3,2}};
+        std::ofstream ofs(fname);
+        ofs << "solid tetrahedron\n";
+        for (auto const& t : facets) {
+            ofs << "facet normal 0 0 0\n" << "outer loop\n";
+            for (int v : t) {
+                ofs << "vertex " << p[v][0] << " " << p[v][1] << " " << p[v][2] << "\n";
+            }
+            ofs << "endloop\n" << "endfacet\n";
+        }
+        ofs << "endsolid tetrahedron\n";
+    }
+
+    STLtools stl;
+    stl.read_stl_file(fname, 1.0, {0.0, 0.0, 0.0}, 0);
+
+    Long nbad = 0, ncut = 0;
+    for (Box const& bx : boxes) {
+        const int mask = stl.getBoxMask_Eval(Vector<Box>{bx}, geom);
+        const int type = !(mask & STLtools::has_fluid) ? STLtools::allcovered
+                       : !(mask & STLtools::has_body)  ? STLtools::allregular
+                                                       : STLtools::mixedcells;
+        if (stl.getBoxType(bx, geom, RunOn::Gpu) != type) { ++nbad; }
+        if (type == STLtools::mixedcells) { ++ncut; }
+
+        // The nodes of pieces of bx evaluated in one batch.
+        BoxArray pieces(bx);
+        pieces.maxSize(4);
+        if (stl.getBoxMask_Eval(pieces.boxList().data(), geom) != mask) { ++nbad; }
+    }
+    check("stl", nbad, ncut, boxes.size());
+}
+#endif
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    Vector<int> box_sizes{3, 5, 8, 13, 21, 34};
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.queryarr("box_sizes", box_sizes);
+    }
+
+    Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                  RealBox(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.)),
+                  0, {AMREX_D_DECL(0,0,0)});
+    const Vector<Box> boxes = make_boxes(amrex::surroundingNodes(geom.Domain()), box_sizes);
+
+    EB2::SphereIF sphere(0.3, {AMREX_D_DECL(0.5,0.45,0.5)}, false);
+    EB2::BoxIF box({AMREX_D_DECL(0.21,0.33,0.27)}, {AMREX_D_DECL(0.68,0.74,0.81)}, true);
+    EB2::CylinderIF cylinder(0.25, 0.6, 1, {AMREX_D_DECL(0.48,0.5,0.52)}, true);
+    EB2::PlaneIF plane({AMREX_D_DECL(0.5,0.5,0.5)}, {AMREX_D_DECL(0.3,-1.0,0.6)});
+    EB2::EllipsoidIF ellipsoid({AMREX_D_DECL(0.35,0.2,0.25)}, {AMREX_D_DECL(0.5,0.55,0.45)}, true);
+
+    check_if("sphere", sphere, geom, boxes);
+    check_if("box", box, geom, boxes);
+    check_if("cylinder", cylinder, geom, boxes);
+    check_if("plane", plane, geom, boxes);
+    check_if("ellipsoid", ellipsoid, geom, boxes);
+    check_if("union", EB2::makeUnion(sphere, box), geom, boxes);
+    check_if("intersection", EB2::makeIntersection(cylinder, ellipsoid), geom, boxes);
+    check_if("difference", EB2::makeDifference(box, sphere), geom, boxes);
+    check_if("complement", EB2::makeComplement(ellipsoid), geom, boxes);
+    check_if("translation", EB2::translate(sphere, {AMREX_D_DECL(0.1,-0.05,0.02)}), geom, boxes);
+    check_if("scale", EB2::scale(ellipsoid, {AMREX_D_DECL(1.2,0.9,1.1)}), geom, boxes);
+    check_if("rotation", EB2::translate(EB2::rotate(EB2::translate(box, {AMREX_D_DECL(-0.5,-0.5,-0.5)}),
+                                                    0.4, AMREX_SPACEDIM-1),
+                                        {AMREX_D_DECL(0.5,0.5,0.5)}),
+             geom, boxes);
+
+#if (AMREX_SPACEDIM == 3)
+    EB2::TorusIF torus(0.3, 0.1, {0.5,0.5,0.5}, false);
+    check_if("torus", torus, geom, boxes);
+
+    // A circle in the plane z = 0, revolved as the profile (r,z) and extruded.
+    EB2::SphereIF circle(0.15, {0.3,0.5,0.0}, false);
+    check_if("lathe", EB2::translate(EB2::lathe(circle), {0.5,0.5,0.0}), geom, boxes);
+    check_if("extrusion", EB2::extrude(EB2::translate(circle, {0.2,0.0,0.0}), 2), geom, boxes);
+
+    check_stl(geom, boxes);
+#endif
+
+    amrex::Print() << "box classification test passed\n";
+}
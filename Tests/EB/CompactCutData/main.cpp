@@ -0,0 +1,197 @@
+//
+// Solves the same problem with MLEBABecLap on two EB factories, one with its
+// cut-cell data in compact storage (eb2.compact_cut_data = 1) and one switched
+// back to dense storage, and checks that the solutions and fluxes agree, that
+// the compact factory stays compact, and that it uses less memory.
+//
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MLEBABecLap.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+Long cut_data_bytes (EBFArrayBoxFactory const& factory)
+{
+    Long nbytes = factory.getCentroid().nBytes() + factory.getBndryCent().nBytes()
+        + factory.getBndryArea().nBytes() + factory.getBndryNormal().nBytes();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        nbytes += factory.getAreaFrac()[idim]->nBytes() + factory.getFaceCent()[idim]->nBytes()
+            + factory.getEdgeCent()[idim]->nBytes();
+    }
+    ParallelDescriptor::ReduceLongSum(nbytes);
+    return nbytes;
+}
+
+struct Solution
+{
+    MultiFab phi;
+    Array<MultiFab,AMREX_SPACEDIM> flux;
+    MultiFab ebflux;
+    int niters = 0;
+};
+
+// Solves alpha a phi - beta div(b grad phi) = rhs with phi = 0 on the
+// domain boundary and phi = 1 on the EB.
+Solution solve (EBFArrayBoxFactory const& factory, Geometry const& geom, bool beta_on_centroid)
+{
+    BoxArray const& ba = factory.boxArray();
+    DistributionMapping const& dm = factory.DistributionMap();
+
+    Solution s;
+    s.phi.define(ba, dm, 1, 1, MFInfo(), factory);
+    s.phi.setVal(0.0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        s.flux[idim].define(amrex::convert(ba,IntVect::TheDimensionVector(idim)), dm, 1, 0,
+                            MFInfo(), factory);
+    }
+    s.ebflux.define(ba, dm, 1, 0, MFInfo(), factory);
+
+    MultiFab rhs(ba, dm, 1, 0, MFInfo(), factory);
+    MultiFab acoef(ba, dm, 1, 0, MFInfo(), factory);
+    MultiFab phieb(ba, dm, 1, 0, MFInfo(), factory);
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bcoef[idim].define(amrex::convert(ba,IntVect::TheDimensionVector(idim)), dm, 1, 0,
+                           MFInfo(), factory);
+        bcoef[idim].setVal(1.0);
+    }
+    acoef.setVal(1.0);
+    phieb.setVal(1.0);
+
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+        Array4<Real> const& r = rhs.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            AMREX_D_TERM(Real x = problo[0] + (i+0.5)*dx[0];,
+                         Real y = problo[1] + (j+0.5)*dx[1];,
+                         Real z = problo[2] + (k+0.5)*dx[2]);
+            r(i,j,k) = AMREX_D_TERM(std::sin(6.0*x), *std::cos(4.0*y), *std::sin(2.0*z+0.3));
+        });
+    }
+
+    LPInfo info;
+    MLEBABecLap mleb({geom}, {ba}, {dm}, info, {&factory});
+    mleb.setMaxOrder(2);
+    mleb.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                   LinOpBCType::Dirichlet,
+                                   LinOpBCType::Dirichlet)},
+                     {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                   LinOpBCType::Dirichlet,
+                                   LinOpBCType::Dirichlet)});
+    mleb.setLevelBC(0, &s.phi);
+    mleb.setScalars(1.0, 1.0);
+    mleb.setACoeffs(0, acoef);
+    mleb.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef),
+                    beta_on_centroid ? MLLinOp::Location::FaceCentroid
+                                     : MLLinOp::Location::FaceCenter);
+    mleb.setEBDirichlet(0, phieb, 1.0);
+
+    MLMG mlmg(mleb);
+    mlmg.setMaxIter(100);
+    mlmg.solve({&s.phi}, {&rhs}, 1.e-10, 0.0);
+    s.niters = mlmg.getNumIters();
+
+    mlmg.getFluxes({amrex::GetArrOfPtrs(s.flux)}, MLLinOp::Location::FaceCentroid);
+    mlmg.getEBFluxes({&s.ebflux});
+
+    return s;
+}
+
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), 0);
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), 0);
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), 0);
+    return d.norm0();
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    bool compact = false;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        ParmParse ppeb2("eb2");
+        ppeb2.query("compact_cut_data", compact);
+    }
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(compact, "This test needs eb2.compact_cut_data = 1");
+
+    Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                  RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                  0, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(geom.Domain());
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    EB2::SphereIF sphere(0.3, {AMREX_D_DECL(0.5,0.48,0.52)}, false);
+    auto gshop = EB2::makeShop(sphere);
+    EB2::Build(gshop, geom, 0, 30);
+
+    // Two factories with data of their own.  One of them is switched to
+    // dense storage.
+    auto compact_factory = makeEBFabFactory(geom, ba, dm, {2,2,2}, EBSupport::full);
+    auto dense_factory = makeEBFabFactory(geom, ba, dm, {2,2,2}, EBSupport::full);
+    dense_factory->requireDenseCutData();
+    AMREX_ALWAYS_ASSERT(compact_factory->isCutDataCompact());
+    AMREX_ALWAYS_ASSERT(!dense_factory->isCutDataCompact());
+
+    compact_factory->printMemoryUsage();
+    dense_factory->printMemoryUsage();
+    const Long compact_bytes = cut_data_bytes(*compact_factory);
+    const Long dense_bytes = cut_data_bytes(*dense_factory);
+    amrex::Print() << "cut-cell data: " << compact_bytes << " bytes compact, "
+                   << dense_bytes << " bytes dense\n";
+    AMREX_ALWAYS_ASSERT(compact_bytes < dense_bytes);
+
+    for (bool beta_on_centroid : {false, true})
+    {
+        Solution c = solve(*compact_factory, geom, beta_on_centroid);
+        Solution d = solve(*dense_factory, geom, beta_on_centroid);
+
+        Real dphi = max_diff(c.phi, d.phi);
+        Real debflux = max_diff(c.ebflux, d.ebflux);
+        Real dflux = 0.0;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            dflux = std::max(dflux, max_diff(c.flux[idim], d.flux[idim]));
+        }
+        amrex::Print() << (beta_on_centroid ? "beta on face centroids" : "beta on face centers")
+                       << ": " << c.niters << " and " << d.niters << " iterations, max |phi| "
+                       << c.phi.norm0() << ", max differences: phi " << dphi
+                       << ", flux " << dflux << ", EB flux " << debflux << "\n";
+
+        // The compact data are the dense data without the default values,
+        // so the two solves do the same arithmetic.
+        AMREX_ALWAYS_ASSERT(c.niters == d.niters);
+        AMREX_ALWAYS_ASSERT(c.phi.norm0() > 0.1);
+        AMREX_ALWAYS_ASSERT(dphi == 0.0 && dflux == 0.0 && debflux == 0.0);
+    }
+
+    // Neither MLEBABecLap nor getFluxes switched the factory to dense storage.
+    AMREX_ALWAYS_ASSERT(compact_factory->isCutDataCompact());
+
+    amrex::Print() << "compact cut data test passed\n";
+}
@@ -0,0 +1,151 @@
+//
+// Compares the EB surface polygons built by EBToPVD with shared points
+// against the polygons that each have their own points: the polygons are
+// the same, and every point of a polygon is within the merge tolerance of
+// its own point.
+//
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBToPVD.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_WriteEBSurface.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+void make_polygons (EBToPVD& eb_to_pvd, EBFArrayBoxFactory const& factory, Geometry const& geom)
+{
+    auto const& flags = factory.getMultiEBCellFlagFab();
+    auto const& areafrac = factory.getAreaFrac();
+    auto const& bndrycent = factory.getBndryCent();
+    for (MFIter mfi(flags); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        const FabType t = flags[mfi].getType(bx);
+        if (t == FabType::covered || t == FabType::regular) { continue; }
+        FArrayBox bcscratch;
+        Array<FArrayBox,AMREX_SPACEDIM> apscratch;
+        eb_to_pvd.EBToPolygon(geom.ProbLo(), geom.CellSize(), bx, flags.const_array(mfi),
+                              bndrycent.const_array(mfi, bcscratch),
+                              areafrac[0]->const_array(mfi, apscratch[0]),
+                              areafrac[1]->const_array(mfi, apscratch[1]),
+                              areafrac[2]->const_array(mfi, apscratch[2]));
+    }
+}
+
+// Checks the shared points against the separate points of the polygons of
+// factory, and returns the numbers of separate and shared points.
+std::pair<Long,Long> check (std::string const& name, EBFArrayBoxFactory const& factory,
+                            Geometry const& geom, Real merge_tol)
+{
+    EBToPVD separate(-1.0), shared(merge_tol);
+    make_polygons(separate, factory, geom);
+    make_polygons(shared, factory, geom);
+
+    auto const& sp = separate.polygons();
+    auto const& hp = shared.polygons();
+    AMREX_ALWAYS_ASSERT(sp.size() == hp.size());
+
+    Long npoints_polygons = 0;
+    Real max_dist = 0.0;
+    for (std::size_t ip = 0; ip < sp.size(); ++ip) {
+        AMREX_ALWAYS_ASSERT(sp[ip][0] == hp[ip][0]);
+        npoints_polygons += sp[ip][0];
+        // The points may come in a different order if they moved.
+        for (int n = 1; n <= hp[ip][0]; ++n) {
+            auto const& q = shared.points()[hp[ip][n]];
+            Real dmin = std::numeric_limits<Real>::max();
+            for (int m = 1; m <= sp[ip][0]; ++m) {
+                auto const& p = separate.points()[sp[ip][m]];
+                dmin = std::min(dmin, std::max({std::abs(q[0]-p[0]), std::abs(q[1]-p[1]),
+                                                std::abs(q[2]-p[2])}));
+            }
+            max_dist = std::max(max_dist, dmin);
+        }
+    }
+
+    Long npolygons = sp.size();
+    Long npoints_separate = separate.points().size();
+    Long npoints_shared = shared.points().size();
+    ParallelDescriptor::ReduceLongSum(npolygons);
+    ParallelDescriptor::ReduceLongSum(npoints_polygons);
+    ParallelDescriptor::ReduceLongSum(npoints_separate);
+    ParallelDescriptor::ReduceLongSum(npoints_shared);
+    ParallelDescriptor::ReduceRealMax(max_dist);
+
+    amrex::Print() << name << ": " << npolygons << " polygons, " << npoints_separate
+                   << " points, " << npoints_shared << " shared points, max point distance "
+                   << max_dist << "\n";
+
+    AMREX_ALWAYS_ASSERT(npolygons > 0);
+    AMREX_ALWAYS_ASSERT(npoints_separate == npoints_polygons);
+    AMREX_ALWAYS_ASSERT(npoints_shared <= npoints_separate);
+    AMREX_ALWAYS_ASSERT(max_dist <= merge_tol*geom.CellSize(0));
+
+    return {npoints_separate, npoints_shared};
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 48;
+    int max_grid_size = 16;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                  RealBox({0.,0.,0.}, {1.,1.,1.}), 0, {0,0,0});
+    BoxArray ba(geom.Domain());
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    const Real merge_tol = 1.e-6;
+
+    // A tilted plane.  The cells on it have the same plane, so most of the
+    // points are shared.
+    {
+        EB2::PlaneIF plane({0.5,0.5,0.4}, {0.2,-0.3,-1.0}, false);
+        auto gshop = EB2::makeShop(plane);
+        EB2::Build(gshop, geom, 0, 0);
+        EBFArrayBoxFactory factory(EB2::IndexSpace::top().getLevel(geom), geom, ba, dm,
+                                   {1,1,1}, EBSupport::full);
+        auto np = check("plane", factory, geom, merge_tol);
+        AMREX_ALWAYS_ASSERT(2*np.second < np.first);
+
+        WriteEBSurface(ba, dm, geom, &factory);
+        if (ParallelDescriptor::IOProcessor()) {
+            AMREX_ALWAYS_ASSERT(FileSystem::Exists("eb.pvtp"));
+        }
+    }
+
+    // A sphere.  Each cell has its own plane, so the points of neighbors
+    // on a common edge differ and are mostly not shared.
+    {
+        EB2::SphereIF sphere(0.3, {0.5,0.5,0.5}, false);
+        auto gshop = EB2::makeShop(sphere);
+        EB2::Build(gshop, geom, 0, 0);
+        EBFArrayBoxFactory factory(EB2::IndexSpace::top().getLevel(geom), geom, ba, dm,
+                                   {1,1,1}, EBSupport::full);
+        check("sphere", factory, geom, merge_tol);
+    }
+
+    amrex::Print() << "EB surface test passed\n";
+}
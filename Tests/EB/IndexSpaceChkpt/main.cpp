@@ -0,0 +1,133 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF_Sphere.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Reduce.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// Number of cells whose flags differ, and the max difference in volfrac,
+// between two levels on the grids of the first one.
+void compare_level (EB2::Level const& lev0, EB2::Level const& lev1,
+                    Geometry const& geom, Long& nbad_flags, Real& vfrac_diff)
+{
+    const BoxArray& ba = lev0.boxArray();
+    const DistributionMapping& dm = lev0.DistributionMap();
+
+    FabArray<EBCellFlagFab> flag0(ba,dm,1,1), flag1(ba,dm,1,1);
+    lev0.fillEBCellFlag(flag0, geom);
+    lev1.fillEBCellFlag(flag1, geom);
+
+    MultiFab vfrac0(ba,dm,1,1), vfrac1(ba,dm,1,1);
+    lev0.fillVolFrac(vfrac0, geom);
+    lev1.fillVolFrac(vfrac1, geom);
+
+    ReduceOps<ReduceOpSum,ReduceOpMax> reduce_op;
+    ReduceData<Long,Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+
+    for (MFIter mfi(vfrac0); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.fabbox();
+        auto const& f0 = flag0.const_array(mfi);
+        auto const& f1 = flag1.const_array(mfi);
+        auto const& v0 = vfrac0.const_array(mfi);
+        auto const& v1 = vfrac1.const_array(mfi);
+        reduce_op.eval(bx, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+        {
+            Long bad = (f0(i,j,k) != f1(i,j,k)) ? 1 : 0;
+            return {bad, std::abs(v0(i,j,k)-v1(i,j,k))};
+        });
+    }
+
+    ReduceTuple hv = reduce_data.value(reduce_op);
+    nbad_flags = amrex::get<0>(hv);
+    vfrac_diff = amrex::get<1>(hv);
+    ParallelDescriptor::ReduceLongSum(nbad_flags);
+    ParallelDescriptor::ReduceRealMax(vfrac_diff);
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_coarsening_level = 3;
+    Real radius = 0.3;
+    Vector<Real> center(AMREX_SPACEDIM, 0.5);
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_coarsening_level", max_coarsening_level);
+    }
+    {
+        ParmParse pp("sphere");
+        pp.query("radius", radius);
+        pp.queryarr("center", center);
+    }
+
+    Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                  RealBox(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.)),
+                  0, {AMREX_D_DECL(0,0,0)});
+
+    EB2::SphereIF sphere(radius, {AMREX_D_DECL(center[0],center[1],center[2])}, false);
+    auto gshop = EB2::makeShop(sphere);
+    EB2::Build(gshop, geom, 0, max_coarsening_level);
+
+    EB2::IndexSpace const* built = &EB2::IndexSpace::top();
+
+    const std::string dirname = "eb_chkpt";
+    const std::string key = "sphere";
+    built->writeChkptFile(dirname, key);
+
+    // A different key or different arguments must not match.
+    AMREX_ALWAYS_ASSERT(!EB2::BuildFromChkptFile(dirname, "cylinder", geom,
+                                                 0, max_coarsening_level));
+    AMREX_ALWAYS_ASSERT(!EB2::BuildFromChkptFile(dirname, key, geom,
+                                                 0, max_coarsening_level-1));
+    AMREX_ALWAYS_ASSERT(EB2::IndexSpace::size() == 1);
+
+    AMREX_ALWAYS_ASSERT(EB2::BuildFromChkptFile(dirname, key, geom,
+                                                0, max_coarsening_level));
+    AMREX_ALWAYS_ASSERT(EB2::IndexSpace::size() == 2);
+
+    EB2::IndexSpace const* restarted = &EB2::IndexSpace::top();
+    AMREX_ALWAYS_ASSERT(restarted != built);
+    AMREX_ALWAYS_ASSERT(restarted->numLevels() == built->numLevels());
+
+    for (int ilev = 0; ilev < built->numLevels(); ++ilev)
+    {
+        EB2::Level const& lev0 = built->getLevel(ilev);
+        EB2::Level const& lev1 = restarted->getLevel(ilev);
+        AMREX_ALWAYS_ASSERT(lev0.isAllRegular() == lev1.isAllRegular());
+        AMREX_ALWAYS_ASSERT(lev0.isOK() == lev1.isOK());
+        // The coarse levels built by coarsening keep the fine boxes with a
+        // coarsening ratio, so compare the boxes themselves.
+        AMREX_ALWAYS_ASSERT(lev0.boxArray().boxList() == lev1.boxArray().boxList());
+        AMREX_ALWAYS_ASSERT(lev0.Geom().Domain() == lev1.Geom().Domain());
+
+        Long nbad_flags;
+        Real vfrac_diff;
+        compare_level(lev0, lev1, lev0.Geom(), nbad_flags, vfrac_diff);
+        amrex::Print() << "  level " << ilev << ": " << lev0.boxArray().size()
+                       << " grids, " << nbad_flags << " mismatched flags,"
+                       << " max volfrac difference " << vfrac_diff << "\n";
+        AMREX_ALWAYS_ASSERT(nbad_flags == 0);
+        AMREX_ALWAYS_ASSERT(vfrac_diff == 0.0);
+    }
+
+    amrex::Print() << "IndexSpace checkpoint round trip passed\n";
+}
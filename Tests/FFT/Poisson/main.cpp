@@ -0,0 +1,116 @@
+#include <AMReX.H>
+#include <AMReX_FFT_Poisson.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+void main_main ()
+{
+    Vector<int> n_cell{AMREX_D_DECL(64,48,40)};
+    int max_grid_size = 16;
+    {
+        ParmParse pp;
+        pp.queryarr("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    Box domain(IntVect(0), IntVect(AMREX_D_DECL(n_cell[0]-1,n_cell[1]-1,n_cell[2]-1)));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.5,1.25)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    MultiFab rhs(ba,dm,1,0), soln(ba,dm,1,1), mlmg_soln(ba,dm,1,1);
+
+    auto const dx = geom.CellSizeArray();
+    auto const prob_lo = geom.ProbLoArray();
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        auto const& a = rhs.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            AMREX_D_TERM(Real x = prob_lo[0] + (i+0.5)*dx[0];,
+                         Real y = prob_lo[1] + (j+0.5)*dx[1];,
+                         Real z = prob_lo[2] + (k+0.5)*dx[2];)
+            Real r2 = AMREX_D_TERM((x-0.3)*(x-0.3), + (y-0.7)*(y-0.7), + (z-0.5)*(z-0.5));
+            a(i,j,k) = std::exp(-50.*r2) + std::sin(6.2831853071795865*x)
+                AMREX_D_TERM(, *std::cos(8.3775804095727820*y), *std::sin(5.0265482457436692*z));
+        });
+    }
+    rhs.plus(-rhs.sum()/static_cast<Real>(domain.d_numPts()), 0, 1);
+
+    // Lap soln = rhs with FFT and with MLMG
+    soln.setVal(0.0);
+    FFT::Poisson fft_poisson(geom);
+    ParallelDescriptor::Barrier();
+    Real t0 = amrex::second();
+    fft_poisson.solve(soln, rhs);
+    ParallelDescriptor::Barrier();
+    Real t_fft = amrex::second() - t0;
+
+    mlmg_soln.setVal(0.0);
+    MLPoisson mlpoisson({geom}, {ba}, {dm});
+    mlpoisson.setDomainBC({AMREX_D_DECL(LinOpBCType::Periodic,
+                                        LinOpBCType::Periodic,
+                                        LinOpBCType::Periodic)},
+                          {AMREX_D_DECL(LinOpBCType::Periodic,
+                                        LinOpBCType::Periodic,
+                                        LinOpBCType::Periodic)});
+    mlpoisson.setLevelBC(0, nullptr);
+    MLMG mlmg(mlpoisson);
+    mlmg.setVerbose(0);
+    ParallelDescriptor::Barrier();
+    t0 = amrex::second();
+    mlmg.solve({&mlmg_soln}, {&rhs}, 1.e-12, 0.0);
+    ParallelDescriptor::Barrier();
+    Real t_mlmg = amrex::second() - t0;
+    mlmg_soln.plus(-mlmg_soln.sum()/static_cast<Real>(domain.d_numPts()), 0, 1);
+
+    MultiFab::Subtract(mlmg_soln, soln, 0, 0, 1, 0);
+    const Real diff = mlmg_soln.norminf();
+    const Real nrm = soln.norminf();
+    amrex::Print() << "Poisson: max |soln| " << nrm << ", max difference from MLMG " << diff
+                   << "\n         FFT " << t_fft << " s, MLMG " << t_mlmg << " s\n";
+    AMREX_ALWAYS_ASSERT(diff <= 1.e-9*nrm);
+
+    // (2 - 0.5 Lap) soln = rhs, checked with the residual
+    const Real a = 2.0, b = 0.5;
+    fft_poisson.setScalars(a, b);
+    fft_poisson.solve(soln, rhs);
+
+    MultiFab resid(ba,dm,1,0);
+    auto const dxinv = geom.InvCellSizeArray();
+    for (MFIter mfi(resid); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        auto const& r = resid.array(mfi);
+        auto const& s = soln.const_array(mfi);
+        auto const& f = rhs.const_array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            Real lap = AMREX_D_TERM(
+                (s(i-1,j,k) - 2.*s(i,j,k) + s(i+1,j,k)) * (dxinv[0]*dxinv[0]),
+              + (s(i,j-1,k) - 2.*s(i,j,k) + s(i,j+1,k)) * (dxinv[1]*dxinv[1]),
+              + (s(i,j,k-1) - 2.*s(i,j,k) + s(i,j,k+1)) * (dxinv[2]*dxinv[2]));
+            r(i,j,k) = f(i,j,k) - (a*s(i,j,k) - b*lap);
+        });
+    }
+    const Real resnorm = resid.norminf();
+    amrex::Print() << "Helmholtz: max residual " << resnorm << "\n";
+    AMREX_ALWAYS_ASSERT(resnorm <= 1.e-10*rhs.norminf());
+}
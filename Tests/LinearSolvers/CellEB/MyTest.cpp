@@ -71,18 +71,91 @@ MyTest::solve ()
         }
     }
 
-    MLMG mlmg(mleb);
-    mlmg.setMaxIter(max_iter);
-    mlmg.setMaxFmgIter(max_fmg_iter);
-    mlmg.setBottomMaxIter(max_bottom_iter);
-    mlmg.setBottomTolerance(bottom_reltol);
-    mlmg.setVerbose(verbose);
-    mlmg.setBottomVerbose(bottom_verbose);
-    if (use_hypre) mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
-    if (use_petsc) mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
-    const Real tol_rel = reltol;
-    const Real tol_abs = 0.0;
-    mlmg.solve(amrex::GetVecOfPtrs(phi), amrex::GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
+    Vector<MLMG::BottomSolver> bottom_solvers{MLMG::BottomSolver::Default};
+    if (use_hypre) bottom_solvers[0] = MLMG::BottomSolver::hypre;
+    if (use_petsc) bottom_solvers[0] = MLMG::BottomSolver::petsc;
+    if (use_aggregation) bottom_solvers[0] = MLMG::BottomSolver::aggregation;
+    if (compare_bottom_solvers) {
+        bottom_solvers = {MLMG::BottomSolver::bicgstab, MLMG::BottomSolver::aggregation};
+    }
+
+    // phi holds the boundary values in its ghost cells.
+    Vector<MultiFab> phi_init(max_level+1);
+    for (int ilev = 0; ilev <= max_level; ++ilev) {
+        phi_init[ilev].define(grids[ilev], dmap[ilev], 1, 1, MFInfo(), *factory[ilev]);
+        MultiFab::Copy(phi_init[ilev], phi[ilev], 0, 0, 1, 1);
+    }
+
+    // The first solve of a comparison, which the others must match.
+    Vector<MultiFab> phi_ref;
+    int ref_iters = 0, ref_bottom_iters = 0;
+
+    for (auto bottom_solver : bottom_solvers)
+    {
+        for (int ilev = 0; ilev <= max_level; ++ilev) {
+            MultiFab::Copy(phi[ilev], phi_init[ilev], 0, 0, 1, 1);
+        }
+
+        MLMG mlmg(mleb);
+        mlmg.setMaxIter(max_iter);
+        mlmg.setMaxFmgIter(max_fmg_iter);
+        mlmg.setBottomMaxIter(max_bottom_iter);
+        mlmg.setBottomTolerance(bottom_reltol);
+        mlmg.setVerbose(verbose);
+        mlmg.setBottomVerbose(bottom_verbose);
+        mlmg.setBottomSolver(bottom_solver);
+        const Real tol_rel = reltol;
+        const Real tol_abs = 0.0;
+        const Real t0 = amrex::second();
+        mlmg.solve(amrex::GetVecOfPtrs(phi), amrex::GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
+        const Real solve_time = amrex::second() - t0;
+
+        const auto& niters = mlmg.getNumCGIters();
+        int total_bottom_iters = 0;
+        for (int n : niters) { total_bottom_iters += n; }
+        // The bottom solve may run on fewer ranks.
+        ParallelDescriptor::ReduceIntMax(total_bottom_iters);
+        std::string name = "bicgstab";
+        if (bottom_solver == MLMG::BottomSolver::hypre) name = "hypre";
+        if (bottom_solver == MLMG::BottomSolver::petsc) name = "petsc";
+        if (bottom_solver == MLMG::BottomSolver::aggregation) name = "aggregation";
+        amrex::Print() << "Bottom solver " << name << ": " << niters.size() << " bottom solves, "
+                       << total_bottom_iters << " bottom iterations, solve time "
+                       << solve_time << " s" << std::endl;
+
+        if (compare_bottom_solvers)
+        {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                mlmg.getFinalResidual() <= tol_rel*mlmg.getInitResidual(),
+                "MLMG did not converge");
+            if (phi_ref.empty()) {
+                phi_ref.resize(max_level+1);
+                for (int ilev = 0; ilev <= max_level; ++ilev) {
+                    phi_ref[ilev].define(grids[ilev], dmap[ilev], 1, 0, MFInfo(), *factory[ilev]);
+                    MultiFab::Copy(phi_ref[ilev], phi[ilev], 0, 0, 1, 0);
+                }
+                ref_iters = mlmg.getNumIters();
+                ref_bottom_iters = total_bottom_iters;
+            } else {
+                // The bottom solvers solve to the same tolerance, so the
+                // MLMG iterations and the solutions are the same but for
+                // roundoff.  Aggregation is a better preconditioner, so it
+                // takes fewer bottom iterations.
+                for (int ilev = 0; ilev <= max_level; ++ilev) {
+                    MultiFab diff(grids[ilev], dmap[ilev], 1, 0, MFInfo(), *factory[ilev]);
+                    MultiFab::Copy(diff, phi[ilev], 0, 0, 1, 0);
+                    MultiFab::Subtract(diff, phi_ref[ilev], 0, 0, 1, 0);
+                    const Real err = diff.norm0();
+                    const Real phimax = phi_ref[ilev].norm0();
+                    amrex::Print() << "  level " << ilev << ": max |phi - phi_bicgstab| = "
+                                   << err << ", max |phi| = " << phimax << std::endl;
+                    AMREX_ALWAYS_ASSERT(err <= 1.e-9*phimax);
+                }
+                AMREX_ALWAYS_ASSERT(mlmg.getNumIters() <= ref_iters);
+                AMREX_ALWAYS_ASSERT(total_bottom_iters < ref_bottom_iters);
+            }
+        }
+    }
 }
 
 void
@@ -134,6 +207,8 @@ MyTest::readParameters ()
     pp.query("reltol", reltol);
     pp.query("linop_maxorder", linop_maxorder);
     pp.query("max_coarsening_level", max_coarsening_level);
+    pp.query("use_aggregation", use_aggregation);
+    pp.query("compare_bottom_solvers", compare_bottom_solvers);
 #ifdef AMREX_USE_HYPRE
     pp.query("use_hypre", use_hypre);
 #endif
@@ -26,39 +26,86 @@ MyTest::solve ()
 
     if (composite_solve)
     {
-        MLNodeLaplacian linop(geom, grids, dmap, info);
-        //linop.setSmoothNumSweeps(smooth_num_sweeps);
-
-        linop.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
-                                        LinOpBCType::Dirichlet,
-                                        LinOpBCType::Dirichlet)},
-                          {AMREX_D_DECL(LinOpBCType::Dirichlet,
-                                        LinOpBCType::Dirichlet,
-                                        LinOpBCType::Dirichlet)});
-
-        for (int ilev = 0; ilev <= max_level; ++ilev) {
-            linop.setSigma(ilev, sigma[ilev]);
-        }
+        // Compare the on-the-fly stencil with the assembled stencil.
+        Vector<int> stencil_modes{assembled_stencil};
+        if (compare_stencil) stencil_modes = {0, 1};
 
-        MLMG mlmg(linop);
-        mlmg.setMaxIter(max_iter);
-        mlmg.setMaxFmgIter(max_fmg_iter);
-        mlmg.setVerbose(verbose);
-        mlmg.setBottomVerbose(bottom_verbose);
-        // solution is passed to MLMG::solve to provide an initial guess.
-        // Additionally it also provides boundary conditions for Dirichlet
-        // boundaries if there are any.
-        for (int ilev = 0; ilev <= max_level; ++ilev) {
-            MultiFab::Copy(solution[ilev], exact_solution[ilev], 0, 0, 1, 0);
-            const Box& interior = amrex::surroundingNodes(
-                amrex::grow(geom[ilev].Domain(), -1));
-            // Usually we want the best initial guess.  For testing here,
-            // we set the domain boundaries to exact solution and zero out
-            // the interior.
-            solution[ilev].setVal(0.0, interior, 0, 1, 0);
-        }
+        for (int mode : stencil_modes)
+        {
+            MLNodeLaplacian linop(geom, grids, dmap, info);
+            //linop.setSmoothNumSweeps(smooth_num_sweeps);
+            linop.setHarmonicAverage(harmonic_average);
+            linop.setAssembledStencil(mode);
+
+            linop.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                            LinOpBCType::Dirichlet,
+                                            LinOpBCType::Dirichlet)},
+                              {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                            LinOpBCType::Dirichlet,
+                                            LinOpBCType::Dirichlet)});
+
+            for (int ilev = 0; ilev <= max_level; ++ilev) {
+                linop.setSigma(ilev, sigma[ilev]);
+            }
 
-        mlmg.solve(GetVecOfPtrs(solution), GetVecOfConstPtrs(rhs), reltol, 0.0);
+            MLMG mlmg(linop);
+            mlmg.setMaxIter(max_iter);
+            mlmg.setMaxFmgIter(max_fmg_iter);
+            mlmg.setVerbose(verbose);
+            mlmg.setBottomVerbose(bottom_verbose);
+            // solution is passed to MLMG::solve to provide an initial guess.
+            // Additionally it also provides boundary conditions for Dirichlet
+            // boundaries if there are any.
+            for (int ilev = 0; ilev <= max_level; ++ilev) {
+                MultiFab::Copy(solution[ilev], exact_solution[ilev], 0, 0, 1, 0);
+                const Box& interior = amrex::surroundingNodes(
+                    amrex::grow(geom[ilev].Domain(), -1));
+                // Usually we want the best initial guess.  For testing here,
+                // we set the domain boundaries to exact solution and zero out
+                // the interior.
+                solution[ilev].setVal(0.0, interior, 0, 1, 0);
+            }
+
+            const Real t0 = amrex::second();
+            mlmg.solve(GetVecOfPtrs(solution), GetVecOfConstPtrs(rhs), reltol, 0.0);
+            const Real solve_time = amrex::second() - t0;
+
+            if (compare_stencil) {
+                amrex::Print() << (mode ? "Assembled" : "On-the-fly") << " stencil: "
+                               << mlmg.getNumIters() << " iterations, solve time "
+                               << solve_time << " s" << std::endl;
+            }
+
+            if (reset_sigma)
+            {
+                // Doubling sigma and rhs with the same MLMG must give the
+                // same solution.
+                Vector<MultiFab> sigma2(max_level+1), rhs2(max_level+1), sol2(max_level+1);
+                for (int ilev = 0; ilev <= max_level; ++ilev) {
+                    sigma2[ilev].define(sigma[ilev].boxArray(), dmap[ilev], 1, 0);
+                    MultiFab::Copy(sigma2[ilev], sigma[ilev], 0, 0, 1, 0);
+                    sigma2[ilev].mult(2.0);
+                    linop.setSigma(ilev, sigma2[ilev]);
+                    rhs2[ilev].define(rhs[ilev].boxArray(), dmap[ilev], 1, rhs[ilev].nGrow());
+                    MultiFab::Copy(rhs2[ilev], rhs[ilev], 0, 0, 1, rhs[ilev].nGrow());
+                    rhs2[ilev].mult(2.0);
+                    sol2[ilev].define(solution[ilev].boxArray(), dmap[ilev], 1, 1);
+                    MultiFab::Copy(sol2[ilev], exact_solution[ilev], 0, 0, 1, 0);
+                    const Box& interior = amrex::surroundingNodes(
+                        amrex::grow(geom[ilev].Domain(), -1));
+                    sol2[ilev].setVal(0.0, interior, 0, 1, 0);
+                }
+                mlmg.solve(GetVecOfPtrs(sol2), GetVecOfConstPtrs(rhs2), reltol, 0.0);
+                for (int ilev = 0; ilev <= max_level; ++ilev) {
+                    MultiFab::Subtract(sol2[ilev], solution[ilev], 0, 0, 1, 0);
+                    const Real diff = sol2[ilev].norm0();
+                    const Real snorm = solution[ilev].norm0();
+                    amrex::Print() << "Level " << ilev << ": solution with doubled sigma and rhs"
+                                   << " differs by " << diff << std::endl;
+                    AMREX_ALWAYS_ASSERT(diff <= 1.e-8*snorm);
+                }
+            }
+        }
     }
     else // solve level by level
     {
@@ -160,6 +207,10 @@ MyTest::readParameters ()
     pp.query("max_coarsening_level", max_coarsening_level);
     pp.query("max_semicoarsening_level", max_semicoarsening_level);
     //pp.query("smooth_num_sweeps", smooth_num_sweeps);
+    pp.query("harmonic_average", harmonic_average);
+    pp.query("assembled_stencil", assembled_stencil);
+    pp.query("compare_stencil", compare_stencil);
+    pp.query("reset_sigma", reset_sigma);
 
     pp.query("do_plots", do_plots);
     pp.query("num_trials", num_trials);
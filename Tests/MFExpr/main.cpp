@@ -0,0 +1,121 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MFExpr.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+void main_main ()
+{
+    int n_cell = 128;
+    int max_grid_size = 32;
+    int nreps = 5;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nreps", nreps);
+    }
+
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    MultiFab a(ba,dm,1,0), b(ba,dm,1,0), c(ba,dm,1,0), d(ba,dm,1,0),
+        e(ba,dm,1,0), f(ba,dm,1,0), t(ba,dm,1,0), a0(ba,dm,1,0);
+
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        auto const& ba4 = b.array(mfi);
+        auto const& ca4 = c.array(mfi);
+        auto const& da4 = d.array(mfi);
+        auto const& ea4 = e.array(mfi);
+        auto const& fa4 = f.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            ba4(i,j,k) = std::sin(0.1*i) + j;
+            ca4(i,j,k) = std::cos(0.2*j) - k;
+            da4(i,j,k) = 0.5 + 0.01*i*k;
+            ea4(i,j,k) = std::sin(0.3*k) * i;
+            fa4(i,j,k) = 2.0 + std::cos(0.1*(i+j+k));
+        });
+    }
+
+    using namespace amrex::MFExpr;
+
+    // a = b + c*d - e/f
+    auto separate = [&] () {
+        MultiFab::Copy(a0, b, 0, 0, 1, 0);
+        MultiFab::AddProduct(a0, c, 0, d, 0, 0, 1, 0);
+        MultiFab::Copy(t, e, 0, 0, 1, 0);
+        MultiFab::Divide(t, f, 0, 0, 1, 0);
+        MultiFab::Subtract(a0, t, 0, 0, 1, 0);
+    };
+    auto fused = [&] () {
+        assign(a, 0, 1, comp(b) + comp(c)*comp(d) - comp(e)/comp(f));
+    };
+
+    separate();
+    fused();
+    const Real anrm = a.norminf();
+    MultiFab::Subtract(a0, a, 0, 0, 1, 0);
+    const Real diff = a0.norminf();
+    amrex::Print() << "a = b + c*d - e/f: max difference " << diff << "\n";
+    AMREX_ALWAYS_ASSERT(diff <= 1.e-12*anrm);
+
+    const Real dot0 = MultiFab::Dot(b, 0, c, 0, 1, 0);
+    const Real dot1 = Sum(comp(b)*comp(c));
+    const Real nrm0 = f.norminf();
+    const Real nrm1 = Max(abs(comp(f)));
+    const Real min0 = e.min(0);
+    const Real min1 = Min(comp(e));
+    amrex::Print() << "dot " << dot0 << " " << dot1
+                   << ", norminf " << nrm0 << " " << nrm1
+                   << ", min " << min0 << " " << min1 << "\n";
+    AMREX_ALWAYS_ASSERT(std::abs(dot1-dot0) <= 1.e-12*std::abs(dot0));
+    AMREX_ALWAYS_ASSERT(nrm0 == nrm1 && min0 == min1);
+
+    // a = b - 2*c and the sum of its squares in one pass
+    const Real rr = assignReduce<ReduceOpSum>(a, 0, 1, comp(b) - 2.0*comp(c),
+                                              [=] AMREX_GPU_DEVICE (Real v) { return v*v; });
+    MultiFab::LinComb(a0, 1.0, b, 0, -2.0, c, 0, 0, 1, 0);
+    const Real rr0 = MultiFab::Dot(a0, 0, 1, 0);
+    const Real a0nrm = a0.norminf();
+    MultiFab::Subtract(a0, a, 0, 0, 1, 0);
+    const Real rdiff = a0.norminf();
+    amrex::Print() << "assignReduce: " << rr << " " << rr0
+                   << ", max difference " << rdiff << "\n";
+    AMREX_ALWAYS_ASSERT(std::abs(rr-rr0) <= 1.e-12*rr0 && rdiff <= 1.e-12*a0nrm);
+
+    // the expression may refer to the destination
+    MultiFab::Copy(a0, a, 0, 0, 1, 0);
+    assign(a, 0, 1, 2.0 - comp(a));
+    MultiFab::Add(a0, a, 0, 0, 1, 0);
+    AMREX_ALWAYS_ASSERT(std::abs(a0.min(0)-2.0) <= 1.e-10 && std::abs(a0.max(0)-2.0) <= 1.e-10);
+
+    Real t_separate = 0.0, t_fused = 0.0;
+    for (int irep = 0; irep < nreps; ++irep) {
+        ParallelDescriptor::Barrier();
+        Real t0 = amrex::second();
+        separate();
+        ParallelDescriptor::Barrier();
+        Real t1 = amrex::second();
+        fused();
+        ParallelDescriptor::Barrier();
+        Real t2 = amrex::second();
+        t_separate += t1-t0;
+        t_fused += t2-t1;
+    }
+    amrex::Print() << "a = b + c*d - e/f: separate operations " << t_separate/nreps
+                   << " s, fused expression " << t_fused/nreps << " s\n";
+}
@@ -0,0 +1,228 @@
+//
+// Checks amrex::CRC32, and the checksums written with vismf.checksums = 1
+// in MultiFab and particle headers: the data read back match what was
+// written, and a corrupted byte in a data file is caught.
+//
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleReduce.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <fstream>
+#include <sstream>
+
+using namespace amrex;
+
+using MyParticleContainer = ParticleContainer<AMREX_SPACEDIM+1, 1, 1, 1>;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+void test_crc32 ()
+{
+    const std::string check("123456789");
+    AMREX_ALWAYS_ASSERT(amrex::CRC32(check.data(), check.size()) == 0xCBF43926u);
+    AMREX_ALWAYS_ASSERT(amrex::CRC32(check.data(), 0) == 0u);
+
+    // Checksumming in pieces of any size and alignment gives the same result.
+    Vector<char> buf(1000);
+    for (int i = 0; i < buf.size(); ++i) {
+        buf[i] = static_cast<char>((i*7919) % 251);
+    }
+    const std::uint32_t crc = amrex::CRC32(buf.dataPtr(), buf.size());
+    for (int n : {1, 3, 8, 13, 64, 999}) {
+        std::uint32_t crc_pieces = 0;
+        for (int i = 0; i < buf.size(); i += n) {
+            crc_pieces = amrex::CRC32(buf.dataPtr()+i, std::min(Long(n), buf.size()-i), crc_pieces);
+        }
+        AMREX_ALWAYS_ASSERT(crc_pieces == crc);
+    }
+    amrex::Print() << "CRC32 passed\n";
+}
+
+// Flip one byte of a file, counting from the end if offset is negative.
+void corrupt (std::string const& file, Long offset)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        std::fstream fs(file, std::ios::in | std::ios::out | std::ios::binary);
+        AMREX_ALWAYS_ASSERT(fs.good());
+        fs.seekg(offset, offset < 0 ? std::ios::end : std::ios::beg);
+        const auto pos = fs.tellg();
+        char c;
+        fs.read(&c, 1);
+        c = ~c;
+        fs.seekp(pos);
+        fs.write(&c, 1);
+        AMREX_ALWAYS_ASSERT(fs.good());
+    }
+    ParallelDescriptor::Barrier();
+}
+
+// The number of grids of the particle checkpoint dir whose data do not
+// match the checksums in its header.
+Long count_bad_grids (std::string const& dir)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(dir + "/Header", buf);
+    const std::string header(buf.dataPtr());
+    std::istringstream is(header);
+
+    std::string version, name;
+    int dm, nr, ni, finest_level;
+    bool checkpoint;
+    Long nparticles, maxnextid;
+    is >> version >> dm >> nr;
+    for (int i = 0; i < nr; ++i) { is >> name; }
+    is >> ni;
+    for (int i = 0; i < ni; ++i) { is >> name; }
+    is >> checkpoint >> nparticles >> maxnextid >> finest_level;
+
+    Vector<int> ngrids(finest_level+1);
+    for (auto& n : ngrids) { is >> n; }
+
+    Vector<Vector<Long>> checksum;
+    particle_detail::readChecksums(header, ngrids, checksum);
+    AMREX_ALWAYS_ASSERT(!checksum.empty());
+
+    Long nbad = 0;
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        for (int grid = 0; grid < ngrids[lev]; ++grid) {
+            int which, count;
+            Long where;
+            is >> which >> count >> where;
+            if (count <= 0) { continue; }
+            std::ifstream ifs(amrex::Concatenate(dir + "/Level_" + std::to_string(lev) + "/DATA_",
+                                                 which, 5), std::ios::in | std::ios::binary);
+            ifs.seekg(where, std::ios::beg);
+            Vector<char> data(checksum[lev][2*grid+1]);
+            ifs.read(data.dataPtr(), data.size());
+            if (!ifs.good() || amrex::CRC32(data.dataPtr(), data.size()) != checksum[lev][2*grid]) {
+                ++nbad;
+            }
+        }
+    }
+    return nbad;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    Long nparticles = 20000;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nparticles", nparticles);
+    }
+    AMREX_ALWAYS_ASSERT(VisMF::GetChecksums() && VisMF::GetVerifyChecksums());
+
+    test_crc32();
+
+    const Box domain(IntVect(0), IntVect(n_cell-1));
+    const RealBox real_box({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Geometry geom(domain, real_box, CoordSys::cartesian, {AMREX_D_DECL(1,1,1)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    // MultiFab
+    {
+        MultiFab mf(ba, dm, 2, 1);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            auto const& a = mf.array(mfi);
+            amrex::ParallelFor(mfi.fabbox(), 2, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                a(i,j,k,n) = std::sin(0.3*i) + 0.1*j*(n+1) - 0.7*k;
+            });
+        }
+        VisMF::Write(mf, "mf_chk");
+        AMREX_ALWAYS_ASSERT(VisMF::VerifyChecksums("mf_chk") == 0);
+
+        MultiFab mf2;
+        VisMF::Read(mf2, "mf_chk");
+        MultiFab::Subtract(mf2, mf, 0, 0, 2, 1);
+        AMREX_ALWAYS_ASSERT(mf2.norm0(0, 2, IntVect(1)) == 0.0);
+
+        VisMF::Header hdr;
+        {
+            Vector<char> buf;
+            ParallelDescriptor::ReadAndBcastFile("mf_chk_H", buf);
+            std::istringstream is(std::string(buf.dataPtr()));
+            is >> hdr;
+        }
+        // The last byte of a data file is data of its last FAB.
+        const std::string file = VisMF::DirName("mf_chk") + hdr.m_fod[0].m_name;
+        corrupt(file, -1);
+        AMREX_ALWAYS_ASSERT(VisMF::VerifyChecksums("mf_chk") == 1);
+        amrex::Print() << "MultiFab checksums passed\n";
+    }
+
+    // Particles
+    {
+        MyParticleContainer pc(geom, dm, ba);
+        MyParticleContainer::ParticleInitData pdata = {{AMREX_D_DECL(1.0, 2.0, 3.0), 4.0},
+                                                       {5}, {6.0}, {7}};
+        pc.InitRandom(nparticles, 451, pdata, false);
+        {
+            const int nlocal = static_cast<int>(pc.TotalNumberOfParticles(true, true));
+            int ip = 0;
+            for (MyParticleContainer::ParIterType pti(pc, 0); pti.isValid(); ++pti) {
+                auto& aos = pti.GetArrayOfStructs();
+                auto& soa = pti.GetStructOfArrays();
+                for (int i = 0; i < aos.numParticles(); ++i, ++ip) {
+                    const int g = ParallelDescriptor::MyProc()*nlocal + ip;
+                    aos[i].rdata(0) = 0.5*g;
+                    aos[i].idata(0) = g;
+                    soa.GetRealData(0)[i] = 1.0/(g+1);
+                    soa.GetIntData(0)[i] = -g;
+                }
+            }
+        }
+
+        pc.Checkpoint("pc_chk", "particles");
+        AMREX_ALWAYS_ASSERT(count_bad_grids("pc_chk/particles") == 0);
+
+        MyParticleContainer pc2(geom, dm, ba);
+        pc2.Restart("pc_chk", "particles");
+        AMREX_ALWAYS_ASSERT(pc2.TotalNumberOfParticles() == nparticles);
+
+        using PTDType = MyParticleContainer::ParticleTileType::ConstParticleTileDataType;
+        auto sum = [] (MyParticleContainer const& c) {
+            Vector<Real> s{
+                amrex::ReduceSum(c, [=] AMREX_GPU_HOST_DEVICE (const PTDType& p, const int i) -> Real
+                    { return AMREX_D_TERM(p.m_aos[i].pos(0), + 3*p.m_aos[i].pos(1), + 7*p.m_aos[i].pos(2)); }),
+                amrex::ReduceSum(c, [=] AMREX_GPU_HOST_DEVICE (const PTDType& p, const int i) -> Real
+                    { return p.m_aos[i].rdata(0) + p.m_aos[i].rdata(AMREX_SPACEDIM); }),
+                amrex::ReduceSum(c, [=] AMREX_GPU_HOST_DEVICE (const PTDType& p, const int i) -> Real
+                    { return Real(p.m_aos[i].idata(0)); }),
+                amrex::ReduceSum(c, [=] AMREX_GPU_HOST_DEVICE (const PTDType& p, const int i) -> Real
+                    { return p.m_rdata[0][i] - Real(p.m_idata[0][i]); })};
+            ParallelDescriptor::ReduceRealSum(s.dataPtr(), s.size());
+            return s;
+        };
+        const auto s1 = sum(pc);
+        const auto s2 = sum(pc2);
+        for (int i = 0; i < s1.size(); ++i) {
+            AMREX_ALWAYS_ASSERT(std::abs(s1[i]-s2[i]) <= 1.e-12*std::abs(s1[i]));
+        }
+
+        corrupt("pc_chk/particles/Level_0/DATA_00000", 10);
+        AMREX_ALWAYS_ASSERT(count_bad_grids("pc_chk/particles") == 1);
+        amrex::Print() << "particle checksums passed\n";
+    }
+}
@@ -12,9 +12,14 @@ struct TestParams
     IntVect size;
     int max_grid_size;
     int is_periodic;
+    int num_ppc = 1;
+    int num_steps = 0;
+    Real verlet_skin = 0.2;
+    Real max_step = 0.01;
 };
 
 void testNeighborList();
+void benchNeighborList();
 
 int main (int argc, char* argv[])
 {
@@ -22,6 +27,8 @@ int main (int argc, char* argv[])
 
     testNeighborList();
 
+    benchNeighborList();
+
     amrex::Finalize();
 }
 
@@ -31,6 +38,10 @@ void get_test_params(TestParams& params, const std::string& prefix)
     pp.get("size", params.size);
     pp.get("max_grid_size", params.max_grid_size);
     pp.get("is_periodic", params.is_periodic);
+    pp.query("num_ppc", params.num_ppc);
+    pp.query("num_steps", params.num_steps);
+    pp.query("verlet_skin", params.verlet_skin);
+    pp.query("max_step", params.max_step);
 }
 
 namespace Params
@@ -139,3 +150,183 @@ void testNeighborList ()
         nlist2.print();
     }
 }
+
+// Particles that carry a velocity, for the Verlet list benchmark
+using PCType3 = amrex::NeighborParticleContainer<AMREX_SPACEDIM, 0>;
+using PType3 = PCType3::ParticleType;
+
+struct CheckPairSkin
+{
+    amrex::Real cutoff2;
+
+    template <class P1, class P2>
+    AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+    bool operator() (const P1& p1, const P2& p2) const
+    {
+        AMREX_D_TERM(amrex::Real d0 = (p1.pos(0) - p2.pos(0));,
+                     amrex::Real d1 = (p1.pos(1) - p2.pos(1));,
+                     amrex::Real d2 = (p1.pos(2) - p2.pos(2));)
+        amrex::Real dsquared = AMREX_D_TERM(d0*d0, + d1*d1, + d2*d2);
+        return (dsquared <= cutoff2);
+    }
+};
+
+void initBenchParticles (PCType3& pc, int num_ppc, Real max_step)
+{
+    const int lev = 0;
+    const auto dx = pc.Geom(lev).CellSizeArray();
+    const auto plo = pc.Geom(lev).ProbLoArray();
+
+    for (MFIter mfi = pc.MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        const Box& tile_box = mfi.tilebox();
+        Gpu::HostVector<PType3> host_particles;
+        for (IntVect iv = tile_box.smallEnd(); iv <= tile_box.bigEnd(); tile_box.next(iv)) {
+            for (int n = 0; n < num_ppc; ++n) {
+                PType3 p;
+                p.id() = PType3::NextID();
+                p.cpu() = ParallelDescriptor::MyProc();
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    p.pos(d) = static_cast<ParticleReal>(plo[d] + (iv[d] + amrex::Random())*dx[d]);
+                    p.rdata(d) = static_cast<ParticleReal>((2.0*amrex::Random()-1.0)*max_step);
+                }
+                host_particles.push_back(p);
+            }
+        }
+
+        auto& ptile = pc.DefineAndReturnParticleTile(lev, mfi);
+        auto old_size = ptile.GetArrayOfStructs().size();
+        ptile.resize(old_size + host_particles.size());
+        Gpu::copyAsync(Gpu::hostToDevice, host_particles.begin(), host_particles.end(),
+                       ptile.GetArrayOfStructs().begin() + old_size);
+        Gpu::streamSynchronize();
+    }
+
+    pc.Redistribute();
+}
+
+void moveBenchParticles (PCType3& pc)
+{
+    const int lev = 0;
+    for (MFIter mfi = pc.MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        auto& ptile = pc.ParticlesAt(lev, mfi);
+        const int np = ptile.numRealParticles();
+        auto pstruct = ptile.GetArrayOfStructs()().dataPtr();
+        AMREX_FOR_1D ( np, i,
+        {
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                pstruct[i].pos(d) += pstruct[i].rdata(d);
+            }
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+Long countBenchPairs (PCType3& pc, Real cutoff)
+{
+    const int lev = 0;
+    const Real cutoff2 = cutoff*cutoff;
+    Long npairs = 0;
+    auto& nlists = pc.GetNeighborList();
+    for (MFIter mfi = pc.MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        auto index = std::make_pair(mfi.index(), mfi.LocalTileIndex());
+        auto& ptile = pc.ParticlesAt(lev, mfi);
+        const int np = ptile.numRealParticles();
+        if (np == 0) continue;
+        auto pstruct = ptile.GetArrayOfStructs()().dataPtr();
+        auto nbor_data = nlists[lev][index].data();
+        ReduceOps<ReduceOpSum> reduce_op;
+        ReduceData<Long> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        reduce_op.eval(np, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i) -> ReduceTuple
+        {
+            Long n = 0;
+            for (const auto& p2 : nbor_data.getNeighbors(i)) {
+                Real d2 = 0.0;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    Real dd = pstruct[i].pos(d) - p2.pos(d);
+                    d2 += dd*dd;
+                }
+                if (d2 <= cutoff2) { ++n; }
+            }
+            return {n};
+        });
+        npairs += amrex::get<0>(reduce_data.value(reduce_op));
+    }
+    ParallelDescriptor::ReduceLongSum(npairs);
+    return npairs;
+}
+
+void benchNeighborList ()
+{
+    BL_PROFILE("benchNeighborList()");
+    TestParams params;
+    get_test_params(params, "nbor_list");
+
+    if (params.num_steps <= 0) return;
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    const Box domain(IntVect(AMREX_D_DECL(0, 0, 0)),
+                     IntVect(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1)));
+
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++)
+        is_per[i] = params.is_periodic;
+    Geometry geom(domain, &real_box, 0, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    // cutoff+skin must not exceed the one cell searched for neighbors
+    const Real cutoff = 4.0*Params::cutoff;
+
+    // Run the same trajectory twice, once rebuilding the list every step
+    // and once with a Verlet skin, and compare.
+    Real time[2];
+    Long pairs[2] = {0, 0};
+    Long builds[2];
+    for (int ibench = 0; ibench < 2; ++ibench)
+    {
+        const Real skin = (ibench == 0) ? Real(0.0) : params.verlet_skin;
+
+        PCType3 pc(geom, dm, ba, 1);
+        amrex::ResetRandomSeed(42);
+        initBenchParticles(pc, params.num_ppc, params.max_step);
+        pc.setVerletSkin(skin);
+
+        ParallelDescriptor::Barrier();
+        const Real strt_time = amrex::second();
+
+        CheckPairSkin check_pair{(cutoff+skin)*(cutoff+skin)};
+        for (int step = 0; step < params.num_steps; ++step) {
+            pc.buildNeighborListIfNeeded(check_pair, true);
+            pairs[ibench] += countBenchPairs(pc, cutoff);
+            moveBenchParticles(pc);
+        }
+
+        time[ibench] = amrex::second() - strt_time;
+        ParallelDescriptor::ReduceRealMax(time[ibench]);
+        builds[ibench] = pc.numNeighborListBuilds();
+    }
+
+    amrex::Print() << "Neighbor list benchmark, " << params.num_steps << " steps\n";
+    for (int ibench = 0; ibench < 2; ++ibench) {
+        amrex::Print() << (ibench == 0 ? "  rebuild every step: " : "  Verlet skin:        ")
+                       << builds[ibench] << " builds, "
+                       << pairs[ibench] << " pairs, "
+                       << time[ibench] << " s, "
+                       << static_cast<Real>(pairs[ibench])/time[ibench] << " pairs/s\n";
+    }
+
+    AMREX_ALWAYS_ASSERT(pairs[0] == pairs[1]);
+}
@@ -1,4 +1,6 @@
 #include <iostream>
+#include <map>
+#include <set>
 
 #include <AMReX.H>
 #include <AMReX_MultiFab.H>
@@ -17,8 +19,76 @@ struct TestParams {
   int max_grid_size;
   int nppc;
   bool verbose;
+  int nreps;
 };
 
+typedef ParticleContainer<1 + 2*AMREX_SPACEDIM, 1> MyParticleContainer;
+
+template <class Interp = ParticleInterpolator::Linear>
+void depositParticles (MyParticleContainer& myPC, MultiFab& partMF, const Geometry& geom,
+                       DepositionStrategy strategy = DepositionStrategy::ThreadLocal)
+{
+  const auto plo = geom.ProbLoArray();
+  const auto dxi = geom.InvCellSizeArray();
+  amrex::ParticleToMesh(myPC, partMF, 0,
+                        [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleTileType::ConstParticleTileDataType& ptd, int i,
+                                              amrex::Array4<amrex::Real> const& rho)
+      {
+          auto p = ptd.m_aos[i];
+          Interp interp(p, plo, dxi);
+
+          interp.ParticleToMesh(p, rho, 0, 0, 1,
+                      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& part, int comp)
+                      {
+                          return part.rdata(comp);  // no weighting
+                      });
+
+          interp.ParticleToMesh(p, rho, 1, 1, AMREX_SPACEDIM,
+                      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& part, int comp)
+                      {
+                          return part.rdata(0) * p.rdata(comp);  // mass weight these comps
+                      });
+      }, true, strategy);
+}
+
+// Measure the deposition throughput of each DepositionStrategy and check that
+// they give the same answer.
+template <class Interp>
+void timeDepositionStrategies (MyParticleContainer& myPC, MultiFab& partMF, const Geometry& geom,
+                               int nreps, const std::string& name)
+{
+  const int nc = partMF.nComp();
+  MultiFab ref(partMF.boxArray(), partMF.DistributionMap(), nc, 0);
+  const Long np = myPC.TotalNumberOfParticles();
+
+  for (auto strategy : {DepositionStrategy::ThreadLocal, DepositionStrategy::Colored})
+  {
+      ParallelDescriptor::Barrier();
+      auto strt = amrex::second();
+      for (int i = 0; i < nreps; ++i) {
+          depositParticles<Interp>(myPC, partMF, geom, strategy);
+      }
+      auto t = (amrex::second() - strt) / nreps;
+      ParallelDescriptor::ReduceRealMax(t, ParallelDescriptor::IOProcessorNumber());
+
+      if (strategy == DepositionStrategy::ThreadLocal) {
+          MultiFab::Copy(ref, partMF, 0, 0, nc, 0);
+          amrex::Print() << name << " deposition, thread-local : ";
+      } else {
+          Vector<Real> scale(nc);
+          for (int n = 0; n < nc; ++n) {
+              scale[n] = ref.norm0(n);
+          }
+          MultiFab::Subtract(ref, partMF, 0, 0, nc, 0);
+          for (int n = 0; n < nc; ++n) {
+              AMREX_ALWAYS_ASSERT(scale[n] > 0.0 && ref.norm0(n) <= 1.e-12 * scale[n]);
+          }
+          amrex::Print() << name << " deposition, colored      : ";
+      }
+      amrex::Print() << t << " s, " << np / t << " particles/s\n";
+  }
+}
+
 void testParticleMesh (TestParams& parms)
 {
 
@@ -52,7 +122,6 @@ void testParticleMesh (TestParams& parms)
   iMultiFab partiMF(ba, dmap, 1 + AMREX_SPACEDIM, 1);
   partiMF.setVal(0);
 
-  typedef ParticleContainer<1 + 2*AMREX_SPACEDIM, 1> MyParticleContainer;
   MyParticleContainer myPC(geom, dmap, ba);
   myPC.SetVerbose(false);
 
@@ -67,33 +136,97 @@ void testParticleMesh (TestParams& parms)
   MyParticleContainer::ParticleInitData pdata = {{mass, AMREX_D_DECL(1.0, 2.0, 3.0), AMREX_D_DECL(0.0, 0.0, 0.0)}, {},{},{}};
   myPC.InitRandom(num_particles, iseed, pdata, serialize);
 
-  int nc = 1 + AMREX_SPACEDIM;
   const auto plo = geom.ProbLoArray();
   const auto dxi = geom.InvCellSizeArray();
-  amrex::ParticleToMesh(myPC, partMF, 0,
-                        [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleTileType::ConstParticleTileDataType& ptd, int i,
-                                              amrex::Array4<amrex::Real> const& rho)
+  // InitRandom leaves the particles in random order. Compare the cost of
+  // sorting them for locality with the time saved in the deposition.
+  if (parms.nreps > 0) {
+      auto time_deposit = [&] () {
+          ParallelDescriptor::Barrier();
+          auto strt = amrex::second();
+          for (int i = 0; i < parms.nreps; ++i) {
+              partMF.setVal(0.0);
+              depositParticles(myPC, partMF, geom);
+          }
+          auto t = (amrex::second() - strt) / parms.nreps;
+          ParallelDescriptor::ReduceRealMax(t, ParallelDescriptor::IOProcessorNumber());
+          return t;
+      };
+
+      auto max_disorder = [&] () {
+          Real disorder = 0.0;
+          for (MFIter mfi = myPC.MakeMFIter(0); mfi.isValid(); ++mfi) {
+              disorder = amrex::max(disorder, myPC.ParticleDisorder(0, mfi));
+          }
+          ParallelDescriptor::ReduceRealMax(disorder, ParallelDescriptor::IOProcessorNumber());
+          return disorder;
+      };
+
+      auto disorder_unsorted = max_disorder();
+      auto t_unsorted = time_deposit();
+
+      ParallelDescriptor::Barrier();
+      auto strt = amrex::second();
+      myPC.SortParticlesForLocality(0.1);
+      auto t_sort = amrex::second() - strt;
+      ParallelDescriptor::ReduceRealMax(t_sort, ParallelDescriptor::IOProcessorNumber());
+
+      auto t_sorted = time_deposit();
+      auto disorder_sorted = max_disorder();
+
+      amrex::Print() << "Disorder before sorting      : " << disorder_unsorted << "\n"
+                     << "Disorder after sorting       : " << disorder_sorted << "\n"
+                     << "Deposition time, unsorted    : " << t_unsorted << " s\n"
+                     << "Locality sort time           : " << t_sort << " s\n"
+                     << "Deposition time, sorted      : " << t_sorted << " s\n";
+      if (t_unsorted > t_sorted) {
+          amrex::Print() << "Depositions to amortize sort : "
+                         << t_sort / (t_unsorted - t_sorted) << "\n";
+      }
+      amrex::Print() << "\n";
+
+      timeDepositionStrategies<ParticleInterpolator::Linear>(myPC, partMF, geom, parms.nreps, "CIC");
+      timeDepositionStrategies<ParticleInterpolator::Quadratic>(myPC, partMF, geom, parms.nreps, "TSC");
+      amrex::Print() << "\n";
+
+      // With particle tiling, the tiles of a grid have all the colors and
+      // the colored deposition runs them one color at a time.
       {
-          auto p = ptd.m_aos[i];
-          ParticleInterpolator::Linear interp(p, plo, dxi);
-
-          interp.ParticleToMesh(p, rho, 0, 0, 1,
-                      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& part, int comp)
-                      {
-                          return part.rdata(comp);  // no weighting
-                      });
+          const bool do_tiling = MyParticleContainer::do_tiling;
+          const IntVect tile_size = MyParticleContainer::tile_size;
+          MyParticleContainer::do_tiling = true;
+          MyParticleContainer::tile_size = IntVect(parms.max_grid_size/4);
+          myPC.Redistribute();
+
+          std::map<std::pair<int,int>,int> colors;
+          bool separated;
+          particle_detail::getTileColors(*partMF.getTileArray(MyParticleContainer::tile_size),
+                                         partMF.nGrowVect(), colors, separated);
+          std::set<int> distinct;
+          for (auto const& c : colors) { distinct.insert(c.second); }
+          int ncolors = static_cast<int>(distinct.size());
+          ParallelDescriptor::ReduceIntMax(ncolors);
+          ParallelDescriptor::ReduceBoolAnd(separated);
+          AMREX_ALWAYS_ASSERT(separated && ncolors == (1 << AMREX_SPACEDIM));
+
+          timeDepositionStrategies<ParticleInterpolator::Linear>(myPC, partMF, geom, parms.nreps, "CIC, tiled");
+          timeDepositionStrategies<ParticleInterpolator::Quadratic>(myPC, partMF, geom, parms.nreps, "TSC, tiled");
+          amrex::Print() << "\n";
+
+          MyParticleContainer::do_tiling = do_tiling;
+          MyParticleContainer::tile_size = tile_size;
+          myPC.Redistribute();
+      }
+
+      partMF.setVal(0.0);
+  }
 
-          interp.ParticleToMesh(p, rho, 1, 1, AMREX_SPACEDIM,
-                      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& part, int comp)
-                      {
-                          return part.rdata(0) * p.rdata(comp);  // mass weight these comps
-                      });
-      });
+  depositParticles(myPC, partMF, geom);
 
   MultiFab acceleration(ba, dmap, AMREX_SPACEDIM, 1);
   acceleration.setVal(5.0);
 
-  nc = AMREX_SPACEDIM;
+  int nc = AMREX_SPACEDIM;
   amrex::MeshToParticle(myPC, acceleration, 0,
       [=] AMREX_GPU_DEVICE (MyParticleContainer::ParticleType& p,
                             amrex::Array4<const amrex::Real> const& acc)
@@ -173,6 +306,9 @@ int main(int argc, char* argv[])
   parms.verbose = false;
   pp.query("verbose", parms.verbose);
 
+  parms.nreps = 0;
+  pp.query("nreps", parms.nreps);
+
   if (parms.verbose && ParallelDescriptor::IOProcessor()) {
     std::cout << std::endl;
     std::cout << "Number of particles per cell : ";
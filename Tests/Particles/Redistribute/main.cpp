@@ -3,6 +3,12 @@
 #include <AMReX_MultiFab.H>
 #include <AMReX_Particles.H>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <set>
+#include <string>
+
 using namespace amrex;
 
 static constexpr int NSR = 6;
@@ -309,6 +315,216 @@ public:
             }
         }
     }
+
+    // Replaces the particles with a copy of those of other, tile by tile,
+    // whatever the DistributionMapping of the grids they are in.
+    void copyTiles (const TestParticleContainer& other)
+    {
+        for (int lev = 0; lev <= finestLevel(); ++lev)
+        {
+            GetParticles(lev).clear();
+            for (auto const& kv : other.GetParticles(lev))
+            {
+                auto& ptile = DefineAndReturnParticleTile(lev, kv.first.first, kv.first.second);
+                const auto np = kv.second.numParticles();
+                ptile.resize(np);
+                amrex::copyParticles(ptile, kv.second, 0, 0, np);
+            }
+        }
+        Gpu::streamSynchronize();
+    }
+
+    // Redistributes the particles the way the CPU Redistribute did before
+    // it kept its buffers between calls: every particle is located as
+    // locateParticle does, invalid and lost particles are removed, and the
+    // others are appended to the tile they belong to, on the rank that owns
+    // its grid.  Only the order of the particles within a tile may differ.
+    void RedistributeReference (bool remove_neg=true)
+    {
+        const int myproc = ParallelDescriptor::MyProc();
+        const int nprocs = ParallelDescriptor::NProcs();
+        const int nreal = NumRealComps();
+        const int nint = NumIntComps();
+        const std::size_t record_size = 4*sizeof(int) + sizeof(ParticleType)
+            + nreal*sizeof(ParticleReal) + nint*sizeof(int);
+
+        // A record is the destination rank, level, grid and tile, and the particle.
+        Vector<char> mine, theirs;
+        for (int lev = 0; lev <= finestLevel(); ++lev)
+        {
+            for (auto& kv : GetParticles(lev))
+            {
+                auto& aos = kv.second.GetArrayOfStructs();
+                auto& soa = kv.second.GetStructOfArrays();
+                const int np = aos.numParticles();
+                for (int i = 0; i < np; ++i)
+                {
+                    ParticleType p = aos[i];
+                    ParticleLocData pld;
+                    int dest[4] = {myproc, lev, kv.first.first, kv.first.second};
+                    if (p.id() < 0) {
+                        if (remove_neg) { continue; }
+                    } else {
+                        if (!locate(p, pld)) { continue; }
+                        dest[0] = ParticleDistributionMap(pld.m_lev)[pld.m_grid];
+                        dest[1] = pld.m_lev;
+                        dest[2] = pld.m_grid;
+                        dest[3] = pld.m_tile;
+                    }
+                    Vector<char>& buf = dest[0] == myproc ? mine : theirs;
+                    const std::size_t old_size = buf.size();
+                    buf.resize(old_size + record_size);
+                    char* dst = buf.data() + old_size;
+                    std::memcpy(dst, dest, sizeof(dest));
+                    dst += sizeof(dest);
+                    std::memcpy(dst, &p, sizeof(ParticleType));
+                    dst += sizeof(ParticleType);
+                    for (int comp = 0; comp < nreal; ++comp) {
+                        std::memcpy(dst, &soa.GetRealData(comp)[i], sizeof(ParticleReal));
+                        dst += sizeof(ParticleReal);
+                    }
+                    for (int comp = 0; comp < nint; ++comp) {
+                        std::memcpy(dst, &soa.GetIntData(comp)[i], sizeof(int));
+                        dst += sizeof(int);
+                    }
+                }
+            }
+            GetParticles(lev).clear();
+        }
+
+        auto unpack = [&] (Vector<char> const& buf)
+        {
+            for (const char* src = buf.data(); src < buf.data() + buf.size(); src += record_size)
+            {
+                int dest[4];
+                std::memcpy(dest, src, sizeof(dest));
+                if (dest[0] != myproc) { continue; }
+                auto& ptile = DefineAndReturnParticleTile(dest[1], dest[2], dest[3]);
+                ParticleType p;
+                std::memcpy(&p, src + sizeof(dest), sizeof(ParticleType));
+                ptile.push_back(p);
+                const char* data = src + sizeof(dest) + sizeof(ParticleType);
+                for (int comp = 0; comp < nreal; ++comp) {
+                    ParticleReal v;
+                    std::memcpy(&v, data, sizeof(ParticleReal));
+                    ptile.push_back_real(comp, v);
+                    data += sizeof(ParticleReal);
+                }
+                for (int comp = 0; comp < nint; ++comp) {
+                    int v;
+                    std::memcpy(&v, data, sizeof(int));
+                    ptile.push_back_int(comp, v);
+                    data += sizeof(int);
+                }
+            }
+        };
+
+        unpack(mine);
+
+        // Every rank sees the particles that leave every other rank.
+        Vector<Long> nbytes(nprocs);
+        ParallelAllGather::AllGather(static_cast<Long>(theirs.size()), nbytes.data(),
+                                     ParallelDescriptor::Communicator());
+        for (int root = 0; root < nprocs; ++root)
+        {
+            if (nbytes[root] == 0) { continue; }
+            Vector<char> buf;
+            if (root == myproc) {
+                buf.swap(theirs);
+            } else {
+                buf.resize(nbytes[root]);
+            }
+            ParallelDescriptor::Bcast(buf.data(), buf.size(), root);
+            if (root != myproc) { unpack(buf); }
+        }
+    }
+
+    // The number of tiles, on all ranks, whose particles differ from those
+    // of other in number or in any component, in whatever order they are.
+    Long numDifferentTiles (const TestParticleContainer& other) const
+    {
+        Long ndiff = 0;
+        for (int lev = 0; lev <= finestLevel(); ++lev)
+        {
+            std::set<std::pair<int,int> > keys;
+            for (auto const& kv : GetParticles(lev)) {
+                if (kv.second.numParticles() > 0) { keys.insert(kv.first); }
+            }
+            for (auto const& kv : other.GetParticles(lev)) {
+                if (kv.second.numParticles() > 0) { keys.insert(kv.first); }
+            }
+            for (auto const& key : keys)
+            {
+                if (sortedRecords(lev, key) != other.sortedRecords(lev, key)) { ++ndiff; }
+            }
+        }
+        ParallelDescriptor::ReduceLongSum(ndiff);
+        return ndiff;
+    }
+
+private:
+
+    // The particles of a tile, each as the bytes of its components, sorted.
+    Vector<std::string> sortedRecords (int lev, const std::pair<int,int>& key) const
+    {
+        Vector<std::string> r;
+        auto const& plev = GetParticles(lev);
+        auto it = plev.find(key);
+        if (it == plev.end()) { return r; }
+        const auto ptd = it->second.getConstParticleTileData();
+        const int np = it->second.numParticles();
+        auto append = [] (std::string& s, auto const& v) {
+            s.append(reinterpret_cast<const char*>(&v), sizeof(v));
+        };
+        for (int i = 0; i < np; ++i)
+        {
+            auto const& p = ptd.m_aos[i];
+            std::string s;
+            append(s, static_cast<Long>(p.id()));
+            append(s, static_cast<int>(p.cpu()));
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) { append(s, p.pos(d)); }
+            for (int j = 0; j < NSR; ++j) { append(s, p.rdata(j)); }
+            for (int j = 0; j < NSI; ++j) { append(s, p.idata(j)); }
+            for (int j = 0; j < NAR; ++j) { append(s, ptd.m_rdata[j][i]); }
+            for (int j = 0; j < NAI; ++j) { append(s, ptd.m_idata[j][i]); }
+            for (int j = 0; j < NumRuntimeRealComps(); ++j) { append(s, ptd.m_runtime_rdata[j][i]); }
+            for (int j = 0; j < NumRuntimeIntComps(); ++j) { append(s, ptd.m_runtime_idata[j][i]); }
+            r.push_back(std::move(s));
+        }
+        std::sort(r.begin(), r.end());
+        return r;
+    }
+
+    // What locateParticle does on level 0 and up: a particle just inside the
+    // domain but outside its roundoff domain is moved in, one outside is
+    // mapped through the periodic boundaries.  Returns false if it is lost.
+    bool locate (ParticleType& p, ParticleLocData& pld) const
+    {
+        const Geometry& geom = Geom(0);
+        bool outside = false;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            outside = outside || p.pos(d) < geom.ProbLo(d) || p.pos(d) >= geom.ProbHi(d);
+        }
+        if (outside) {
+            return EnforcePeriodicWhere(p, pld);
+        }
+        if (geom.outsideRoundoffDomain(AMREX_D_DECL(Real(p.pos(0)), Real(p.pos(1)), Real(p.pos(2)))))
+        {
+            const RealBox& rd = geom.RoundoffDomain();
+            for (int d = 0; d < AMREX_SPACEDIM; ++d)
+            {
+                if (p.pos(d) <= rd.lo(d)) {
+                    p.pos(d) = std::nextafter((ParticleReal) rd.lo(d), (ParticleReal) rd.hi(d));
+                }
+                if (p.pos(d) >= rd.hi(d)) {
+                    p.pos(d) = std::nextafter((ParticleReal) rd.hi(d), (ParticleReal) rd.lo(d));
+                }
+            }
+        }
+        const bool found = Where(p, pld);
+        AMREX_ALWAYS_ASSERT(found);
+        return true;
+    }
 };
 
 struct TestParams
@@ -324,6 +540,8 @@ struct TestParams
     int do_regrid;
     int sort;
     int test_level_lost = 0;
+    int compare_buffer_reuse = 0;
+    int check_reference = 0;
 };
 
 void testRedistribute();
@@ -357,6 +575,9 @@ void get_test_params(TestParams& params, const std::string& prefix)
 
     params.sort = 0;
     pp.query("sort", params.sort);
+
+    pp.query("compare_buffer_reuse", params.compare_buffer_reuse);
+    pp.query("check_reference", params.check_reference);
 }
 
 void testRedistribute ()
@@ -419,19 +640,63 @@ void testRedistribute ()
 
     if (params.sort) pc.SortParticlesByCell();
 
-    for (int i = 0; i < params.nsteps; ++i)
+    // If check_reference is set, the particles of pc are copied into ref
+    // before every Redistribute, ref is redistributed with
+    // RedistributeReference, and every tile must have the same particles.
+    // Returns the time taken by the Redistribute of pc.
+    TestParticleContainer ref(geom, dm, ba, rr);
+    auto redistribute = [&] (bool local, bool remove_neg)
     {
-        pc.moveParticles(params.move_dir, params.do_random);
-        if (!remove_negative) {
-            auto old = pc.TotalNumberOfParticles();
-            pc.negateEven();
-            pc.RedistributeLocal(false);
-            AMREX_ALWAYS_ASSERT(old == pc.TotalNumberOfParticles(false));
-            pc.negateEven();
+        if (params.check_reference) ref.copyTiles(pc);
+        ParallelDescriptor::Barrier();
+        auto strt = amrex::second();
+        if (local) {
+            pc.RedistributeLocal(remove_neg);
+        } else {
+            pc.RedistributeGlobal(remove_neg);
+        }
+        Real t = amrex::second() - strt;
+        if (params.check_reference) {
+            ref.RedistributeReference(remove_neg);
+            const Long ndiff = pc.numDifferentTiles(ref);
+            if (ndiff != 0) {
+                amrex::Print() << ndiff << " tiles differ from the reference Redistribute\n";
+            }
+            AMREX_ALWAYS_ASSERT(ndiff == 0);
+        }
+        return t;
+    };
+
+    // If compare_buffer_reuse is set, the steps are run a second time with the
+    // Redistribute scratch buffers released before every call, which is what
+    // each call used to cost before the buffers were kept between steps.
+    const int npasses = params.compare_buffer_reuse ? 2 : 1;
+    Vector<Real> redist_time(npasses, 0.0);
+    for (int pass = 0; pass < npasses; ++pass)
+    {
+        for (int i = 0; i < params.nsteps; ++i)
+        {
+            pc.moveParticles(params.move_dir, params.do_random);
+            if (!remove_negative) {
+                auto old = pc.TotalNumberOfParticles();
+                pc.negateEven();
+                redistribute(true, false);
+                AMREX_ALWAYS_ASSERT(old == pc.TotalNumberOfParticles(false));
+                pc.negateEven();
+            }
+            if (pass == 1) pc.ClearRedistributeBuffers();
+            redist_time[pass] += redistribute(true, true);
+            if (params.sort) pc.SortParticlesByCell();
+            pc.checkAnswer();
         }
-        pc.RedistributeLocal();
-        if (params.sort) pc.SortParticlesByCell();
-        pc.checkAnswer();
+    }
+
+    ParallelDescriptor::ReduceRealMax(redist_time.dataPtr(), npasses,
+                                      ParallelDescriptor::IOProcessorNumber());
+    amrex::Print() << "Redistribute time per step: " << redist_time[0]/params.nsteps << " s\n";
+    if (params.compare_buffer_reuse) {
+        amrex::Print() << "Redistribute time per step without buffer reuse: "
+                       << redist_time[1]/params.nsteps << " s\n";
     }
 
     if (params.do_regrid)
@@ -445,15 +710,16 @@ void testRedistribute ()
                 for (int i = 0; i < ba[lev].size(); ++i) pmap.push_back(i % NProcs);
                 new_dm.define(pmap);
                 pc.SetParticleDistributionMap(lev, new_dm);
+                ref.SetParticleDistributionMap(lev, new_dm);
             }
             if (!remove_negative) {
                 auto old = pc.TotalNumberOfParticles();
                 pc.negateEven();
-                pc.RedistributeGlobal(false);
+                redistribute(false, false);
                 AMREX_ALWAYS_ASSERT(old == pc.TotalNumberOfParticles(false));
                 pc.negateEven();
             }
-            pc.RedistributeGlobal();
+            redistribute(false, true);
             pc.checkAnswer();
         }
 
@@ -465,15 +731,16 @@ void testRedistribute ()
                 for (int i = 0; i < ba[lev].size(); ++i) pmap.push_back((i+1) % NProcs);
                 new_dm.define(pmap);
                 pc.SetParticleDistributionMap(lev, new_dm);
+                ref.SetParticleDistributionMap(lev, new_dm);
             }
             if (!remove_negative) {
                 auto old = pc.TotalNumberOfParticles();
                 pc.negateEven();
-                pc.RedistributeGlobal(false);
+                redistribute(false, false);
                 AMREX_ALWAYS_ASSERT(old == pc.TotalNumberOfParticles(false));
                 pc.negateEven();
             }
-            pc.RedistributeGlobal();
+            redistribute(false, true);
             pc.checkAnswer();
         }
 
@@ -0,0 +1,207 @@
+// Integrates a stiff reaction network (Robertson) in every cell with ARKODE,
+// once with the fused NVector_MultiFab operations and once without, and
+// compares the results and run times.
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Sundials.H>
+
+#include <arkode/arkode_arkstep.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
+
+using namespace amrex;
+
+namespace {
+
+constexpr Real k2 = 3.e7;
+constexpr Real k3 = 1.e4;
+
+struct UserData
+{
+    MultiFab k1;    // spatially varying rate of the slow reaction
+    MultiFab ysave; // state at which the preconditioner was set up
+};
+
+// f(t,y) for y1' = -k1 y1 + k3 y2 y3, y2' = k1 y1 - k3 y2 y3 - k2 y2^2, y3' = k2 y2^2
+int rhs (realtype /*t*/, N_Vector y, N_Vector ydot, void* user_data)
+{
+    auto* udata = static_cast<UserData*>(user_data);
+    auto const& ya = amrex::sundials::getMFptr(y)->const_arrays();
+    auto const& fa = amrex::sundials::getMFptr(ydot)->arrays();
+    auto const& ka = udata->k1.const_arrays();
+    amrex::ParallelFor(udata->k1,
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+    {
+        const Real k1 = ka[b](i,j,k);
+        const Real y1 = ya[b](i,j,k,0);
+        const Real y2 = ya[b](i,j,k,1);
+        const Real y3 = ya[b](i,j,k,2);
+        fa[b](i,j,k,0) = -k1*y1 + k3*y2*y3;
+        fa[b](i,j,k,1) =  k1*y1 - k3*y2*y3 - k2*y2*y2;
+        fa[b](i,j,k,2) =  k2*y2*y2;
+    });
+    Gpu::streamSynchronize();
+    return 0;
+}
+
+int psetup (realtype /*t*/, N_Vector y, N_Vector /*fy*/, booleantype jok,
+            booleantype* jcurPtr, realtype /*gamma*/, void* user_data)
+{
+    auto* udata = static_cast<UserData*>(user_data);
+    if (jok) {
+        *jcurPtr = SUNFALSE;
+    } else {
+        MultiFab::Copy(udata->ysave, *amrex::sundials::getMFptr(y), 0, 0, 3, 0);
+        *jcurPtr = SUNTRUE;
+    }
+    return 0;
+}
+
+// Solves (I - gamma J) z = r exactly in each cell
+int psolve (realtype /*t*/, N_Vector /*y*/, N_Vector /*fy*/, N_Vector r, N_Vector z,
+            realtype gamma, realtype /*delta*/, int /*lr*/, void* user_data)
+{
+    auto* udata = static_cast<UserData*>(user_data);
+    auto const& ya = udata->ysave.const_arrays();
+    auto const& ka = udata->k1.const_arrays();
+    auto const& ra = amrex::sundials::getMFptr(r)->const_arrays();
+    auto const& za = amrex::sundials::getMFptr(z)->arrays();
+    amrex::ParallelFor(udata->k1,
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+    {
+        const Real k1 = ka[b](i,j,k);
+        const Real y2 = ya[b](i,j,k,1);
+        const Real y3 = ya[b](i,j,k,2);
+        const Real a00 = 1. + gamma*k1, a01 = -gamma*k3*y3,                 a02 = -gamma*k3*y2;
+        const Real a10 = -gamma*k1,     a11 = 1. + gamma*(k3*y3+2.*k2*y2), a12 =  gamma*k3*y2;
+        const Real a20 = 0.,            a21 = -gamma*2.*k2*y2,              a22 = 1.;
+        const Real r0 = ra[b](i,j,k,0);
+        const Real r1 = ra[b](i,j,k,1);
+        const Real r2 = ra[b](i,j,k,2);
+        const Real det = a00*(a11*a22-a12*a21) - a01*(a10*a22-a12*a20) + a02*(a10*a21-a11*a20);
+        za[b](i,j,k,0) = ( r0*(a11*a22-a12*a21) - a01*(r1*a22-a12*r2) + a02*(r1*a21-a11*r2)) / det;
+        za[b](i,j,k,1) = (a00*(r1*a22-a12*r2) - r0*(a10*a22-a12*a20) + a02*(a10*r2-r1*a20)) / det;
+        za[b](i,j,k,2) = (a00*(a11*r2-r1*a21) - a01*(a10*r2-r1*a20) + r0*(a10*a21-a11*a20)) / det;
+    });
+    Gpu::streamSynchronize();
+    return 0;
+}
+
+void integrate (MultiFab& state, UserData& udata, Real tfinal, Real rtol, Real atol,
+                bool fused, long int& nsteps, long int& nliters)
+{
+    SUNContext sunctx = *amrex::sundials::The_Sundials_Context();
+
+    state.setVal(0.0);
+    state.setVal(1.0, 0, 1);
+
+    const sunindextype length = state.nComp() * state.boxArray().numPts();
+    N_Vector y = amrex::sundials::N_VMake_MultiFab(length, &state, sunctx);
+    AMREX_ALWAYS_ASSERT(y->sunctx == sunctx);
+    AMREX_ALWAYS_ASSERT(y->ops->nvlinearcombination == nullptr);
+    if (fused) {
+        amrex::sundials::N_VEnableFusedOps_MultiFab(y, SUNTRUE);
+    }
+
+    void* arkode_mem = ARKStepCreate(nullptr, rhs, 0.0, y, sunctx);
+    ARKStepSetUserData(arkode_mem, &udata);
+    ARKStepSStolerances(arkode_mem, rtol, atol);
+    ARKStepSetMaxNumSteps(arkode_mem, 100000);
+
+    SUNLinearSolver LS = SUNLinSol_SPGMR(y, PREC_LEFT, 10, sunctx);
+    SUNLinSol_SPGMRSetGSType(LS, CLASSICAL_GS);
+    ARKStepSetLinearSolver(arkode_mem, LS, nullptr);
+    ARKStepSetPreconditioner(arkode_mem, psetup, psolve);
+
+    realtype t = 0.0;
+    int flag = ARKStepEvolve(arkode_mem, tfinal, y, &t, ARK_NORMAL);
+    AMREX_ALWAYS_ASSERT(flag >= 0);
+
+    ARKStepGetNumSteps(arkode_mem, &nsteps);
+    ARKStepGetNumLinIters(arkode_mem, &nliters);
+
+    ARKStepFree(&arkode_mem);
+    SUNLinSolFree(LS);
+    N_VDestroy(y);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        Real tfinal = 40.0;
+        Real rtol = 1.e-4;
+        Real atol = 1.e-8;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("tfinal", tfinal);
+            pp.query("rtol", rtol);
+            pp.query("atol", atol);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        UserData udata;
+        udata.k1.define(ba, dm, 1, 0);
+        udata.ysave.define(ba, dm, 3, 0);
+        {
+            auto const& ka = udata.k1.arrays();
+            const Real dx = 1.0 / n_cell;
+            amrex::ParallelFor(udata.k1,
+            [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+            {
+                const Real x = (i+0.5)*dx, y = (j+0.5)*dx, z = (k+0.5)*dx;
+                ka[b](i,j,k) = 0.04 * (1.0 + 0.5*std::sin(6.283185307179586*x)*std::cos(3.141592653589793*(y+z)));
+            });
+            Gpu::streamSynchronize();
+        }
+
+        MultiFab state_fused(ba, dm, 3, 0);
+        MultiFab state_plain(ba, dm, 3, 0);
+
+        long int nst_fused, nli_fused, nst_plain, nli_plain;
+
+        double t0 = amrex::second();
+        integrate(state_fused, udata, tfinal, rtol, atol, true, nst_fused, nli_fused);
+        double t1 = amrex::second();
+        integrate(state_plain, udata, tfinal, rtol, atol, false, nst_plain, nli_plain);
+        double t2 = amrex::second();
+
+        double t_fused = t1-t0, t_plain = t2-t1;
+        ParallelDescriptor::ReduceRealMax(t_fused);
+        ParallelDescriptor::ReduceRealMax(t_plain);
+
+        // The network conserves y1+y2+y3 = 1.
+        MultiFab total(ba, dm, 1, 0);
+        MultiFab::Copy(total, state_fused, 0, 0, 1, 0);
+        MultiFab::Add(total, state_fused, 1, 0, 1, 0);
+        MultiFab::Add(total, state_fused, 2, 0, 1, 0);
+        total.plus(-1.0, 0, 1);
+        const Real mass_error = total.norm0();
+
+        MultiFab::Subtract(state_plain, state_fused, 0, 0, 3, 0);
+        const Real diff = state_plain.norm0(0, 3, IntVect(0));
+
+        amrex::Print() << "  fused ops: " << nst_fused << " steps, " << nli_fused
+                       << " linear iterations, " << t_fused << " s\n"
+                       << "  plain ops: " << nst_plain << " steps, " << nli_plain
+                       << " linear iterations, " << t_plain << " s\n"
+                       << "  speedup: " << t_plain/t_fused << "\n"
+                       << "  max difference: " << diff
+                       << ", conservation error: " << mass_error << "\n";
+
+        AMREX_ALWAYS_ASSERT(mass_error < 10.*rtol);
+        AMREX_ALWAYS_ASSERT(diff < 10.*rtol);
+    }
+    amrex::Finalize();
+}
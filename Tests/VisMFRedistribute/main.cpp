@@ -0,0 +1,155 @@
+//
+// Writes a MultiFab with VisMF::Write from one layout and reads it back with
+// VisMF::ReadRedistribute into others, and checks the result bit for bit
+// against VisMF::Read.  The data are written from one rank and from all of
+// them, with and without FAB headers, into one file and into several, and
+// are read into the BoxArray on disk with a different DistributionMapping
+// and into a different BoxArray.
+//
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <cstring>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// Values in all cells, ghost cells included, that differ in every bit
+// position that matters.
+void init (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.fabbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = std::sin(0.37*i + 0.11*n) * std::exp(0.05*j) + 1.e-7*k + n;
+        });
+    }
+}
+
+// The number of FABs of a and b, which have the same layout, that differ
+// in any bit.
+Long num_different (MultiFab const& a, MultiFab const& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        FArrayBox const& fa = a[mfi];
+        FArrayBox const& fb = b[mfi];
+        if (fa.box() != fb.box() ||
+            std::memcmp(fa.dataPtr(), fb.dataPtr(), fa.nBytes()) != 0) {
+            ++ndiff;
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+// The ranks of dm in reverse.
+DistributionMapping reversed (DistributionMapping const& dm)
+{
+    Vector<int> pmap = dm.ProcessorMap();
+    const int nprocs = ParallelDescriptor::NProcs();
+    for (auto& p : pmap) {
+        p = nprocs-1-p;
+    }
+    return DistributionMapping(std::move(pmap));
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 8;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    const int ncomp = 2;
+    const int ngrow = 1;
+    const std::string dir = "vismf_redistribute";
+
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    // All the boxes on one rank, as if written by a run on one process.
+    DistributionMapping dm_one(Vector<int>(ba.size(), 0));
+
+    // Another BoxArray, with boxes that cross those on disk.
+    BoxArray ba_other(Box(IntVect(0), IntVect(n_cell-1)));
+    ba_other.maxSize(IntVect(AMREX_D_DECL(max_grid_size*2, max_grid_size/2, max_grid_size)));
+    DistributionMapping dm_other(ba_other);
+
+    VisMF::SetMFFileInStreams(1);
+
+    struct Case { DistributionMapping const* dm; VisMF::Header::Version version; int nfiles; };
+    for (Case const& c : {Case{&dm,     VisMF::Header::Version_v1,     2},
+                          Case{&dm,     VisMF::Header::NoFabHeader_v1, 1},
+                          Case{&dm_one, VisMF::Header::Version_v1,     1},
+                          Case{&dm_one, VisMF::Header::NoFabHeader_v1, 3}})
+    {
+        const bool one = c.dm == &dm_one;
+        amrex::Print() << "Written " << (one ? "from one rank" : "from all ranks")
+                       << (c.version == VisMF::Header::Version_v1 ? " with" : " without")
+                       << " FAB headers to " << c.nfiles << " file(s)\n";
+
+        // The ghost cells between boxes have the valid data of the
+        // neighbors, as ReadRedistribute gives them precedence.
+        MultiFab src(ba, *c.dm, ncomp, ngrow);
+        init(src);
+        src.FillBoundary();
+
+        amrex::UtilCreateDirectoryDestructive(dir);
+        const std::string name = dir + "/mf";
+        VisMF::SetHeaderVersion(c.version);
+        VisMF::SetNOutFiles(c.nfiles);
+        VisMF::Write(src, name);
+        // The header may be written by a rank other than the I/O process.
+        ParallelDescriptor::Barrier();
+
+        // The BoxArray on disk, on other ranks.
+        {
+            const DistributionMapping& rdm = one ? dm : reversed(dm);
+            MultiFab ref(ba, rdm, ncomp, ngrow);
+            MultiFab mf(ba, rdm, ncomp, ngrow);
+            VisMF::Read(ref, name);
+            VisMF::ReadRedistribute(mf, name);
+            const Long ndiff = num_different(mf, ref);
+            amrex::Print() << "  the same boxes: " << ndiff << " FABs differ\n";
+            AMREX_ALWAYS_ASSERT(ndiff == 0);
+        }
+
+        // A different BoxArray.  Read puts the data into the layout on
+        // disk, from which they are copied.
+        {
+            MultiFab ref_disk(ba, dm, ncomp, ngrow);
+            VisMF::Read(ref_disk, name);
+            MultiFab ref(ba_other, dm_other, ncomp, 0);
+            ref.ParallelCopy(ref_disk, 0, 0, ncomp);
+            MultiFab mf(ba_other, dm_other, ncomp, 0);
+            VisMF::ReadRedistribute(mf, name);
+            const Long ndiff = num_different(mf, ref);
+            amrex::Print() << "  other boxes: " << ndiff << " FABs differ\n";
+            AMREX_ALWAYS_ASSERT(ndiff == 0);
+        }
+    }
+
+    amrex::Print() << "VisMF::ReadRedistribute test passed\n";
+}
@@ -136,6 +136,9 @@ add_amrex_define( AMREX_USE_ASCENT NO_LEGACY IF AMReX_ASCENT )
 # EB
 add_amrex_define( AMREX_USE_EB NO_LEGACY IF AMReX_EB )
 
+# FFT
+add_amrex_define( AMREX_USE_FFT NO_LEGACY IF AMReX_FFT )
+
 #
 # CUDA
 #
@@ -0,0 +1,214 @@
+#include <AMReX.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace amrex;
+
+namespace {
+
+// A range of bytes in a file and its CRC-32.
+struct Chunk
+{
+    std::string file;
+    Long offset;
+    Long nbytes;
+    Long crc;
+};
+
+bool ends_with (std::string const& s, std::string const& suffix)
+{
+    return s.size() >= suffix.size()
+        && s.compare(s.size()-suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Check the chunks, each rank a contiguous range of them.  Returns the number that are bad.
+Long verify_chunks (Vector<Chunk> const& chunks, bool verbose)
+{
+    const Long nchunks = chunks.size();
+    const int myproc = ParallelDescriptor::MyProc();
+    const int nprocs = ParallelDescriptor::NProcs();
+    Long nbad = 0;
+    std::ifstream ifs;
+    std::string open_file;
+    Vector<char> buf;
+    for (Long i = nchunks*myproc/nprocs; i < nchunks*(myproc+1)/nprocs; ++i) {
+        Chunk const& c = chunks[i];
+        if (c.file != open_file) {
+            ifs.close();
+            ifs.open(c.file, std::ios::in | std::ios::binary);
+            open_file = c.file;
+        }
+        ifs.clear();
+        ifs.seekg(c.offset, std::ios::beg);
+        buf.resize(c.nbytes);
+        ifs.read(buf.dataPtr(), c.nbytes);
+        if (!ifs.good() || amrex::CRC32(buf.dataPtr(), c.nbytes) != c.crc) {
+            ++nbad;
+            if (verbose) {
+                amrex::AllPrint() << " bad: " << c.file << " bytes " << c.offset
+                                  << " to " << c.offset+c.nbytes << "\n";
+            }
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nbad);
+    return nbad;
+}
+
+// The data of every grid of the particle checkpoint whose header is hdrname.
+// Returns false if the header has no checksums.
+bool particle_chunks (std::string const& hdrname, Vector<Chunk>& chunks)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(hdrname, buf);
+    const std::string header(buf.dataPtr());
+    std::istringstream is(header);
+
+    std::string version, name;
+    int dm, nr, ni;
+    bool checkpoint;
+    Long nparticles, maxnextid;
+    int finest_level;
+    is >> version >> dm >> nr;
+    for (int i = 0; i < nr; ++i) { is >> name; }
+    is >> ni;
+    for (int i = 0; i < ni; ++i) { is >> name; }
+    is >> checkpoint >> nparticles >> maxnextid >> finest_level;
+
+    Vector<int> ngrids(finest_level+1);
+    for (auto& n : ngrids) { is >> n; }
+
+    Vector<Vector<int>>  which(finest_level+1);
+    Vector<Vector<Long>> where(finest_level+1);
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        which[lev].resize(ngrids[lev]);
+        where[lev].resize(ngrids[lev]);
+        for (int i = 0; i < ngrids[lev]; ++i) {
+            int count;
+            is >> which[lev][i] >> count >> where[lev][i];
+        }
+    }
+
+    std::string tag;
+    is >> tag;
+    if (!is || tag != "Checksums_CRC32") return false;
+
+    const std::string dir = VisMF::DirName(hdrname);
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        for (int i = 0; i < ngrids[lev]; ++i) {
+            Chunk c;
+            is >> c.crc >> c.nbytes;
+            if (c.nbytes == 0) continue;
+            c.file = amrex::Concatenate(dir + "Level_" + std::to_string(lev) + "/DATA_",
+                                        which[lev][i], 5);
+            c.offset = where[lev][i];
+            chunks.push_back(c);
+        }
+    }
+    if (!is) amrex::Abort("fverify: problem reading the checksums in " + hdrname);
+    return true;
+}
+
+}
+
+int main_main()
+{
+    const int narg = amrex::command_argument_count();
+    bool verbose = false;
+    int farg = 1;
+    if (narg > 0 && amrex::get_command_argument(farg) == "-v") {
+        verbose = true;
+        ++farg;
+    }
+
+    if (farg > narg) {
+        amrex::Print()
+            << "\n"
+            << " Usage:\n"
+            << "      fverify [-v] checkpoint\n"
+            << "\n"
+            << " Description:\n"
+            << "      This program checks the data of a checkpoint (or plotfile)\n"
+            << "      against the checksums written with vismf.checksums = 1, for\n"
+            << "      each MultiFab and particle container, and against the\n"
+            << "      Checksums file written with amr.checkpoint_stage_dir.\n"
+            << "      The data are read in parallel.  Returns 1 if any are bad.\n"
+            << "\n"
+            << " Options:\n"
+            << "      -v  list the bad data\n"
+            << std::endl;
+        return 0;
+    }
+
+    std::string dir = amrex::get_command_argument(farg);
+    if (!dir.empty() && dir.back() == '/') dir.pop_back();
+
+    auto files = FileSystem::ListFiles(dir);
+    std::sort(files.begin(), files.end());
+
+    VisMF::SetVerbose(verbose);
+    Long total_bad = 0;
+
+    for (auto const& file : files)
+    {
+        const std::string path = dir + "/" + file;
+        Long nbad = -1;
+        std::string what;
+
+        if (ends_with(file, "_H") && !ends_with(file, "Particle_H")) {
+            what = "MultiFab";
+            nbad = VisMF::VerifyChecksums(path.substr(0, path.size()-2));
+        } else if (ends_with(file, "Header") && file != "Header") {
+            std::string version;
+            {
+                std::ifstream ifs(path);
+                ifs >> version;
+            }
+            if (version.compare(0, 8, "Version_") != 0) continue;
+            what = "particles";
+            Vector<Chunk> chunks;
+            if (particle_chunks(path, chunks)) {
+                nbad = verify_chunks(chunks, verbose);
+            }
+        } else if (file == "Checksums") {
+            what = "files";
+            Vector<Chunk> chunks;
+            std::ifstream ifs(path);
+            std::string crc, name;
+            Long nbytes;
+            while (ifs >> crc >> nbytes >> name) {
+                chunks.push_back(Chunk{dir + "/" + name, 0, nbytes, std::stol(crc, nullptr, 16)});
+            }
+            nbad = verify_chunks(chunks, verbose);
+        } else {
+            continue;
+        }
+
+        amrex::Print() << " " << std::setw(10) << std::left << what << file << ": ";
+        if (nbad < 0) {
+            amrex::Print() << "no checksums\n";
+        } else if (nbad == 0) {
+            amrex::Print() << "ok\n";
+        } else {
+            amrex::Print() << nbad << " bad\n";
+            total_bad += nbad;
+        }
+    }
+
+    return total_bad > 0;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::SetVerbose(0);
+    amrex::Initialize(argc, argv, false);
+    const int has_bad = main_main();
+    amrex::Finalize();
+    return has_bad;
+}